@@ -7,6 +7,8 @@
 
 #include "gu_lock.hpp"
 #include "gu_throw.hpp"
+#include "gu_debug_sync.hpp"
+#include "gu_time.h"
 
 #include <map>
 #include <algorithm> // std::for_each
@@ -20,11 +22,13 @@ static const bool cert_debug_on(false);
 
 #define CERT_PARAM_LOG_CONFLICTS galera::Certification::PARAM_LOG_CONFLICTS
 #define CERT_PARAM_OPTIMISTIC_PA galera::Certification::PARAM_OPTIMISTIC_PA
+#define CERT_PARAM_PURGE_BATCH   galera::Certification::PARAM_PURGE_BATCH
 
 static std::string const CERT_PARAM_PREFIX("cert.");
 
 std::string const CERT_PARAM_LOG_CONFLICTS(CERT_PARAM_PREFIX + "log_conflicts");
 std::string const CERT_PARAM_OPTIMISTIC_PA(CERT_PARAM_PREFIX + "optimistic_pa");
+std::string const CERT_PARAM_PURGE_BATCH  (CERT_PARAM_PREFIX + "purge_batch");
 
 static std::string const CERT_PARAM_MAX_LENGTH   (CERT_PARAM_PREFIX +
                                                   "max_length");
@@ -33,6 +37,7 @@ static std::string const CERT_PARAM_LENGTH_CHECK (CERT_PARAM_PREFIX +
 
 static std::string const CERT_PARAM_LOG_CONFLICTS_DEFAULT("no");
 static std::string const CERT_PARAM_OPTIMISTIC_PA_DEFAULT("yes");
+static std::string const CERT_PARAM_PURGE_BATCH_DEFAULT  ("1024");
 
 /*** It is EXTREMELY important that these constants are the same on all nodes.
  *** Don't change them ever!!! ***/
@@ -44,6 +49,7 @@ galera::Certification::register_params(gu::Config& cnf)
 {
     cnf.add(CERT_PARAM_LOG_CONFLICTS, CERT_PARAM_LOG_CONFLICTS_DEFAULT);
     cnf.add(CERT_PARAM_OPTIMISTIC_PA, CERT_PARAM_OPTIMISTIC_PA_DEFAULT);
+    cnf.add(CERT_PARAM_PURGE_BATCH,   CERT_PARAM_PURGE_BATCH_DEFAULT);
     /* The defaults below are deliberately not reflected in conf: people
      * should not know about these dangerous setting unless they read RTFM. */
     cnf.add(CERT_PARAM_MAX_LENGTH);
@@ -538,6 +544,20 @@ check_against(const galera::KeyEntryNG*   const found,
                  REF_KEY_TYPE == WSREP_KEY_EXCLUSIVE)
         {
             depends_seqno = std::max(ref_trx->global_seqno(), depends_seqno);
+
+            /* Only remote exclusive references form a chain where leaving
+             * of ref_trx implies that all its predecessors have left too.
+             * There may be several shared references to the key and local
+             * trxs enter apply monitor unconditionally, so fall back to
+             * watermark for them. */
+            if (REF_KEY_TYPE == WSREP_KEY_EXCLUSIVE && !ref_trx->is_local())
+            {
+                trx->dependencies().add(ref_trx->global_seqno());
+            }
+            else
+            {
+                trx->dependencies().raise_floor(ref_trx->global_seqno());
+            }
         }
     }
 
@@ -650,6 +670,7 @@ galera::Certification::do_test_v3to4(TrxHandle* trx, bool store_keys)
     }
 
     trx->set_depends_seqno(std::max(trx->depends_seqno(), last_pa_unsafe_));
+    trx->dependencies().raise_floor(last_pa_unsafe_);
 
     if (store_keys == true)
     {
@@ -817,6 +838,7 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
         break;
     case 3:
     case 4:
+        if (record_deps_) trx->dependencies().reset(trx->depends_seqno());
         res = do_test_v3to4(trx, store_keys);
         break;
     default:
@@ -911,6 +933,8 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     deps_dist_             (0),
     cert_interval_         (0),
     index_size_            (0),
+    purge_pause_hs_        ("0.0,0.0001,0.00031623,0.001,0.0031623,0.01,"
+                            "0.031623,0.1,0.31623,1.,3.1623"),
     key_count_             (0),
     byte_count_            (0),
     trx_count_             (0),
@@ -918,7 +942,9 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     max_length_            (max_length(conf)),
     max_length_check_      (length_check(conf)),
     log_conflicts_         (conf.get<bool>(CERT_PARAM_LOG_CONFLICTS)),
-    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA))
+    optimistic_pa_         (conf.get<bool>(CERT_PARAM_OPTIMISTIC_PA)),
+    record_deps_           (false),
+    purge_batch_           (std::max(1, conf.get<int>(CERT_PARAM_PURGE_BATCH)))
 {}
 
 
@@ -936,6 +962,9 @@ galera::Certification::~Certification()
     log_debug << "avg cert interval "          << avg_cert_interval;
     log_debug << "cert index size "            << index_size;
 
+    // service thread may be purging the index, must not hold mutex_ here
+    service_thd_.flush();
+
     gu::Lock lock(mutex_);
 
     for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
@@ -1033,30 +1062,73 @@ wsrep_seqno_t galera::Certification::get_safe_to_discard_seqno_() const
 }
 
 
-wsrep_seqno_t
-galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno,
-                                        bool const          handle_gcache)
+bool
+galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno)
 {
     assert (seqno > 0);
 
-    TrxMap::iterator purge_bound(trx_map_.upper_bound(seqno));
+    TrxMap::iterator purge_bound(trx_map_.begin());
 
-    log_debug << "purging index up to " << seqno;
+    for (int n(0);
+         n < purge_batch_ && purge_bound != trx_map_.end() &&
+             purge_bound->first <= seqno;
+         ++n, ++purge_bound) {}
 
     for_each(trx_map_.begin(), purge_bound, PurgeAndDiscard(*this));
     trx_map_.erase(trx_map_.begin(), purge_bound);
 
-    if (handle_gcache)
+    return (purge_bound == trx_map_.end() || purge_bound->first > seqno);
+}
+
+
+wsrep_seqno_t
+galera::Certification::purge_trxs_upto(wsrep_seqno_t       seqno,
+                                       bool const          handle_gcache)
+{
+    log_debug << "purging index up to " << seqno;
+
+    bool done(false);
+
+    while (!done)
     {
-        log_debug << "releasing seqno from gcache " << seqno;
-        service_thd_.release_seqno(seqno);
+        double pause;
+        {
+            gu::Lock lock(mutex_);
+
+            long long const start(gu_time_monotonic());
+
+            // Note: setting trx committed is not done in total order so
+            // safe to discard seqno may decrease.
+            seqno = std::min(seqno, get_safe_to_discard_seqno_());
+
+            if (seqno <= 0) return seqno;
+
+            done = purge_trxs_upto_(seqno);
+
+            if (done && 0 == ((trx_map_.size() + 1) % 10000))
+            {
+                log_debug << "trx map after purge: length: "
+                          << trx_map_.size()
+                          << ", requested purge seqno: " << seqno
+                          << ", real purge seqno: "
+                          << trx_map_.begin()->first - 1;
+            }
+
+            pause = double(gu_time_monotonic() - start) * 1.0e-9;
+        }
+
+        {
+            gu::Lock lock(stats_mutex_);
+            purge_pause_hs_.insert(pause);
+        }
+
+        if (!done) GU_DBUG_SYNC_WAIT("cert_purge_after_batch");
     }
 
-    if (0 == ((trx_map_.size() + 1) % 10000))
+    if (handle_gcache)
     {
-        log_debug << "trx map after purge: length: " << trx_map_.size()
-                  << ", requested purge seqno: " << seqno
-                  << ", real purge seqno: " << trx_map_.begin()->first - 1;
+        log_debug << "releasing seqno from gcache " << seqno;
+        service_thd_.release_seqno(seqno);
     }
 
     return seqno;
@@ -1111,7 +1183,18 @@ galera::Certification::append_trx(TrxHandle* trx)
                 cert_debug << "purging index up to " << trim_seqno;
             }
 
-            purge_trxs_upto_(trim_seqno, true);
+            if (trx_map_.size() > static_cast<size_t>(max_length_) +
+                max_length_/2 && trim_seqno > 0)
+            {
+                /* service thread does not keep up, purge synchronously to
+                 * stop the index from growing any further */
+                while (!purge_trxs_upto_(trim_seqno)) {}
+                service_thd_.release_seqno(trim_seqno);
+            }
+            else
+            {
+                schedule_purge(trim_seqno);
+            }
         }
     }
 
@@ -1215,6 +1298,19 @@ galera::Certification::param_set(const std::string& key,
         set_boolean_parameter(optimistic_pa_, value, CERT_PARAM_OPTIMISTIC_PA,
                               "\"optimistic\" parallel applying.");
     }
+    else if (key == Certification::PARAM_PURGE_BATCH)
+    {
+        int const batch(gu::Config::from_config<int>(value));
+
+        if (batch < 1)
+        {
+            gu_throw_error(EINVAL) << "Bad value '" << value << "' for '"
+                                   << key << "': must be positive.";
+        }
+
+        gu::Lock lock(mutex_);
+        purge_batch_ = batch;
+    }
     else
     {
         throw gu::NotFound();
@@ -12,6 +12,7 @@
 #include "gu_unordered.hpp"
 #include "gu_lock.hpp"
 #include "gu_config.hpp"
+#include "gu_histogram.hpp"
 
 #include <map>
 #include <set>
@@ -19,12 +20,13 @@
 
 namespace galera
 {
-    class Certification
+    class Certification : private ServiceThd::Purger
     {
     public:
 
         static std::string const PARAM_LOG_CONFLICTS;
         static std::string const PARAM_OPTIMISTIC_PA;
+        static std::string const PARAM_PURGE_BATCH;
 
         static void register_params(gu::Config&);
 
@@ -64,16 +66,15 @@ namespace galera
             return get_safe_to_discard_seqno_();
         }
 
+        // Purges index in batches of at most cert.purge_batch trxs,
+        // releasing the certification lock between batches.
         wsrep_seqno_t
-        purge_trxs_upto(wsrep_seqno_t const seqno, bool const handle_gcache)
+        purge_trxs_upto(wsrep_seqno_t seqno, bool handle_gcache);
+
+        // Same as purge_trxs_upto(seqno, true) but done by service thread
+        void schedule_purge(wsrep_seqno_t const seqno)
         {
-            gu::Lock lock(mutex_);
-            const wsrep_seqno_t stds(get_safe_to_discard_seqno_());
-            // assert(seqno <= get_safe_to_discard_seqno());
-            // Note: setting trx committed is not done in total order so
-            // safe to discard seqno may decrease. Enable assertion above when
-            // this issue is fixed.
-            return purge_trxs_upto_(std::min(seqno, stds), handle_gcache);
+            service_thd_.purge(*this, seqno);
         }
 
         // Set trx corresponding to handle committed. Return purge seqno if
@@ -97,6 +98,13 @@ namespace galera
             index_size = index_size_;
         }
 
+        // distribution of the time certification lock was held by purge
+        std::string purge_pause_hs() const
+        {
+            gu::Lock lock(stats_mutex_);
+            return purge_pause_hs_.to_string();
+        }
+
         void stats_reset()
         {
             gu::Lock lock(stats_mutex_);
@@ -104,6 +112,7 @@ namespace galera
             deps_dist_ = 0;
             n_certified_ = 0;
             index_size_ = 0;
+            purge_pause_hs_.clear();
         }
 
         size_t bucket_count ()
@@ -114,6 +123,9 @@ namespace galera
 
         void param_set(const std::string& key, const std::string& value);
 
+        // Record explicit writeset dependencies for dependency apply order
+        void set_record_dependencies(bool val) { record_deps_ = val; }
+
     private:
 
         TestResult do_test(TrxHandle*, bool);
@@ -126,7 +138,14 @@ namespace galera
 
         // unprotected variants for internal use
         wsrep_seqno_t get_safe_to_discard_seqno_() const;
-        wsrep_seqno_t purge_trxs_upto_(wsrep_seqno_t, bool sync);
+        // purges at most purge_batch_ trxs, returns true if reached seqno
+        bool purge_trxs_upto_(wsrep_seqno_t);
+
+        // ServiceThd::Purger
+        void purge_upto(wsrep_seqno_t const seqno)
+        {
+            purge_trxs_upto(seqno, true);
+        }
 
         bool index_purge_required()
         {
@@ -215,6 +234,7 @@ namespace galera
         wsrep_seqno_t deps_dist_;
         wsrep_seqno_t cert_interval_;
         size_t        index_size_;
+        gu::Histogram purge_pause_hs_;
 
         size_t        key_count_;
         size_t        byte_count_;
@@ -231,6 +251,8 @@ namespace galera
 
         bool               log_conflicts_;
         bool               optimistic_pa_;
+        bool               record_deps_;
+        int                purge_batch_;
     };
 }
 
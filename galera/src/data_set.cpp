@@ -1,6 +1,213 @@
 //
-// Copyright (C) 2013 Codership Oy <info@codership.com>
+// Copyright (C) 2013-2018 Codership Oy <info@codership.com>
 //
 
 #include "data_set.hpp"
 
+#include <gu_serialize.hpp>
+#include <gu_throw.hpp>
+
+#include <zlib.h>
+
+#include <cstring>
+
+namespace galera
+{
+
+/*
+ * VER2 set is a RecordSet with a single record that holds serialized VER1
+ * set, either compressed or as is if compression does not pay off:
+ *
+ * 0:   packing method
+ * 1-3: reserved, zero
+ * 4-7: size of serialized VER1 set, little-endian
+ * 8-:  compressed or stored VER1 set
+ *
+ * Prefix size keeps stored set aligned.
+ */
+static size_t const PACK_PREFIX_SIZE = 8;
+
+enum
+{
+    PACK_STORED = 0,
+    PACK_ZLIB   = 1
+};
+
+/* sets smaller than that are not worth compressing */
+static size_t const PACK_MIN_SIZE = 256;
+
+ssize_t
+DataSetOut::gather (GatherVector& out)
+{
+    if (DataSet::VER2 != version_ || 0 == count())
+    {
+        return gu::RecordSetOut<DataSet::RecordOut>::gather(out);
+    }
+
+    assert(NULL == packed_);
+
+    GatherVector raw;
+    size_t const raw_size(gu::RecordSetOut<DataSet::RecordOut>::gather(raw));
+
+    if (raw_size < PACK_MIN_SIZE || !pack(raw, raw_size, PACK_ZLIB))
+    {
+        pack(raw, raw_size, PACK_STORED);
+    }
+
+    return packed_->gather(out);
+}
+
+bool
+DataSetOut::pack (const GatherVector& raw,
+                  size_t const        raw_size,
+                  int const           method)
+{
+    delete packed_;
+    packed_ = new gu::RecordSetOut<DataSet::RecordOut>(
+        NULL, 0, packed_name_, gu::RecordSet::CHECK_MMH128,
+        gu::RecordSet::version());
+
+    gu::byte_t prefix[PACK_PREFIX_SIZE] = { gu::byte_t(method), 0, 0, 0, };
+    gu::serialize4(uint32_t(raw_size), prefix, 4);
+    packed_->append(prefix, sizeof(prefix), true, false);
+
+    if (PACK_STORED == method)
+    {
+        for (size_t i(0); i < raw->size(); ++i)
+        {
+            if (raw[i].size > 0)
+                packed_->append(raw[i].ptr, raw[i].size, false, false);
+        }
+
+        return true;
+    }
+
+    assert(PACK_ZLIB == method);
+
+    z_stream zs;
+    ::memset(&zs, 0, sizeof(zs));
+
+    if (Z_OK != deflateInit(&zs, Z_BEST_SPEED))
+    {
+        gu_throw_error(ENOMEM) << "Failed to initialize DataSet compression";
+    }
+
+    gu::byte_t chunk[1 << 14];
+    size_t     left(raw_size); // no point to go beyond that
+    bool       ret(true);
+
+    for (size_t i(0); ret && i <= raw->size(); ++i)
+    {
+        bool const last(raw->size() == i);
+
+        zs.next_in  = last ? Z_NULL :
+            static_cast<Bytef*>(const_cast<void*>(raw[i].ptr));
+        zs.avail_in = last ? 0 : raw[i].size;
+
+        int const flush(last ? Z_FINISH : Z_NO_FLUSH);
+
+        do
+        {
+            zs.next_out  = chunk;
+            zs.avail_out = sizeof(chunk);
+
+#ifdef NDEBUG
+            deflate(&zs, flush);
+#else
+            int const err(deflate(&zs, flush));
+            assert(Z_STREAM_ERROR != err);
+#endif
+
+            size_t const n(sizeof(chunk) - zs.avail_out);
+
+            if (n >= left)
+            {
+                ret = false;
+                break;
+            }
+
+            left -= n;
+            if (n > 0) packed_->append(chunk, n, true, false);
+        }
+        while (0 == zs.avail_out);
+    }
+
+    deflateEnd(&zs);
+
+    return ret;
+}
+
+void
+DataSetIn::unpack () const
+{
+    assert(DataSet::VER2 == version_);
+
+    gu::RecordSetIn<DataSet::RecordIn>::rewind();
+    gu::Buf const packed(gu::RecordSetIn<DataSet::RecordIn>::next().buf());
+
+    if (gu_unlikely(size_t(packed.size) < PACK_PREFIX_SIZE))
+    {
+        gu_throw_error(EPROTO) << "Corrupted DataSet: packed size "
+                               << packed.size << " too short";
+    }
+
+    const gu::byte_t* const ptr(static_cast<const gu::byte_t*>(packed.ptr));
+    const gu::byte_t* const payload(ptr + PACK_PREFIX_SIZE);
+    size_t const            payload_size(packed.size - PACK_PREFIX_SIZE);
+
+    uint32_t raw_size;
+    gu::unserialize4(ptr, packed.size, 4, raw_size);
+
+    switch (ptr[0])
+    {
+    case PACK_STORED:
+        if (gu_unlikely(payload_size != raw_size))
+        {
+            gu_throw_error(EPROTO) << "Corrupted DataSet: stored size "
+                                   << payload_size << ", expected "
+                                   << raw_size;
+        }
+
+        raw_.init(payload, raw_size, false);
+        return;
+
+    case PACK_ZLIB:
+    {
+        unpacked_.resize(raw_size);
+
+        z_stream zs;
+        ::memset(&zs, 0, sizeof(zs));
+
+        zs.next_in   = const_cast<Bytef*>(payload);
+        zs.avail_in  = payload_size;
+        zs.next_out  = &unpacked_[0];
+        zs.avail_out = raw_size;
+
+        if (Z_OK != inflateInit(&zs))
+        {
+            gu_throw_error(ENOMEM)
+                << "Failed to initialize DataSet decompression";
+        }
+
+        int const err(inflate(&zs, Z_FINISH));
+        size_t const out_size(zs.total_out);
+
+        inflateEnd(&zs);
+
+        if (gu_unlikely(Z_STREAM_END != err || out_size != raw_size))
+        {
+            gu_throw_error(EPROTO) << "Failed to decompress DataSet: "
+                                   << err << ", " << out_size << " of "
+                                   << raw_size << " bytes";
+        }
+
+        raw_.init(&unpacked_[0], raw_size, false);
+        return;
+    }
+    }
+
+    gu_throw_error(EPROTO) << "Unsupported DataSet packing method: "
+                           << int(ptr[0]);
+}
+
+} /* namespace galera */
@@ -9,6 +9,8 @@
 #include "gu_rset.hpp"
 #include "gu_vlq.hpp"
 
+#include <vector>
+
 
 namespace galera
 {
@@ -19,10 +21,11 @@ namespace galera
         enum Version
         {
             EMPTY = 0,
-            VER1
+            VER1,
+            VER2  /* VER1 set packed (compressed) as a whole */
         };
 
-        static Version const MAX_VERSION = VER1;
+        static Version const MAX_VERSION = VER2;
 
         static Version version (unsigned int ver)
         {
@@ -79,7 +82,8 @@ namespace galera
 
         DataSetOut () // empty ctor for slave TrxHandle
             :
-            gu::RecordSetOut<DataSet::RecordOut>(), version_()
+            gu::RecordSetOut<DataSet::RecordOut>(), version_(),
+            packed_name_(NULL), packed_(NULL)
         {}
 
         DataSetOut (gu::byte_t*             reserved,
@@ -95,11 +99,15 @@ namespace galera
                 check_type(version),
                 rsv
                 ),
-            version_(version)
+            version_(version),
+            packed_name_(&base_name),
+            packed_(NULL)
         {
             assert((uintptr_t(reserved) % GU_WORD_BYTES) == 0);
         }
 
+        ~DataSetOut () { delete packed_; }
+
         size_t
         append (const void* const src, size_t const size, bool const store)
         {
@@ -114,12 +122,40 @@ namespace galera
         DataSet::Version
         version () const { return count() ? version_ : DataSet::EMPTY; }
 
+        /*! version the set was created with, regardless of its contents */
+        DataSet::Version
+        format () const { return version_; }
+
         typedef gu::RecordSet::GatherVector GatherVector;
 
+        /*! VER2 set is packed here, so this can be called only once */
+        ssize_t gather (GatherVector& out);
+
     private:
 
+        /* on-disk pages of the packed set must not clash with the original */
+        class PackedName : public BaseName
+        {
+            const BaseName* const base_;
+
+        public:
+
+            explicit PackedName (const BaseName* base) : base_(base) {}
+
+            void print(std::ostream& os) const
+            {
+                if (base_) base_->print(os);
+                os << "_z";
+            }
+        };
+
         // depending on version we may pack data differently
         DataSet::Version const version_;
+        PackedName const       packed_name_;
+        gu::RecordSetOut<DataSet::RecordOut>* packed_;
+
+        /* @return false if packed set would not be smaller than original */
+        bool pack (const GatherVector& raw, size_t raw_size, int method);
 
         static gu::RecordSet::CheckType
         check_type (DataSet::Version ver)
@@ -128,6 +164,8 @@ namespace galera
             {
             case DataSet::EMPTY: break; /* Can't create EMPTY DataSetOut */
             case DataSet::VER1:  return gu::RecordSet::CHECK_MMH128;
+            /* packed set is checksummed instead */
+            case DataSet::VER2:  return gu::RecordSet::CHECK_NONE;
             }
             throw;
         }
@@ -142,11 +180,15 @@ namespace galera
         DataSetIn (DataSet::Version ver, const gu::byte_t* buf, size_t size)
             :
             gu::RecordSetIn<DataSet::RecordIn>(buf, size, false),
-            version_(ver)
+            version_(ver),
+            raw_    (),
+            unpacked_()
         {}
 
         DataSetIn () : gu::RecordSetIn<DataSet::RecordIn>(),
-                       version_(DataSet::EMPTY)
+                       version_(DataSet::EMPTY),
+                       raw_    (),
+                       unpacked_()
         {}
 
         void init (DataSet::Version ver, const gu::byte_t* buf, size_t size)
@@ -155,15 +197,46 @@ namespace galera
             version_ = ver;
         }
 
+        void rewind () const
+        {
+            gu::RecordSetIn<DataSet::RecordIn>::rewind();
+            raw_.rewind();
+        }
+
+        /* Size, checksum and buffer of VER2 set refer to its packed form,
+         * records are unpacked only when they are first accessed. */
         gu::Buf next () const
         {
-            return gu::RecordSetIn<DataSet::RecordIn>::next().buf();
+            if (gu_likely(DataSet::VER2 != version_))
+            {
+                return gu::RecordSetIn<DataSet::RecordIn>::next().buf();
+            }
+
+            if (gu::RecordSet::EMPTY == raw_.version()) unpack();
+
+            return raw_.next().buf();
+        }
+
+        /* Unpacks VER2 set ahead of the first access, no-op otherwise.
+         * Not thread-safe, like next(). */
+        void preload () const
+        {
+            if (DataSet::VER2 == version_ &&
+                gu::RecordSet::EMPTY == raw_.version() && count() > 0)
+            {
+                unpack();
+            }
         }
 
     private:
 
         DataSet::Version version_;
 
+        gu::RecordSetIn<DataSet::RecordIn> mutable raw_;
+        std::vector<gu::byte_t>            mutable unpacked_;
+
+        void unpack () const;
+
     }; /* class DataSetIn */
 
 #if defined(__GNUG__)
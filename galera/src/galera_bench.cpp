@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * Single process replication throughput benchmark. Drives the provider
+ * through the wsrep API over the dummy GCS backend (loopback, no network),
+ * so replicate -> certify -> commit path can be measured without DBMS.
+ *
+ * Local write sets are replicated and committed by client threads.
+ * A fraction of write sets may be sent as preordered instead: those are
+ * delivered back as foreign and applied by applier threads.
+ *
+ * Usage: galera_bench [options]
+ *   -c <n>     client threads                      (4)
+ *   -a <n>     applier threads                     (4)
+ *   -n <n>     transactions per client             (10000)
+ *   -k <n>     keys per write set                  (4)
+ *   -K <n>     key size, bytes                     (16)
+ *   -d <n>     data size, bytes                    (256)
+ *   -x <f>     fraction of write sets touching a hot key (0.0)
+ *   -H <n>     number of hot keys                  (16)
+ *   -p <f>     fraction of write sets sent preordered (0.0)
+ *   -o <str>   extra provider options
+ */
+
+#include "wsrep_api.h"
+
+#include <gu_atomic.hpp>
+#include <gu_threads.h>
+#include <gu_time.h>
+#include <gu_logger.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <string>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+extern "C" int wsrep_loader(wsrep_t* hptr);
+
+namespace
+{
+    struct Options
+    {
+        int         clients;
+        int         appliers;
+        long        trxs;
+        int         keys;
+        int         key_size;
+        int         data_size;
+        double      conflict;
+        int         hot_keys;
+        double      preordered;
+        std::string provider_options;
+
+        Options()
+            :
+            clients   (4),
+            appliers  (4),
+            trxs      (10000),
+            keys      (4),
+            key_size  (16),
+            data_size (256),
+            conflict  (0.0),
+            hot_keys  (16),
+            preordered(0.0),
+            provider_options()
+        {}
+    };
+
+    enum Stage
+    {
+        STAGE_REPLICATE, // wsrep->replicate(): ordering
+        STAGE_CERTIFY,   // wsrep->pre_commit(): certification, monitors
+        STAGE_COMMIT,    // wsrep->post_commit()
+        STAGE_TOTAL,
+        STAGE_PREORDERED,// preordered_collect() + preordered_commit()
+        STAGE_MAX
+    };
+
+    const char* const stage_name[STAGE_MAX] =
+    {
+        "replicate", "certify", "commit", "total", "preordered"
+    };
+
+    wsrep_t         provider;
+    gu::Atomic<int> synced(0);
+    gu::Atomic<long long> applied(0);
+
+    struct Client
+    {
+        gu_thread_t             thd;
+        int const               id;
+        const Options&          opt;
+        unsigned int            seed;
+        std::vector<long long>  lat[STAGE_MAX];
+        long                    committed;
+        long                    cert_failed;
+        long                    errors;
+
+        Client(int const i, const Options& o)
+            :
+            thd(), id(i), opt(o), seed(i), committed(0), cert_failed(0),
+            errors(0)
+        {}
+
+    private:
+        Client(const Client&);
+        Client& operator=(const Client&);
+    };
+
+    struct Applier
+    {
+        gu_thread_t thd;
+        int         id;
+    };
+
+    /* callbacks */
+
+    void
+    logger_cb(wsrep_log_level_t level, const char* msg)
+    {
+        if (level <= WSREP_LOG_WARN) fprintf(stderr, "%s\n", msg);
+    }
+
+    wsrep_cb_status_t
+    view_cb(void* app_ctx, void* recv_ctx, const wsrep_view_info_t* view,
+            const char* state, size_t state_len,
+            void** sst_req, size_t* sst_req_len)
+    {
+        *sst_req     = NULL;
+        *sst_req_len = 0;
+        return WSREP_CB_SUCCESS;
+    }
+
+    wsrep_cb_status_t
+    apply_cb(void* recv_ctx, const void* data, size_t size, uint32_t flags,
+             const wsrep_trx_meta_t* meta)
+    {
+        return WSREP_CB_SUCCESS;
+    }
+
+    wsrep_cb_status_t
+    commit_cb(void* recv_ctx, const void* trx_handle, uint32_t flags,
+              const wsrep_trx_meta_t* meta, wsrep_bool_t* exit,
+              wsrep_bool_t commit)
+    {
+        if (commit && trx_handle)
+        {
+            void* const th(const_cast<void*>(trx_handle));
+            provider.applier_pre_commit(&provider, th);
+            provider.applier_post_commit(&provider, th);
+        }
+
+        if (commit) applied.add_and_fetch(1);
+
+        return WSREP_CB_SUCCESS;
+    }
+
+    wsrep_cb_status_t
+    unordered_cb(void* recv_ctx, const void* data, size_t size)
+    {
+        return WSREP_CB_SUCCESS;
+    }
+
+    wsrep_cb_status_t
+    sst_donate_cb(void* app_ctx, void* recv_ctx, const void* msg,
+                  size_t msg_len, const wsrep_gtid_t* state_id,
+                  const char* state, size_t state_len, wsrep_bool_t bypass)
+    {
+        return WSREP_CB_FAILURE; // single node, should never be called
+    }
+
+    void
+    synced_cb(void* app_ctx)
+    {
+        synced.add_and_fetch(1);
+    }
+
+    /* threads */
+
+    void*
+    applier_thd(void* arg)
+    {
+        Applier* const a(static_cast<Applier*>(arg));
+        wsrep_status_t const ret(provider.recv(&provider, a));
+
+        if (WSREP_OK != ret && WSREP_CONN_FAIL != ret)
+        {
+            log_error << "Applier " << a->id << " exited with " << ret;
+        }
+
+        return NULL;
+    }
+
+    void
+    make_key(Client& c, long const trx, int const k, std::vector<char>& key)
+    {
+        bool const hot(k == 0 && c.opt.conflict > 0 &&
+                       rand_r(&c.seed) < c.opt.conflict * RAND_MAX);
+
+        std::fill(key.begin(), key.end(), 0);
+
+        if (hot)
+        {
+            int const n(rand_r(&c.seed) % c.opt.hot_keys);
+            snprintf(&key[0], key.size(), "hot%d", n);
+        }
+        else
+        {
+            snprintf(&key[0], key.size(), "%d:%ld:%d", c.id, trx, k);
+        }
+    }
+
+    /* @return true if committed */
+    bool
+    run_local(Client& c, long const trx, std::vector<std::vector<char> >& keys,
+              std::vector<char>& data)
+    {
+        wsrep_ws_handle_t ws = { wsrep_trx_id_t(c.id) << 40 | trx, 0 };
+        wsrep_conn_id_t const conn(c.id);
+
+        for (int k(0); k < c.opt.keys; ++k)
+        {
+            make_key(c, trx, k, keys[k]);
+
+            wsrep_buf_t const part = { &keys[k][0], keys[k].size() };
+            wsrep_key_t const key  = { &part, 1 };
+
+            if (WSREP_OK != provider.append_key(&provider, &ws, &key, 1,
+                                                WSREP_KEY_EXCLUSIVE, true))
+            {
+                c.errors++;
+                return false;
+            }
+        }
+
+        wsrep_buf_t const buf = { &data[0], data.size() };
+        provider.append_data(&provider, &ws, &buf, 1, WSREP_DATA_ORDERED,
+                             false);
+
+        wsrep_trx_meta_t meta;
+        long long const start(gu_time_monotonic());
+
+        wsrep_status_t ret(provider.replicate(&provider, conn, &ws,
+                                              WSREP_FLAG_COMMIT, &meta));
+        long long const replicated(gu_time_monotonic());
+
+        if (WSREP_OK == ret)
+        {
+            ret = provider.pre_commit(&provider, conn, &ws, WSREP_FLAG_COMMIT,
+                                      &meta);
+        }
+        long long const certified(gu_time_monotonic());
+
+        if (WSREP_OK == ret)
+        {
+            provider.post_commit(&provider, &ws);
+            long long const committed(gu_time_monotonic());
+
+            c.lat[STAGE_REPLICATE].push_back(replicated - start);
+            c.lat[STAGE_CERTIFY  ].push_back(certified  - replicated);
+            c.lat[STAGE_COMMIT   ].push_back(committed  - certified);
+            c.lat[STAGE_TOTAL    ].push_back(committed  - start);
+            c.committed++;
+
+            return true;
+        }
+
+        if (WSREP_TRX_FAIL == ret) c.cert_failed++; else c.errors++;
+
+        provider.post_rollback(&provider, &ws);
+
+        return false;
+    }
+
+    void
+    run_preordered(Client& c, std::vector<char>& data)
+    {
+        static wsrep_uuid_t const source =
+            {{ 0xbe, 0x4c, 0x4b, 0xe4, 0xbe, 0x4c, 0x4b, 0xe4,
+               0xbe, 0x4c, 0x4b, 0xe4, 0xbe, 0x4c, 0x4b, 0xe4 }};
+
+        wsrep_po_handle_t po = { 0 };
+        wsrep_buf_t const buf = { &data[0], data.size() };
+
+        long long const start(gu_time_monotonic());
+
+        if (WSREP_OK != provider.preordered_collect(&provider, &po, &buf, 1,
+                                                    true) ||
+            WSREP_OK != provider.preordered_commit(&provider, &po, &source,
+                                                   WSREP_FLAG_COMMIT,
+                                                   c.opt.appliers, true))
+        {
+            c.errors++;
+            return;
+        }
+
+        c.lat[STAGE_PREORDERED].push_back(gu_time_monotonic() - start);
+    }
+
+    void*
+    client_thd(void* arg)
+    {
+        Client& c(*static_cast<Client*>(arg));
+
+        std::vector<std::vector<char> > keys(c.opt.keys,
+                                             std::vector<char>(c.opt.key_size));
+        std::vector<char> data(std::max(c.opt.data_size, 1), 'x');
+
+        for (long trx(0); trx < c.opt.trxs; ++trx)
+        {
+            if (c.opt.preordered > 0 &&
+                rand_r(&c.seed) < c.opt.preordered * RAND_MAX)
+            {
+                run_preordered(c, data);
+            }
+            else
+            {
+                run_local(c, trx, keys, data);
+            }
+        }
+
+        return NULL;
+    }
+
+    long long
+    percentile(const std::vector<long long>& v, double const p)
+    {
+        if (v.empty()) return 0;
+        size_t const i(std::min(v.size() - 1, size_t(p * v.size())));
+        return v[i];
+    }
+
+    void
+    usage(const char* const name)
+    {
+        fprintf(stderr, "Usage: %s [-c clients] [-a appliers] [-n trxs] "
+                "[-k keys] [-K key size] [-d data size] [-x conflict rate] "
+                "[-H hot keys] [-p preordered rate] [-o provider options]\n",
+                name);
+    }
+}
+
+int
+main (int argc, char* argv[])
+{
+    Options opt;
+    int c;
+
+    while ((c = getopt(argc, argv, "c:a:n:k:K:d:x:H:p:o:h")) != -1)
+    {
+        switch (c)
+        {
+        case 'c': opt.clients    = atoi(optarg); break;
+        case 'a': opt.appliers   = atoi(optarg); break;
+        case 'n': opt.trxs       = atol(optarg); break;
+        case 'k': opt.keys       = atoi(optarg); break;
+        case 'K': opt.key_size   = atoi(optarg); break;
+        case 'd': opt.data_size  = atoi(optarg); break;
+        case 'x': opt.conflict   = atof(optarg); break;
+        case 'H': opt.hot_keys   = atoi(optarg); break;
+        case 'p': opt.preordered = atof(optarg); break;
+        case 'o': opt.provider_options = optarg; break;
+        default:  usage(argv[0]); return 1;
+        }
+    }
+
+    if (opt.clients < 1 || opt.appliers < 1 || opt.keys < 1 ||
+        opt.key_size < 1 || opt.data_size < 0 || opt.hot_keys < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string const options("gcache.name = galera_bench.cache; "
+                              "gcache.size = 256M; " + opt.provider_options);
+
+    if (wsrep_loader(&provider))
+    {
+        fprintf(stderr, "Failed to load provider\n");
+        return 1;
+    }
+
+    struct wsrep_init_args args;
+    memset(&args, 0, sizeof(args));
+    args.node_name       = "bench";
+    args.node_address    = "";
+    args.node_incoming   = "";
+    args.data_dir        = ".";
+    args.options         = options.c_str();
+    args.proto_ver       = 1;
+    args.logger_cb       = logger_cb;
+    args.view_handler_cb = view_cb;
+    args.apply_cb        = apply_cb;
+    args.commit_cb       = commit_cb;
+    args.unordered_cb    = unordered_cb;
+    args.sst_donate_cb   = sst_donate_cb;
+    args.synced_cb       = synced_cb;
+
+    if (WSREP_OK != provider.init(&provider, &args) ||
+        WSREP_OK != provider.connect(&provider, "bench", "dummy://", "",
+                                     true))
+    {
+        fprintf(stderr, "Failed to initialize provider\n");
+        return 1;
+    }
+
+    std::vector<Applier> appliers(opt.appliers);
+    for (int i(0); i < opt.appliers; ++i)
+    {
+        appliers[i].id = i;
+        gu_thread_create(&appliers[i].thd, NULL, applier_thd, &appliers[i]);
+    }
+
+    while (0 == synced()) usleep(1000);
+
+    std::vector<Client*> clients(opt.clients);
+    long long const start(gu_time_monotonic());
+
+    for (int i(0); i < opt.clients; ++i)
+    {
+        clients[i] = new Client(i + 1, opt);
+        gu_thread_create(&clients[i]->thd, NULL, client_thd, clients[i]);
+    }
+
+    std::vector<long long> lat[STAGE_MAX];
+    long committed(0), cert_failed(0), errors(0);
+
+    for (int i(0); i < opt.clients; ++i)
+    {
+        gu_thread_join(clients[i]->thd, NULL);
+
+        for (int s(0); s < STAGE_MAX; ++s)
+        {
+            lat[s].insert(lat[s].end(), clients[i]->lat[s].begin(),
+                          clients[i]->lat[s].end());
+        }
+        committed   += clients[i]->committed;
+        cert_failed += clients[i]->cert_failed;
+        errors      += clients[i]->errors;
+
+        delete clients[i];
+    }
+
+    /* wait for appliers to catch up with preordered write sets */
+    long long const preordered(lat[STAGE_PREORDERED].size());
+    while (applied() < preordered) usleep(1000);
+
+    double const elapsed(1.0e-9 * (gu_time_monotonic() - start));
+
+    provider.disconnect(&provider);
+
+    for (int i(0); i < opt.appliers; ++i)
+    {
+        gu_thread_join(appliers[i].thd, NULL);
+    }
+
+    long const attempted(committed + cert_failed);
+
+    printf("clients: %d, appliers: %d, trxs: %ld, keys: %d x %d, data: %d, "
+           "conflict: %.3f, preordered: %.3f\n",
+           opt.clients, opt.appliers, opt.trxs, opt.keys, opt.key_size,
+           opt.data_size, opt.conflict, opt.preordered);
+    printf("elapsed: %.3f s, local TPS: %.1f, applied TPS: %.1f, "
+           "cert failures: %ld (%.4f), errors: %ld\n",
+           elapsed, committed / elapsed, applied() / elapsed, cert_failed,
+           attempted > 0 ? double(cert_failed) / attempted : 0.0, errors);
+    printf("%-12s %10s %10s %10s %10s (usec)\n",
+           "stage", "count", "p50", "p99", "p999");
+
+    for (int s(0); s < STAGE_MAX; ++s)
+    {
+        std::sort(lat[s].begin(), lat[s].end());
+        printf("%-12s %10zu %10.1f %10.1f %10.1f\n", stage_name[s],
+               lat[s].size(),
+               1.0e-3 * percentile(lat[s], 0.5),
+               1.0e-3 * percentile(lat[s], 0.99),
+               1.0e-3 * percentile(lat[s], 0.999));
+    }
+
+    provider.free(&provider);
+    ::unlink("galera_bench.cache");
+
+    return (errors > 0);
+}
@@ -41,7 +41,8 @@ namespace galera
                               gcs_act_type_t, bool) = 0;
         virtual ssize_t send (const void*, size_t, gcs_act_type_t, bool) = 0;
         virtual ssize_t replv(const WriteSetVector&,
-                              gcs_action& act, bool) = 0;
+                              gcs_action& act, bool,
+                              bool priority = false) = 0;
         virtual ssize_t repl (gcs_action& act, bool) = 0;
         virtual void    caused(gcs_seqno_t& seqno,
                                gu::datetime::Date& wait_until) = 0;
@@ -132,9 +133,10 @@ namespace galera
         }
 
         ssize_t replv(const WriteSetVector& actv,
-                      struct gcs_action& act, bool scheduled)
+                      struct gcs_action& act, bool scheduled,
+                      bool priority = false)
         {
-            return gcs_replv(conn_, &actv[0], &act, scheduled);
+            return gcs_replv(conn_, &actv[0], &act, scheduled, priority);
         }
 
         ssize_t repl(struct gcs_action& act, bool scheduled)
@@ -301,7 +303,8 @@ namespace galera
         { return -ENOSYS; }
 
         ssize_t replv(const WriteSetVector& actv,
-                      gcs_action& act, bool scheduled)
+                      gcs_action& act, bool scheduled,
+                      bool priority = false)
         {
             ssize_t ret(set_seqnos(act));
 
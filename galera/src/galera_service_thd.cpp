@@ -7,10 +7,13 @@
 
 #include "galera_service_thd.hpp"
 
+#include <algorithm> // std::max
+
 const uint32_t galera::ServiceThd::A_NONE = 0;
 
 static const uint32_t A_LAST_COMMITTED = 1U <<  0;
 static const uint32_t A_RELEASE_SEQNO  = 1U <<  1;
+static const uint32_t A_PURGE          = 1U <<  2;
 static const uint32_t A_FLUSH          = 1U << 30;
 static const uint32_t A_EXIT           = 1U << 31;
 
@@ -38,6 +41,7 @@ galera::ServiceThd::thd_func (void* arg)
 
             data = st->data_;
             st->data_.act_ = A_NONE; // clear pending actions
+            st->data_.purge_seqno_ = 0; // purge is delivered only once
 
             if (data.act_ & A_FLUSH)
             {
@@ -76,6 +80,19 @@ galera::ServiceThd::thd_func (void* arg)
                 }
             }
 
+            if (data.act_ & A_PURGE)
+            {
+                try
+                {
+                    data.purger_->purge_upto(data.purge_seqno_);
+                }
+                catch (std::exception& e)
+                {
+                    log_warn << "Exception purging up to seqno "
+                             << data.purge_seqno_ << ": " << e.what();
+                }
+            }
+
             if (data.act_ & A_RELEASE_SEQNO)
             {
                 try
@@ -150,6 +167,7 @@ galera::ServiceThd::reset()
     gu::Lock lock(mtx_);
     data_.act_ = A_NONE;
     data_.last_committed_ = 0;
+    data_.purge_seqno_ = 0;
 }
 
 void
@@ -181,3 +199,19 @@ galera::ServiceThd::release_seqno(gcs_seqno_t seqno)
         data_.act_ |= A_RELEASE_SEQNO;
     }
 }
+
+void
+galera::ServiceThd::purge(Purger& purger, gcs_seqno_t seqno)
+{
+    gu::Lock lock(mtx_);
+
+    if (data_.purge_seqno_ < seqno)
+    {
+        data_.purge_seqno_ = seqno;
+        data_.purger_      = &purger;
+
+        if (data_.act_ == A_NONE) cond_.signal();
+
+        data_.act_ |= A_PURGE;
+    }
+}
@@ -38,6 +38,19 @@ namespace galera
         /*! release write sets up to and including seqno */
         void release_seqno (gcs_seqno_t seqno);
 
+        /*! work that is deferred to the service thread, see purge() */
+        class Purger
+        {
+        public:
+            virtual void purge_upto(gcs_seqno_t seqno) = 0;
+        protected:
+            virtual ~Purger() {}
+        };
+
+        /*! schedule purger.purge_upto(seqno) to be called from service
+         *  thread. Only the highest seqno of the pending calls is kept. */
+        void purge (Purger& purger, gcs_seqno_t seqno);
+
     private:
 
         static const uint32_t A_NONE;
@@ -46,11 +59,15 @@ namespace galera
         {
             gcs_seqno_t last_committed_;
             gcs_seqno_t release_seqno_;
+            gcs_seqno_t purge_seqno_;
+            Purger*     purger_;
             uint32_t    act_;
 
             Data() :
                 last_committed_(0),
                 release_seqno_ (0),
+                purge_seqno_   (0),
+                purger_        (0),
                 act_           (A_NONE)
             {}
         };
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * Decoder for writeset lifecycle trace dumps (see trx_trace.hpp and
+ * debug.trace_dump parameter). Prints records of all threads merged in
+ * time order.
+ *
+ * Usage: galera_trace_decode [-s seqno] [-t trx id] <dump file>
+ */
+
+#include "trx_trace.hpp"
+#include "trx_handle.hpp"
+
+#include <gu_utils.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace galera;
+
+namespace
+{
+    bool ts_less(const trx_trace::Record& a, const trx_trace::Record& b)
+    {
+        return a.ts < b.ts;
+    }
+
+    void print(std::ostream& os, const trx_trace::Record& r, int64_t const t0)
+    {
+        char ts[32];
+        snprintf(ts, sizeof(ts), "%14.3f", (r.ts - t0) * 1.0e-3);
+
+        os << ts << " " << r.tid << " "
+           << trx_trace::event_str(r.event)
+           << " seqno: " << r.seqno;
+
+        if (r.trx_id != 0) os << " trx: " << r.trx_id;
+
+        switch (r.event)
+        {
+        case trx_trace::EV_STATE:
+            os << " " << TrxHandle::State(r.arg);
+            break;
+        case trx_trace::EV_MON_WAIT:
+        case trx_trace::EV_MON_ENTER:
+        case trx_trace::EV_MON_LEAVE:
+        case trx_trace::EV_MON_CANCEL:
+            os << " " << trx_trace::monitor_str(r.arg);
+            break;
+        case trx_trace::EV_GCS_SEND:
+            if (r.arg) os << " priority";
+            break;
+        }
+
+        os << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int64_t  seqno(WSREP_SEQNO_UNDEFINED);
+    uint64_t trx_id(0);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's': seqno  = gu::from_string<int64_t>(optarg);  break;
+        case 't': trx_id = gu::from_string<uint64_t>(optarg); break;
+        default: optind = argc + 1;
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "Usage: %s [-s seqno] [-t trx id] <dump file>\n"
+                "Time is microseconds since the first record, followed by "
+                "thread id.\n", argv[0]);
+        return 1;
+    }
+
+    FILE* const file(fopen(argv[optind], "r"));
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open '%s': %s\n", argv[optind],
+                strerror(errno));
+        return 1;
+    }
+
+    trx_trace::Header hdr;
+    if (fread(&hdr, sizeof(hdr), 1, file) != 1 ||
+        memcmp(hdr.magic, trx_trace::MAGIC, sizeof(hdr.magic)))
+    {
+        fprintf(stderr, "'%s' is not a trace dump\n", argv[optind]);
+        fclose(file);
+        return 1;
+    }
+
+    if (hdr.byte_order  != trx_trace::BYTE_ORDER_MARK ||
+        hdr.record_size != sizeof(trx_trace::Record))
+    {
+        fprintf(stderr, "Trace dump was written on an incompatible "
+                "platform\n");
+        fclose(file);
+        return 1;
+    }
+
+    std::vector<trx_trace::Record> recs;
+    trx_trace::Record r;
+
+    while (fread(&r, sizeof(r), 1, file) == 1)
+    {
+        if (r.event == trx_trace::EV_NONE) continue;
+        if (seqno  != WSREP_SEQNO_UNDEFINED && r.seqno  != seqno)  continue;
+        if (trx_id != 0                     && r.trx_id != trx_id) continue;
+        recs.push_back(r);
+    }
+
+    fclose(file);
+
+    std::stable_sort(recs.begin(), recs.end(), ts_less);
+
+    int64_t const t0(recs.empty() ? 0 : recs.front().ts);
+
+    for (size_t i(0); i < recs.size(); ++i) print(std::cout, recs[i], t0);
+
+    return 0;
+}
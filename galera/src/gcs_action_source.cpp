@@ -111,6 +111,8 @@ void galera::GcsActionSource::dispatch(void* const              recv_ctx,
     {
         assert(act.seqno_g > 0);
         GcsActionTrx trx(trx_pool_, act);
+        trx_trace::record(trx_trace::EV_GCS_RECV, act.seqno_g,
+                          trx.trx()->trx_id(), 0);
         trx.trx()->set_state(TrxHandle::S_REPLICATING);
         gu_trace(replicator_.process_trx(recv_ctx, trx.trx()));
         exit_loop = trx.trx()->exit_loop(); // this is the end of trx lifespan
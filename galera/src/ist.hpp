@@ -167,7 +167,7 @@ namespace galera
         class AsyncSenderMap
         {
         public:
-            AsyncSenderMap(GCS_IMPL& gcs, gcache::GCache& gcache)
+            explicit AsyncSenderMap(gcache::GCache& gcache)
                 :
                 senders_(),
 #ifdef HAVE_PSI_INTERFACE
@@ -206,9 +206,10 @@ KeySetOut::KeyPart::KeyPart (KeyParts&      added,
                              const KeyData& kd,
                              int const      part_num,
                              int const      ws_ver,
-                             int const      alignment)
+                             int const      alignment,
+                             const LeafHash* leaf_hash)
     :
-    hash_ (parent->hash_),
+    hash_ (leaf_hash ? leaf_hash->state : parent->hash_),
     part_ (0),
     value_(static_cast<const gu::byte_t*>(kd.parts[part_num].ptr)),
     size_ (kd.parts[part_num].len),
@@ -216,14 +217,22 @@ KeySetOut::KeyPart::KeyPart (KeyParts&      added,
     own_  (false)
 {
     assert (ver_);
-    uint32_t const s(gu::htog(size_));
-    hash_.append (&s, sizeof(s));
-    hash_.append (value_, size_);
 
     KeySet::KeyPart::TmpStore ts;
     KeySet::KeyPart::HashData hd;
 
-    hash_.gather<sizeof(hd.buf)>(hd.buf);
+    if (leaf_hash)
+    {
+        assert (part_num + 1 == kd.parts_num);
+        hd = leaf_hash->data;
+    }
+    else
+    {
+        uint32_t const s(gu::htog(size_));
+        hash_.append (&s, sizeof(s));
+        hash_.append (value_, size_);
+        hash_.gather<sizeof(hd.buf)>(hd.buf);
+    }
 
     /* only leaf part of the key can be not WSREP_KEY_SHARED */
     bool const leaf (part_num + 1 == kd.parts_num);
@@ -329,7 +338,7 @@ KeySetOut::KeyPart::print (std::ostream& os) const
 #define CHECK_PREVIOUS_KEY 1
 
 size_t
-KeySetOut::append (const KeyData& kd)
+KeySetOut::append (const KeyData& kd, const LeafHash* const leaf)
 {
     int i(0);
 
@@ -400,7 +409,8 @@ KeySetOut::append (const KeyData& kd)
     {
         try
         {
-            KeyPart kp(added_, *this, parent, kd, i, ws_ver_, alignment());
+            KeyPart kp(added_, *this, parent, kd, i, ws_ver_, alignment(),
+                       i + 1 == kd.parts_num ? leaf : NULL);
 
 #ifdef CHECK_PREVIOUS_KEY
             if (size_t(j) < new_.size())
@@ -454,6 +464,103 @@ out:
     return size() - old_size;
 }
 
+/* returns true if keys differ only in the leaf part */
+static inline bool
+same_branch (const wsrep_key_t& a, const wsrep_key_t& b)
+{
+    if (a.key_parts_num != b.key_parts_num) return false;
+
+    for (size_t i(0); i + 1 < a.key_parts_num; ++i)
+    {
+        const wsrep_buf_t& pa(a.key_parts[i]);
+        const wsrep_buf_t& pb(b.key_parts[i]);
+
+        if (pa.len != pb.len || ::memcmp(pa.ptr, pb.ptr, pa.len)) return false;
+    }
+
+    return true;
+}
+
+size_t
+KeySetOut::append (const wsrep_key_t*     const keys,
+                   size_t                 const keys_num,
+                   wsrep_key_type_t       const type,
+                   bool                   const copy)
+{
+    static int const LANES(gu::Hash::LANES);
+
+    added_.reserve(keys_num);
+
+    size_t ret(0);
+
+    gu::Hash           branch;       // hash of non-leaf parts of branch_key
+    const wsrep_key_t* branch_key(NULL);
+
+    for (size_t i(0); i < keys_num; i += LANES)
+    {
+        int const lanes(std::min<size_t>(LANES, keys_num - i));
+
+        LeafHash    leaves[LANES];
+        gu::Hash*   hashes[LANES];
+        const void* values[LANES];
+        size_t      sizes [LANES];
+        int         n(0);
+
+        for (int l(0); l < lanes; ++l)
+        {
+            const wsrep_key_t& key(keys[i + l]);
+
+            if (0 == key.key_parts_num) continue;
+
+            if (!branch_key || !same_branch(*branch_key, key))
+            {
+                branch = gu::Hash();
+
+                for (size_t p(0); p + 1 < key.key_parts_num; ++p)
+                {
+                    uint32_t const s(gu::htog<uint32_t>(key.key_parts[p].len));
+                    branch.append (&s, sizeof(s));
+                    branch.append (key.key_parts[p].ptr, key.key_parts[p].len);
+                }
+
+                branch_key = &key;
+            }
+
+            const wsrep_buf_t& part(key.key_parts[key.key_parts_num - 1]);
+            uint32_t const s(gu::htog<uint32_t>(part.len));
+
+            leaves[l].state = branch;
+            leaves[l].state.append (&s, sizeof(s));
+
+            hashes[n] = &leaves[l].state;
+            values[n] = part.ptr;
+            sizes [n] = part.len;
+            ++n;
+        }
+
+        if (n > 0) gu::Hash::append_lanes(hashes, values, sizes, n);
+
+        for (int l(0); l < lanes; ++l)
+        {
+            const wsrep_key_t& key(keys[i + l]);
+            LeafHash* leaf(NULL);
+
+            if (key.key_parts_num > 0)
+            {
+                leaf = &leaves[l];
+                leaf->state.gather<sizeof(leaf->data.buf)>(leaf->data.buf);
+            }
+
+            /* protocol version is verified by the caller */
+            KeyData const kd(0, key.key_parts, key.key_parts_num, type, copy);
+
+            ret += append(kd, leaf);
+        }
+    }
+
+    return ret;
+}
+
 #if 0
 const KeyIn&
 galera::KeySetIn::get_key() const
@@ -544,6 +544,17 @@ public:
 
         size_t size() const { return (first_size_ + second_->size()); }
 
+        /* prepares for a batch of n insertions, so that the heap set does
+         * not have to grow gradually */
+        void reserve(size_t const n)
+        {
+            if (n <= FIRST_SIZE) return;
+
+            if (!second_) second_ = new KeyPartSet();
+
+            second_->rehash(second_->size() + n);
+        }
+
     private:
 
         static unsigned int const FIRST_MASK  = 0x3f; // 63
@@ -556,6 +567,13 @@ public:
     };
 #endif /* 1 */
 
+    /* precomputed hash of a leaf key part */
+    struct LeafHash
+    {
+        gu::Hash                  state;
+        KeySet::KeyPart::HashData data;
+    };
+
     class KeyPart
     {
     public:
@@ -581,7 +599,8 @@ public:
                  const KeyData& kd,
                  int const      part_num,
                  int const      ws_ver,
-                 int const      alignment);
+                 int const      alignment,
+                 const LeafHash* leaf_hash = NULL);
 
         KeyPart (const KeyPart& k)
         :
@@ -700,7 +719,16 @@ public:
     ~KeySetOut () {}
 
     size_t
-    append (const KeyData& kd);
+    append (const KeyData& kd) { return append(kd, NULL); }
+
+    /* Appends keys_num keys of the same type at once. Leaf part hashes
+     * of several keys are computed together, which pays off for large
+     * batches of keys that share everything but the leaf. */
+    size_t
+    append (const wsrep_key_t*     keys,
+            size_t                 keys_num,
+            wsrep_key_type_t       type,
+            bool                   copy);
 
     KeySet::Version
     version () { return count() ? version_ : KeySet::EMPTY; }
@@ -714,6 +742,9 @@ private:
     KeySet::Version       version_;
     int                   ws_ver_;
 
+    size_t
+    append (const KeyData& kd, const LeafHash* leaf);
+
     static gu::RecordSet::CheckType
     check_type (KeySet::Version ver)
     {
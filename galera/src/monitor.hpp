@@ -6,6 +6,7 @@
 #define GALERA_MONITOR_HPP
 
 #include "trx_handle.hpp"
+#include "trx_trace.hpp"
 #include <gu_lock.hpp> // for gu::Mutex and gu::Cond
 #include <gu_limits.h>
 
@@ -64,7 +65,9 @@ namespace galera
             entered_(0),
             oooe_(0),
             oool_(0),
-            win_size_(0)
+            win_size_(0),
+            dependency_order_(false),
+            trace_id_(trx_trace::MON_NONE)
         { }
 
         ~Monitor()
@@ -114,6 +117,9 @@ namespace galera
 
             pre_enter(obj, lock);
 
+            trx_trace::record(trx_trace::EV_MON_WAIT, obj_seqno, obj.trx_id(),
+                              trace_id_);
+
             if (gu_likely(process_[idx].state_ != Process::S_CANCELED))
             {
                 assert(process_[idx].state_ == Process::S_IDLE);
@@ -142,6 +148,8 @@ namespace galera
                     ++entered_;
                     oooe_     += ((last_left_ + 1) < obj_seqno);
                     win_size_ += (last_entered_ - last_left_);
+                    trx_trace::record(trx_trace::EV_MON_ENTER, obj_seqno,
+                                      obj.trx_id(), trace_id_);
                     return;
                 }
             }
@@ -165,6 +173,9 @@ namespace galera
             assert(process_[indexof(last_left_)].state_ == Process::S_IDLE);
 
             post_leave(obj, lock);
+
+            trx_trace::record(trx_trace::EV_MON_LEAVE, obj.seqno(),
+                              obj.trx_id(), trace_id_);
         }
 
         void self_cancel(C& obj)
@@ -194,6 +205,9 @@ namespace galera
 
             if (obj_seqno > last_entered_) last_entered_ = obj_seqno;
 
+            trx_trace::record(trx_trace::EV_MON_CANCEL, obj_seqno, obj.trx_id(),
+                              trace_id_);
+
             if (obj_seqno <= drain_seqno_)
             {
                 post_leave(obj, lock);
@@ -234,6 +248,20 @@ namespace galera
             }
         }
 
+        /*!
+         * In dependency order an object which does not satisfy its
+         * condition() may still enter as soon as all the writesets
+         * recorded in its dependencies() have left the monitor.
+         */
+        void set_dependency_order(bool const val)
+        {
+            gu::Lock lock(mutex_);
+            dependency_order_ = val;
+        }
+
+        /*! monitor identifier for trx_trace records */
+        void set_trace_id(trx_trace::Monitor const id) { trace_id_ = id; }
+
         wsrep_seqno_t last_left()   const
         {
             gu::Lock lock(mutex_);
@@ -310,14 +338,40 @@ namespace galera
 
     private:
 
-        size_t indexof(wsrep_seqno_t seqno)
+        size_t indexof(wsrep_seqno_t seqno) const
         {
             return (seqno & process_mask_);
         }
 
         bool may_enter(const C& obj) const
         {
-            return obj.condition(last_entered_, last_left_);
+            return (obj.condition(last_entered_, last_left_) ||
+                    (dependency_order_ == true && dependencies_left(obj)));
+        }
+
+        bool has_left(wsrep_seqno_t const seqno) const
+        {
+            return (seqno <= last_left_ ||
+                    (seqno <= last_entered_ &&
+                     process_[indexof(seqno)].state_ == Process::S_FINISHED));
+        }
+
+        bool dependencies_left(const C& obj) const
+        {
+            const TrxHandle::Dependencies* const deps(obj.dependencies());
+
+            if (deps == 0 || deps->recorded() == false ||
+                last_left_ < deps->floor())
+            {
+                return false;
+            }
+
+            for (int i(0); i < deps->size(); ++i)
+            {
+                if (has_left(deps->seqno(i)) == false) return false;
+            }
+
+            return true;
         }
 
         // wait until it is possible to grab slot in monitor,
@@ -397,6 +451,9 @@ namespace galera
             else
             {
                 process_[idx].state_ = Process::S_FINISHED;
+
+                // waiters may depend on this one only
+                if (dependency_order_ == true) wake_up_next();
             }
 
             process_[idx].obj_ = 0;
@@ -453,6 +510,8 @@ namespace galera
         long oooe_;     // out of order entered
         long oool_;     // out of order left
         long win_size_; // window between last_left_ and last_entered_
+        bool dependency_order_;
+        trx_trace::Monitor trace_id_;
     };
 }
 
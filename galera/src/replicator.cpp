@@ -3,11 +3,19 @@
 //
 
 #include "replicator.hpp"
+#include "trx_trace.hpp"
+
+#include <gu_utils.hpp>
 
 namespace galera
 {
 
 std::string const Replicator::Param::debug_log = "debug";
+std::string const Replicator::Param::debug_trace = "debug.trace";
+std::string const Replicator::Param::debug_trace_dump = "debug.trace_dump";
+std::string const Replicator::Param::debug_trace_ring_size =
+    "debug.trace_ring_size";
+std::string const Replicator::Param::debug_log_async = "debug.log_async";
 #ifdef GU_DBUG_ON
 std::string const Replicator::Param::dbug = "dbug";
 std::string const Replicator::Param::signal = "signal";
@@ -16,6 +24,11 @@ std::string const Replicator::Param::signal = "signal";
 void Replicator::register_params(gu::Config& conf)
 {
     conf.add(Param::debug_log, "no");
+    conf.add(Param::debug_trace, "no");
+    conf.add(Param::debug_trace_dump, "");
+    conf.add(Param::debug_trace_ring_size,
+             gu::to_string(trx_trace::RING_SIZE_DEFAULT));
+    conf.add(Param::debug_log_async, "0");
 #ifdef GU_DBUG_ON
     conf.add(Param::dbug, "");
     conf.add(Param::signal, "");
@@ -28,6 +28,10 @@ namespace galera
         struct Param
         {
             static std::string const debug_log;
+            static std::string const debug_trace;
+            static std::string const debug_trace_dump;
+            static std::string const debug_trace_ring_size;
+            static std::string const debug_log_async;
 #ifdef GU_DBUG_ON
             static std::string const dbug;
             static std::string const signal;
@@ -123,6 +123,7 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     :
     init_lib_           (reinterpret_cast<gu_log_cb_t>(args->logger_cb),
                          reinterpret_cast<gu_pfs_instr_cb_t>(args->pfs_instr_cb)),
+    log_async_guard_    (),
     config_             (),
     init_config_        (config_, args->node_address, args->data_dir),
     parse_options_      (*this, config_, args->options),
@@ -134,6 +135,8 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     sst_state_          (SST_NONE),
     co_mode_            (CommitOrder::from_string(
                              config_.get(Param::commit_order))),
+    ao_mode_            (ApplyOrder::from_string(
+                             config_.get(Param::apply_order))),
     state_file_         (config_.get(BASE_DIR)+'/'+GALERA_STATE_FILE),
     st_                 (state_file_),
     safe_to_bootstrap_  (true),
@@ -175,7 +178,7 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     gcs_as_             (slave_pool_, gcs_, *this, gcache_),
     ist_receiver_       (config_, slave_pool_, args->node_address),
     ist_prepared_       (false),
-    ist_senders_        (gcs_, gcache_),
+    ist_senders_        (gcache_),
     wsdb_               (),
     cert_               (config_, service_thd_, gcache_),
 #ifdef HAVE_PSI_INTERFACE
@@ -191,6 +194,7 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     commit_monitor_     (),
 #endif /* HAVE_PSI_INTERFACE */
     causal_read_timeout_(config_.get(Param::causal_read_timeout)),
+    priority_ws_size_   (config_.get<ssize_t>(Param::priority_ws_size)),
     receivers_          (),
     replicated_         (),
     replicated_bytes_   (),
@@ -203,6 +207,7 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     local_cert_failures_(),
     local_replays_      (),
     causal_reads_       (),
+    latency_            (),
     preordered_id_      (),
     incoming_list_      (""),
 #ifdef HAVE_PSI_INTERFACE
@@ -257,6 +262,19 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
 
     local_monitor_.set_initial_position(0);
 
+    local_monitor_.set_trace_id(trx_trace::MON_LOCAL);
+    apply_monitor_.set_trace_id(trx_trace::MON_APPLY);
+    commit_monitor_.set_trace_id(trx_trace::MON_COMMIT);
+
+    if (ao_mode_ == ApplyOrder::DEPENDENCIES)
+    {
+        apply_monitor_.set_dependency_order(true);
+        cert_.set_record_dependencies(true);
+    }
+
+    gu::Allocator::arena_configure(config_.get<size_t>(Param::ws_heap_limit),
+                                   config_.get<size_t>(Param::ws_spill_pool));
+
     wsrep_uuid_t  uuid;
     wsrep_seqno_t seqno;
 
@@ -477,7 +495,9 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
     ApplyOrder ao(*trx);
     CommitOrder co(*trx, co_mode_);
 
+    long long t0(gu_time_monotonic());
     gu_trace(apply_monitor_.enter(ao));
+    latency_[LAT_APPLY_MONITOR].insert(gu_time_monotonic() - t0);
     trx->set_state(TrxHandle::S_APPLYING);
 
     wsrep_trx_meta_t meta = {{state_uuid_, trx->global_seqno() },
@@ -489,7 +509,9 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
         st_.mark_unsafe();
     }
 
+    t0 = gu_time_monotonic();
     gu_trace(apply_trx_ws(recv_ctx, apply_cb_, commit_cb_, *trx, meta));
+    latency_[LAT_APPLY].insert(gu_time_monotonic() - t0);
     /* at this point any exception in apply_trx_ws() is fatal, not
      * catching anything. */
 
@@ -499,7 +521,9 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
         /* TOI action are fully serialized so it is make sense to
         enforce commit ordering at this stage. For non-TOI action
         commit ordering is delayed to take advantage of full parallelism. */
+        t0 = gu_time_monotonic();
         gu_trace(commit_monitor_.enter(co));
+        latency_[LAT_COMMIT_MONITOR].insert(gu_time_monotonic() - t0);
         commit_trx_handle = NULL;
     }
     trx->set_state(TrxHandle::S_COMMITTING);
@@ -605,11 +629,17 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
 
     ssize_t rcode(-1);
 
+    /* small write sets bypass the send queue, see repl.priority_ws_size.
+     * They don't get a GCS handle, so can't be interrupted while waiting
+     * to be sent. */
+    bool const priority(trx->new_version() && act.size <= priority_ws_size_);
+    long long const t0(gu_time_monotonic());
+
     do
     {
         assert(act.seqno_g == GCS_SEQNO_ILL);
 
-        const ssize_t gcs_handle(gcs_.schedule());
+        const ssize_t gcs_handle(priority ? 0 : gcs_.schedule());
 
         if (gu_unlikely(gcs_handle < 0))
         {
@@ -618,7 +648,10 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
             goto must_abort;
         }
 
-        trx->set_gcs_handle(gcs_handle);
+        trx->set_gcs_handle(priority ? -1 : gcs_handle);
+
+        trx_trace::record(trx_trace::EV_GCS_SEND, WSREP_SEQNO_UNDEFINED,
+                          trx->trx_id(), priority);
 
         if (trx->new_version())
         {
@@ -626,7 +659,7 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
             assert(trx->last_seen_seqno() >= 0);
             trx->unlock();
             assert (act.buf == NULL); // just a sanity check
-            rcode = gcs_.replv(actv, act, true);
+            rcode = gcs_.replv(actv, act, !priority, priority);
         }
         else
         {
@@ -670,14 +703,16 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
     assert(act.seqno_l != GCS_SEQNO_ILL);
     assert(act.seqno_g != GCS_SEQNO_ILL);
 
+    latency_[LAT_REPL].insert(gu_time_monotonic() - t0);
+    trx_trace::record(trx_trace::EV_GCS_REPL, act.seqno_g, trx->trx_id(), 0);
     ++replicated_;
     replicated_bytes_ += rcode;
     trx->set_gcs_handle(-1);
 
     if (trx->new_version())
     {
-        gu_trace(trx->unserialize(static_cast<const gu::byte_t*>(act.buf),
-                                  act.size, 0));
+        gu_trace(trx->unserialize_local(
+                     static_cast<const gu::byte_t*>(act.buf), act.size));
         trx->update_stats(keys_count_, keys_bytes_, data_bytes_, unrd_bytes_);
     }
 
@@ -856,10 +891,12 @@ wsrep_status_t galera::ReplicatorSMM::pre_commit(TrxHandle*        trx,
     ApplyOrder ao(*trx);
     CommitOrder co(*trx, co_mode_);
     bool interrupted(false);
+    long long t0(gu_time_monotonic());
 
     try
     {
         gu_trace(apply_monitor_.enter(ao));
+        latency_[LAT_APPLY_MONITOR].insert(gu_time_monotonic() - t0);
     }
     catch (gu::Exception& e)
     {
@@ -879,9 +916,11 @@ wsrep_status_t galera::ReplicatorSMM::pre_commit(TrxHandle*        trx,
         trx->set_state(TrxHandle::S_COMMITTING);
         if (co_mode_ != CommitOrder::BYPASS)
         {
+            t0 = gu_time_monotonic();
             try
             {
                 gu_trace(commit_monitor_.enter(co));
+                latency_[LAT_COMMIT_MONITOR].insert(gu_time_monotonic() - t0);
             }
             catch (gu::Exception& e)
             {
@@ -1261,7 +1300,8 @@ writeset_from_handle (wsrep_po_handle_t& handle,
                 /* key format is not essential since we're not adding keys */
                 KeySet::version(trx_params.key_format_), NULL, 0, 0,
                 trx_params.record_set_ver_,
-                WriteSetNG::MAX_VERSION, DataSet::MAX_VERSION, DataSet::MAX_VERSION,
+                WriteSetNG::MAX_VERSION, trx_params.data_set_ver_,
+                trx_params.data_set_ver_,
                 trx_params.max_write_set_size_);
 
             handle.opaque = ret;
@@ -1458,7 +1498,7 @@ void galera::ReplicatorSMM::process_commit_cut(wsrep_seqno_t seq,
 
     if (seq >= cc_seqno_) /* Refs #782. workaround for
                            * assert(seqno >= seqno_released_) in gcache. */
-        cert_.purge_trxs_upto(seq, true);
+        cert_.schedule_purge(seq);
 
     local_monitor_.leave(lo);
     log_debug << "Got commit cut from GCS: " << seq;
@@ -1467,6 +1507,7 @@ void galera::ReplicatorSMM::process_commit_cut(wsrep_seqno_t seq,
 void galera::ReplicatorSMM::establish_protocol_versions (int proto_ver)
 {
     trx_params_.record_set_ver_ = gu::RecordSet::VER1;
+    trx_params_.data_set_ver_   = DataSet::VER1;
 
     switch (proto_ver)
     {
@@ -1510,6 +1551,16 @@ void galera::ReplicatorSMM::establish_protocol_versions (int proto_ver)
         trx_params_.record_set_ver_ = gu::RecordSet::VER2;
         str_proto_ver_ = 2;
         break;
+    case 10:
+        // Protocol upgrade to enable support for compressed data sets.
+        trx_params_.version_ = 4;
+        trx_params_.record_set_ver_ = gu::RecordSet::VER2;
+        if (config_.get<bool>(Param::data_compression))
+        {
+            trx_params_.data_set_ver_ = DataSet::VER2;
+        }
+        str_proto_ver_ = 2;
+        break;
     default:
         log_fatal << "Configuration change resulted in an unsupported protocol "
             "version: " << proto_ver << ". Can't continue.";
@@ -1945,10 +1996,12 @@ wsrep_status_t galera::ReplicatorSMM::cert(TrxHandle* trx)
     CommitOrder co(*trx, co_mode_);
 
     bool interrupted(false);
+    long long t0(gu_time_monotonic());
 
     try
     {
         gu_trace(local_monitor_.enter(lo));
+        latency_[LAT_LOCAL_MONITOR].insert(gu_time_monotonic() - t0);
     }
     catch (gu::Exception& e)
     {
@@ -1961,7 +2014,11 @@ wsrep_status_t galera::ReplicatorSMM::cert(TrxHandle* trx)
 
     if (gu_likely (!interrupted))
     {
-        switch (cert_.append_trx(trx))
+        t0 = gu_time_monotonic();
+        Certification::TestResult const res(cert_.append_trx(trx));
+        latency_[LAT_CERT].insert(gu_time_monotonic() - t0);
+
+        switch (res)
         {
         case Certification::TEST_OK:
             if (gu_likely(applicable))
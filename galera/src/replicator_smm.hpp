@@ -13,6 +13,7 @@
 #include "replicator.hpp"
 
 #include "gu_init.h"
+#include "gu_conf.h"
 #include "GCache.hpp"
 #include "gcs.hpp"
 #include "monitor.hpp"
@@ -25,6 +26,8 @@
 #include "gcs_action_source.hpp"
 #include "ist.hpp"
 #include "gu_atomic.hpp"
+#include "gu_histogram.hpp"
+#include "gu_time.h"
 #include "saved_state.hpp"
 #include "gu_debug_sync.hpp"
 
@@ -104,7 +107,9 @@ namespace galera
         {
             TrxHandle* trx = reinterpret_cast<TrxHandle*>(trx_handle);
             CommitOrder co(*trx, co_mode_);
+            long long const t0(gu_time_monotonic());
             commit_monitor_.enter(co);
+            latency_[LAT_COMMIT_MONITOR].insert(gu_time_monotonic() - t0);
             return WSREP_OK;
         }
 
@@ -203,8 +208,13 @@ namespace galera
             static const std::string proto_max;
             static const std::string key_format;
             static const std::string commit_order;
+            static const std::string apply_order;
             static const std::string causal_read_timeout;
             static const std::string max_write_set_size;
+            static const std::string priority_ws_size;
+            static const std::string ws_heap_limit;
+            static const std::string ws_spill_pool;
+            static const std::string data_compression;
         };
 
         typedef std::pair<std::string, std::string> Default;
@@ -264,12 +274,19 @@ namespace galera
 
             wsrep_seqno_t seqno() const { return seqno_; }
 
+            wsrep_trx_id_t trx_id() const
+            {
+                return (trx_ != 0 ? trx_->trx_id() : 0);
+            }
+
             bool condition(wsrep_seqno_t last_entered,
                            wsrep_seqno_t last_left) const
             {
                 return (last_left + 1 == seqno_);
             }
 
+            const TrxHandle::Dependencies* dependencies() const { return 0; }
+
 #ifdef GU_DBUG_ON
 #ifdef HAVE_PSI_INTERFACE
             void debug_sync(gu::MutexWithPFS& mutex)
@@ -297,6 +314,27 @@ namespace galera
         {
         public:
 
+            typedef enum
+            {
+                WATERMARK    = 0, // wait for all up to depends_seqno
+                DEPENDENCIES = 1  // wait for recorded dependencies only
+            } Mode;
+
+            static Mode from_string(const std::string& str)
+            {
+                int ret(gu::from_string<int>(str));
+                switch (ret)
+                {
+                case WATERMARK:
+                case DEPENDENCIES:
+                    break;
+                default:
+                    gu_throw_error(EINVAL)
+                        << "invalid value " << str << " for apply order mode";
+                }
+                return static_cast<Mode>(ret);
+            }
+
             ApplyOrder(TrxHandle& trx) : trx_(trx) { }
 
             void lock()   { trx_.lock();   }
@@ -304,6 +342,8 @@ namespace galera
 
             wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
 
+            wsrep_trx_id_t trx_id() const { return trx_.trx_id(); }
+
             bool condition(wsrep_seqno_t last_entered,
                            wsrep_seqno_t last_left) const
             {
@@ -311,6 +351,11 @@ namespace galera
                         last_left >= trx_.depends_seqno());
             }
 
+            const TrxHandle::Dependencies* dependencies() const
+            {
+                return &trx_.dependencies();
+            }
+
 #ifdef GU_DBUG_ON
 #ifdef HAVE_PSI_INTERFACE
             void debug_sync(gu::MutexWithPFS& mutex)
@@ -381,6 +426,8 @@ namespace galera
             void lock()   { trx_.lock();   }
             void unlock() { trx_.unlock(); }
             wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
+
+            wsrep_trx_id_t trx_id() const { return trx_.trx_id(); }
             bool condition(wsrep_seqno_t last_entered,
                            wsrep_seqno_t last_left) const
             {
@@ -402,6 +449,8 @@ namespace galera
                 gu_throw_fatal << "invalid commit mode value " << mode_;
             }
 
+            const TrxHandle::Dependencies* dependencies() const { return 0; }
+
 #ifdef GU_DBUG_ON
 #ifdef HAVE_PSI_INTERFACE
             void debug_sync(gu::MutexWithPFS& mutex)
@@ -537,6 +586,17 @@ namespace galera
         };
 
         InitLib                init_lib_;
+
+        class LogAsyncGuard /* stops asynchronous log writer thread */
+        {
+        public:
+            LogAsyncGuard () { }
+            ~LogAsyncGuard() { gu_conf_log_async(0); }
+        };
+
+        /* must precede parse_options_, which may start the writer thread,
+         * so that it is stopped even if construction fails */
+        LogAsyncGuard          log_async_guard_;
         gu::Config             config_;
 
         InitConfig
@@ -568,7 +628,11 @@ namespace galera
          * |                 7 |           3 |              2 |               1 |
          * |                 8 |           3 |              2 |               2 |
          * |                 9 |           4 |              2 |               2 |
+         * |                10 |           4 |              2 |               2 |
          * |--------------------------------------------------------------------|
+         *
+         * Protocol 10 adds compressed data sets (DataSet::VER2), used only if
+         * repl.data_compression is enabled.
          */
 
         int                    str_proto_ver_;// state transfer request protocol
@@ -580,6 +644,7 @@ namespace galera
 
         // configurable params
         const CommitOrder::Mode co_mode_; // commit order mode
+        const ApplyOrder::Mode  ao_mode_; // apply order mode
 
         // persistent data location
         std::string           state_file_;
@@ -644,6 +709,7 @@ namespace galera
         Monitor<ApplyOrder>  apply_monitor_;
         Monitor<CommitOrder> commit_monitor_;
         gu::datetime::Period causal_read_timeout_;
+        ssize_t              priority_ws_size_;
 
         // counters
         gu::Atomic<size_t>    receivers_;
@@ -659,6 +725,20 @@ namespace galera
         gu::Atomic<long long> local_replays_;
         gu::Atomic<long long> causal_reads_;
 
+        // per-stage latencies (ns) of the commit path
+        enum LatencyStage
+        {
+            LAT_REPL,           // replication: schedule + send + delivery
+            LAT_CERT,           // certification proper
+            LAT_LOCAL_MONITOR,  // local monitor wait
+            LAT_APPLY_MONITOR,  // apply monitor wait
+            LAT_APPLY,          // apply callback
+            LAT_COMMIT_MONITOR, // commit monitor wait
+            LAT_MAX
+        };
+
+        gu::LatencyHistogram  latency_[LAT_MAX];
+
         gu::Atomic<long long> preordered_id_; // temporary preordered ID
 
         // non-atomic stats
@@ -16,6 +16,8 @@ static const std::string common_prefix = "repl.";
 
 const std::string galera::ReplicatorSMM::Param::commit_order =
     common_prefix + "commit_order";
+const std::string galera::ReplicatorSMM::Param::apply_order =
+    common_prefix + "apply_order";
 const std::string galera::ReplicatorSMM::Param::causal_read_timeout =
     common_prefix + "causal_read_timeout";
 const std::string galera::ReplicatorSMM::Param::proto_max =
@@ -24,8 +26,16 @@ const std::string galera::ReplicatorSMM::Param::key_format =
     common_prefix + "key_format";
 const std::string galera::ReplicatorSMM::Param::max_write_set_size =
     common_prefix + "max_ws_size";
+const std::string galera::ReplicatorSMM::Param::priority_ws_size =
+    common_prefix + "priority_ws_size";
+const std::string galera::ReplicatorSMM::Param::ws_heap_limit =
+    common_prefix + "ws_heap_limit";
+const std::string galera::ReplicatorSMM::Param::ws_spill_pool =
+    common_prefix + "ws_spill_pool";
+const std::string galera::ReplicatorSMM::Param::data_compression =
+    common_prefix + "data_compression";
 
-int const galera::ReplicatorSMM::MAX_PROTO_VER(9);
+int const galera::ReplicatorSMM::MAX_PROTO_VER(10);
 
 galera::ReplicatorSMM::Defaults::Defaults() : map_()
 {
@@ -34,10 +44,19 @@ galera::ReplicatorSMM::Defaults::Defaults() : map_()
     map_.insert(Default(Param::proto_max,  gu::to_string(MAX_PROTO_VER)));
     map_.insert(Default(Param::key_format, "FLAT8"));
     map_.insert(Default(Param::commit_order, "3"));
+    map_.insert(Default(Param::apply_order, "0"));
     map_.insert(Default(Param::causal_read_timeout, "PT30S"));
     const int max_write_set_size(galera::WriteSetNG::MAX_SIZE);
     map_.insert(Default(Param::max_write_set_size,
                         gu::to_string(max_write_set_size)));
+    map_.insert(Default(Param::priority_ws_size, "0"));
+    // No common heap budget by default: each write set is limited only by
+    // its own heap size, as before. Set repl.ws_heap_limit (e.g. to 256M)
+    // to cap heap used by all write sets together and spill the excess
+    // to file pages.
+    map_.insert(Default(Param::ws_heap_limit, "0"));
+    map_.insert(Default(Param::ws_spill_pool, "128M"));
+    map_.insert(Default(Param::data_compression, "no"));
 }
 
 const galera::ReplicatorSMM::Defaults galera::ReplicatorSMM::defaults;
@@ -138,6 +157,14 @@ galera::ReplicatorSMM::ParseOptions::ParseOptions(Replicator&       repl,
     {
         gu_conf_debug_off();
     }
+
+    trx_trace::ring_size(
+        conf.get<size_t>(Replicator::Param::debug_trace_ring_size));
+    trx_trace::enable(conf.get<bool>(Replicator::Param::debug_trace));
+
+    int const err(gu_conf_log_async(
+                      conf.get<long>(Replicator::Param::debug_log_async)));
+    if (err) gu_throw_error(-err) << "Failed to set async logging";
 #ifdef GU_DBUG_ON
     if (conf.is_set(galera::Replicator::Param::dbug))
     {
@@ -161,7 +188,7 @@ void
 galera::ReplicatorSMM::set_param (const std::string& key,
                                   const std::string& value)
 {
-    if (key == Param::commit_order)
+    if (key == Param::commit_order || key == Param::apply_order)
     {
         log_error << "setting '" << key << "' during runtime not allowed";
         gu_throw_error(EPERM)
@@ -187,6 +214,29 @@ galera::ReplicatorSMM::set_param (const std::string& key,
     {
         trx_params_.max_write_set_size_ = gu::from_string<int>(value);
     }
+    else if (key == Param::data_compression)
+    {
+        // see establish_protocol_versions()
+        bool const compress(gu::Config::from_config<bool>(value));
+        trx_params_.data_set_ver_ = (compress && protocol_version_ >= 10) ?
+            DataSet::VER2 : DataSet::VER1;
+    }
+    else if (key == Param::priority_ws_size)
+    {
+        priority_ws_size_ = gu::Config::from_config<ssize_t>(value);
+    }
+    else if (key == Param::ws_heap_limit)
+    {
+        gu::Allocator::arena_configure(
+            gu::Config::from_config<size_t>(value),
+            config_.get<size_t>(Param::ws_spill_pool));
+    }
+    else if (key == Param::ws_spill_pool)
+    {
+        gu::Allocator::arena_configure(
+            config_.get<size_t>(Param::ws_heap_limit),
+            gu::Config::from_config<size_t>(value));
+    }
     else
     {
         log_warn << "parameter '" << key << "' not found";
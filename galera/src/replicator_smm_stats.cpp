@@ -5,6 +5,8 @@
 #include <gu_debug_sync.hpp>
 #include <gu_mem.h>
 
+#include <sys/resource.h>
+
 // @todo: should be protected static member of the parent class
 static const size_t GALERA_STAGE_MAX(11);
 // @todo: should be protected static member of the parent class
@@ -93,10 +95,13 @@ typedef enum status_vars
     STATS_LOCAL_SEND_QUEUE_MAX,
     STATS_LOCAL_SEND_QUEUE_MIN,
     STATS_LOCAL_SEND_QUEUE_AVG,
+    STATS_LOCAL_SEND_QUEUE_WAIT,
+    STATS_LOCAL_SEND_QUEUE_PRIO_WAIT,
     STATS_LOCAL_RECV_QUEUE,
     STATS_LOCAL_RECV_QUEUE_MAX,
     STATS_LOCAL_RECV_QUEUE_MIN,
     STATS_LOCAL_RECV_QUEUE_AVG,
+    STATS_LOCAL_RECV_QUEUE_BYTES,
     STATS_LOCAL_CACHED_DOWNTO,
     STATS_FC_PAUSED_NS,
     STATS_FC_PAUSED_AVG,
@@ -123,6 +128,32 @@ typedef enum status_vars
     STATS_CERT_INTERVAL,
     STATS_OPEN_TRX,
     STATS_OPEN_CONN,
+    STATS_WS_HEAP_BYTES,
+    STATS_WS_SPILL_BYTES,
+    STATS_WS_SPILL_POOL_BYTES,
+    STATS_WS_SPILL_PAGES_CREATED,
+    STATS_WS_SPILL_PAGES_REUSED,
+    STATS_PAGE_FAULTS_MINOR,
+    STATS_PAGE_FAULTS_MAJOR,
+    STATS_LATENCY_REPL_P50,
+    STATS_LATENCY_REPL_P99,
+    STATS_LATENCY_REPL_P999,
+    STATS_LATENCY_CERT_P50,
+    STATS_LATENCY_CERT_P99,
+    STATS_LATENCY_CERT_P999,
+    STATS_LATENCY_LOCAL_MONITOR_P50,
+    STATS_LATENCY_LOCAL_MONITOR_P99,
+    STATS_LATENCY_LOCAL_MONITOR_P999,
+    STATS_LATENCY_APPLY_MONITOR_P50,
+    STATS_LATENCY_APPLY_MONITOR_P99,
+    STATS_LATENCY_APPLY_MONITOR_P999,
+    STATS_LATENCY_APPLY_P50,
+    STATS_LATENCY_APPLY_P99,
+    STATS_LATENCY_APPLY_P999,
+    STATS_LATENCY_COMMIT_MONITOR_P50,
+    STATS_LATENCY_COMMIT_MONITOR_P99,
+    STATS_LATENCY_COMMIT_MONITOR_P999,
+    STATS_LOG_DROPPED,
     STATS_IST_RECEIVE_STATUS,
     STATS_IST_RECEIVE_SEQNO_START,
     STATS_IST_RECEIVE_SEQNO_CURRENT,
@@ -152,10 +183,13 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "local_send_queue_max",     WSREP_VAR_INT64,  { 0 }  },
     { "local_send_queue_min",     WSREP_VAR_INT64,  { 0 }  },
     { "local_send_queue_avg",     WSREP_VAR_DOUBLE, { 0 }  },
+    { "local_send_queue_wait",    WSREP_VAR_DOUBLE, { 0 }  },
+    { "local_send_queue_prio_wait", WSREP_VAR_DOUBLE, { 0 }  },
     { "local_recv_queue",         WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_max",     WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_min",     WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_avg",     WSREP_VAR_DOUBLE, { 0 }  },
+    { "local_recv_queue_bytes",   WSREP_VAR_INT64,  { 0 }  },
     { "local_cached_downto",      WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused_ns",   WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused",      WSREP_VAR_DOUBLE, { 0 }  },
@@ -182,6 +216,32 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "cert_interval",            WSREP_VAR_DOUBLE, { 0 }  },
     { "open_transactions",        WSREP_VAR_INT64,  { 0 }  },
     { "open_connections",         WSREP_VAR_INT64,  { 0 }  },
+    { "ws_heap_bytes",            WSREP_VAR_INT64,  { 0 }  },
+    { "ws_spill_bytes",           WSREP_VAR_INT64,  { 0 }  },
+    { "ws_spill_pool_bytes",      WSREP_VAR_INT64,  { 0 }  },
+    { "ws_spill_pages_created",   WSREP_VAR_INT64,  { 0 }  },
+    { "ws_spill_pages_reused",    WSREP_VAR_INT64,  { 0 }  },
+    { "local_page_faults_minor",  WSREP_VAR_INT64,  { 0 }  },
+    { "local_page_faults_major",  WSREP_VAR_INT64,  { 0 }  },
+    { "latency_repl_p50",          WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_repl_p99",          WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_repl_p999",         WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_cert_p50",          WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_cert_p99",          WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_cert_p999",         WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_local_monitor_p50", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_local_monitor_p99", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_local_monitor_p999", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_monitor_p50", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_monitor_p99", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_monitor_p999", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_p50",         WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_p99",         WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_apply_p999",        WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_commit_monitor_p50", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_commit_monitor_p99", WSREP_VAR_DOUBLE, { 0 }  },
+    { "latency_commit_monitor_p999", WSREP_VAR_DOUBLE, { 0 }  },
+    { "log_dropped",              WSREP_VAR_INT64,  { 0 }  },
     { "ist_receive_status",       WSREP_VAR_STRING, { 0 }  },
     { "ist_receive_seqno_start",  WSREP_VAR_INT64,  { 0 }  },
     { "ist_receive_seqno_current",WSREP_VAR_INT64,  { 0 }  },
@@ -236,10 +296,14 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_LOCAL_SEND_QUEUE_MAX].value._int64  = stats.send_q_len_max;
     sv[STATS_LOCAL_SEND_QUEUE_MIN].value._int64  = stats.send_q_len_min;
     sv[STATS_LOCAL_SEND_QUEUE_AVG].value._double = stats.send_q_len_avg;
+    sv[STATS_LOCAL_SEND_QUEUE_WAIT].value._double = stats.send_wait_avg;
+    sv[STATS_LOCAL_SEND_QUEUE_PRIO_WAIT].value._double =
+        stats.send_wait_prio_avg;
     sv[STATS_LOCAL_RECV_QUEUE    ].value._int64  = stats.recv_q_len;
     sv[STATS_LOCAL_RECV_QUEUE_MAX].value._int64  = stats.recv_q_len_max;
     sv[STATS_LOCAL_RECV_QUEUE_MIN].value._int64  = stats.recv_q_len_min;
     sv[STATS_LOCAL_RECV_QUEUE_AVG].value._double = stats.recv_q_len_avg;
+    sv[STATS_LOCAL_RECV_QUEUE_BYTES].value._int64 = stats.recv_q_size;
     sv[STATS_LOCAL_CACHED_DOWNTO ].value._int64  =
         seqno_min != GCS_SEQNO_ILL ? seqno_min : GCS_SEQNO_NIL;
     sv[STATS_FC_PAUSED_NS        ].value._int64  = stats.fc_paused_ns;
@@ -295,6 +359,33 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_OPEN_TRX].value._int64 = wsdb_stats.n_trx_;
     sv[STATS_OPEN_CONN].value._int64 = wsdb_stats.n_conn_;
 
+    gu::Allocator::ArenaStats arena_stats;
+    gu::Allocator::arena_stats(arena_stats);
+    sv[STATS_WS_HEAP_BYTES         ].value._int64 = arena_stats.heap_used;
+    sv[STATS_WS_SPILL_BYTES        ].value._int64 = arena_stats.spill_in_use;
+    sv[STATS_WS_SPILL_POOL_BYTES   ].value._int64 = arena_stats.spill_pooled;
+    sv[STATS_WS_SPILL_PAGES_CREATED].value._int64 = arena_stats.spill_created;
+    sv[STATS_WS_SPILL_PAGES_REUSED ].value._int64 = arena_stats.spill_reused;
+
+    /* process-wide, helps to judge gcache.huge_pages and gcache.numa_node */
+    struct rusage ru;
+    if (0 == getrusage(RUSAGE_SELF, &ru))
+    {
+        sv[STATS_PAGE_FAULTS_MINOR].value._int64 = ru.ru_minflt;
+        sv[STATS_PAGE_FAULTS_MAJOR].value._int64 = ru.ru_majflt;
+    }
+
+    /* per-stage latency percentiles, microseconds */
+    for (int i(0); i < LAT_MAX; ++i)
+    {
+        int const v(STATS_LATENCY_REPL_P50 + 3 * i);
+        sv[v    ].value._double = latency_[i].percentile(0.50) * 1.0e-3;
+        sv[v + 1].value._double = latency_[i].percentile(0.99) * 1.0e-3;
+        sv[v + 2].value._double = latency_[i].percentile(0.999) * 1.0e-3;
+    }
+
+    sv[STATS_LOG_DROPPED].value._int64 = gu_log_dropped();
+
     if (ist_receiver_.running())
     {
         // calculate %-age complete
@@ -329,6 +420,7 @@ galera::ReplicatorSMM::stats_get()
     // Get gcs backend status
     gu::Status status;
     gcs_.get_status(status);
+    status.insert("cert_purge_pause_hs", cert_.purge_pause_hs());
 #ifdef GU_DBUG_ON
     status.insert("debug_sync_waiters", gu_debug_sync_waiters());
 #endif // GU_DBUG_ON
@@ -419,6 +511,8 @@ galera::ReplicatorSMM::stats_reset()
     commit_monitor_.flush_stats();
 
     cert_.stats_reset();
+
+    for (int i(0); i < LAT_MAX; ++i) latency_[i].clear();
 }
 
 void
@@ -281,6 +281,28 @@ galera::TrxHandle::unserialize(const gu::byte_t* const buf, size_t const buflen,
 }
 
 
+void
+galera::TrxHandle::unserialize_local(const gu::byte_t* const buf,
+                                     size_t const            buflen)
+{
+    assert(local_);
+    assert(new_version());
+    assert(WriteSetNG::version(buf, buflen) == version_);
+
+    write_set_in_.read_local_buf(buf, buflen);
+    write_set_flags_ = wsng_flags_to_trx_flags(write_set_in_.flags());
+
+    assert(!memcmp(&write_set_in_.source_id(), &source_id_,
+                   sizeof(source_id_)));
+    assert(write_set_in_.conn_id()   == conn_id_);
+    assert(write_set_in_.trx_id()    == trx_id_);
+    assert(!write_set_in_.certified());
+    assert(write_set_in_.last_seen() == last_seen_seqno_);
+
+    timestamp_ = write_set_in_.timestamp();
+}
+
+
 size_t
 galera::TrxHandle::serial_size() const
 {
@@ -309,6 +331,11 @@ galera::TrxHandle::apply (void*                   recv_ctx,
 
         ws.rewind(); // make sure we always start from the beginning
 
+        /* Application events are appended to a single record (see
+         * DataSetOut::append()), so there are no boundaries the provider
+         * could split the set at for parallel apply. Big VER2 sets are at
+         * least unpacked by the checksum thread before getting here. */
+
         for (ssize_t i = 0; WSREP_CB_SUCCESS == err && i < ws.count(); ++i)
         {
             gu::Buf buf = ws.next();
@@ -12,6 +12,7 @@
 #include "key_data.hpp" // for append_key()
 #include "key_entry_os.hpp"
 #include "write_set_ng.hpp"
+#include "trx_trace.hpp"
 
 #include "wsrep_api.h"
 #include "gu_mutex.hpp"
@@ -50,23 +51,77 @@ namespace galera
             KeySet::Version        key_format_;
             gu::RecordSet::Version record_set_ver_;
             int                    max_write_set_size_;
+            DataSet::Version       data_set_ver_;
 
             Params (const std::string& wdir,
                     int                ver,
                     KeySet::Version    kformat,
                     gu::RecordSet::Version rsv = gu::RecordSet::VER2,
-                    int                max_write_set_size = WriteSetNG::MAX_SIZE)
+                    int                max_write_set_size = WriteSetNG::MAX_SIZE,
+                    DataSet::Version   dsv = DataSet::VER1)
                 :
                 working_dir_       (wdir),
                 version_           (ver),
                 key_format_        (kformat),
                 record_set_ver_    (rsv),
-                max_write_set_size_(max_write_set_size)
+                max_write_set_size_(max_write_set_size),
+                data_set_ver_      (dsv)
             {}
         };
 
         static const Params Defaults;
 
+        /*!
+         * Writesets this one must wait for before it can be applied in
+         * dependency apply order: everything up to floor() plus each
+         * listed seqno. Filled in by certification, see
+         * ReplicatorSMM::ApplyOrder.
+         */
+        class Dependencies
+        {
+        public:
+
+            static int const MAX_SEQNOS = 8;
+
+            Dependencies()
+                : floor_(WSREP_SEQNO_UNDEFINED), size_(-1), seqnos_()
+            { }
+
+            /* start recording with given floor */
+            void reset(wsrep_seqno_t floor) { floor_ = floor; size_ = 0; }
+
+            bool recorded() const { return size_ >= 0; }
+
+            void raise_floor(wsrep_seqno_t seqno)
+            {
+                if (seqno > floor_) floor_ = seqno;
+            }
+
+            void add(wsrep_seqno_t seqno)
+            {
+                if (size_ < 0 || seqno <= floor_) return;
+
+                for (int i(0); i < size_; ++i)
+                {
+                    if (seqnos_[i] == seqno) return;
+                }
+
+                // too many to track individually, degrade to watermark
+                if (size_ == MAX_SEQNOS) raise_floor(seqno);
+                else seqnos_[size_++] = seqno;
+            }
+
+            wsrep_seqno_t floor()      const { return floor_; }
+            int           size()       const { return size_; }
+            wsrep_seqno_t seqno(int i) const { return seqnos_[i]; }
+
+        private:
+
+            wsrep_seqno_t floor_;
+            int           size_;
+            wsrep_seqno_t seqnos_[MAX_SEQNOS];
+        };
+
         enum Flags
         {
             F_COMMIT      = 1 << 0,
@@ -217,7 +272,7 @@ namespace galera
         };
 
         /* slave trx factory */
-        typedef gu::MemPool<true> SlavePool;
+        typedef gu::MemPoolCached SlavePool;
         static TrxHandle* New(SlavePool& pool)
         {
             assert(pool.buf_size() == sizeof(TrxHandle));
@@ -228,7 +283,7 @@ namespace galera
         }
 
         /* local trx factory */
-        typedef gu::MemPool<true> LocalPool;
+        typedef gu::MemPoolCached LocalPool;
         static TrxHandle* New(LocalPool&          pool,
                               const Params&       params,
                               const wsrep_uuid_t& source_id,
@@ -335,7 +390,12 @@ namespace galera
         }
 
         State state() const { return state_(); }
-        void set_state(State state) { state_.shift_to(state); }
+        void set_state(State state)
+        {
+            state_.shift_to(state);
+            trx_trace::record(trx_trace::EV_STATE, global_seqno_, trx_id_,
+                              state);
+        }
 
         long gcs_handle() const { return gcs_handle_; }
         void set_gcs_handle(long gcs_handle) { gcs_handle_ = gcs_handle; }
@@ -350,6 +410,9 @@ namespace galera
 
         wsrep_seqno_t depends_seqno()   const { return depends_seqno_; }
 
+        Dependencies&       dependencies()       { return dependencies_; }
+        const Dependencies& dependencies() const { return dependencies_; }
+
         uint32_t      flags()           const { return write_set_flags_; }
 
         void set_flags(uint32_t flags)
@@ -367,13 +430,7 @@ namespace galera
 
         void append_key(const KeyData& key)
         {
-            /*! protection against protocol change during trx lifetime */
-            if (key.proto_ver != version_)
-            {
-                gu_throw_error(EINVAL) << "key version '" << key.proto_ver
-                                       << "' does not match to trx version' "
-                                       << version_ << "'";
-            }
+            check_key_version(key.proto_ver);
 
             if (new_version())
             {
@@ -385,6 +442,29 @@ namespace galera
             }
         }
 
+        void append_keys(int const proto_ver,
+                         const wsrep_key_t* const keys,
+                         size_t const keys_num,
+                         wsrep_key_type_t const type,
+                         bool const copy)
+        {
+            check_key_version(proto_ver);
+
+            if (new_version())
+            {
+                write_set_out().append_keys(keys, keys_num, type, copy);
+            }
+            else
+            {
+                for (size_t i(0); i < keys_num; ++i)
+                {
+                    KeyData const k(proto_ver, keys[i].key_parts,
+                                    keys[i].key_parts_num, type, copy);
+                    write_set_.append_key(k);
+                }
+            }
+        }
+
         void append_data(const void* data, const size_t data_len,
                          wsrep_data_type_t type, bool store)
         {
@@ -551,7 +631,7 @@ namespace galera
             if (refcnt_.sub_and_fetch(1) == 0) // delete and return to pool
             {
                 void* const ptr(this);
-                gu::MemPool<true>& mp(mem_pool_);
+                gu::MemPoolCached& mp(mem_pool_);
                 this->~TrxHandle();
                 mp.recycle(ptr);
             }
@@ -632,6 +712,11 @@ namespace galera
         size_t serialize  (gu::byte_t* buf, size_t buflen, size_t offset) const;
         size_t unserialize(const gu::byte_t* buf, size_t buflen, size_t offset);
 
+        /* Maps replicated buffer of a local (new version) trx without
+         * verifying checksums: buffer holds what write_set_out() has just
+         * gathered and trx metadata is already known. */
+        void unserialize_local(const gu::byte_t* buf, size_t buflen);
+
         void release_write_set_out()
         {
             if (gu_likely(new_version()))
@@ -646,9 +731,20 @@ namespace galera
 
         static uint32_t const COMMON_FLAGS_MASK = 0x03;
 
+        /*! protection against protocol change during trx lifetime */
+        void check_key_version(int const proto_ver) const
+        {
+            if (proto_ver != version_)
+            {
+                gu_throw_error(EINVAL) << "key version '" << proto_ver
+                                       << "' does not match to trx version' "
+                                       << version_ << "'";
+            }
+        }
+
         /* slave trx ctor */
         explicit
-        TrxHandle(gu::MemPool<true>& mp)
+        TrxHandle(gu::MemPoolCached& mp)
             :
             source_id_         (WSREP_UUID_UNDEFINED),
             conn_id_           (-1),
@@ -664,6 +760,7 @@ namespace galera
             global_seqno_      (WSREP_SEQNO_UNDEFINED),
             last_seen_seqno_   (WSREP_SEQNO_UNDEFINED),
             depends_seqno_     (WSREP_SEQNO_UNDEFINED),
+            dependencies_      (),
             timestamp_         (),
             write_set_         (Defaults.version_),
             write_set_in_      (),
@@ -686,7 +783,7 @@ namespace galera
         {}
 
         /* local trx ctor */
-        TrxHandle(gu::MemPool<true>&  mp,
+        TrxHandle(gu::MemPoolCached&  mp,
                   const Params&       params,
                   const wsrep_uuid_t& source_id,
                   wsrep_conn_id_t     conn_id,
@@ -708,6 +805,7 @@ namespace galera
             global_seqno_      (WSREP_SEQNO_UNDEFINED),
             last_seen_seqno_   (WSREP_SEQNO_UNDEFINED),
             depends_seqno_     (WSREP_SEQNO_UNDEFINED),
+            dependencies_      (),
             timestamp_         (gu_time_calendar()),
             write_set_         (params.version_),
             write_set_in_      (),
@@ -756,8 +854,8 @@ namespace galera
                                        0,
                                        params.record_set_ver_,
                                        WriteSetNG::Version(params.version_),
-                                       DataSet::MAX_VERSION,
-                                       DataSet::MAX_VERSION,
+                                       params.data_set_ver_,
+                                       params.data_set_ver_,
                                        params.max_write_set_size_);
             }
         }
@@ -779,6 +877,7 @@ namespace galera
         wsrep_seqno_t          global_seqno_;
         wsrep_seqno_t          last_seen_seqno_;
         wsrep_seqno_t          depends_seqno_;
+        Dependencies           dependencies_;
         int64_t                timestamp_;
         WriteSet               write_set_;
         WriteSetIn             write_set_in_;
@@ -788,7 +887,7 @@ namespace galera
         // Write set buffer location if stored outside TrxHandle.
         std::pair<const gu::byte_t*, size_t> write_set_buffer_;
 
-        gu::MemPool<true>&     mem_pool_;
+        gu::MemPoolCached&     mem_pool_;
         const void*            action_;
         long                   gcs_handle_;
         int                    version_;
@@ -0,0 +1,317 @@
+//
+// Copyright (C) 2018 Codership Oy <info@codership.com>
+//
+
+#include "trx_trace.hpp"
+
+#include <gu_atomic.h>
+#include <gu_lock.hpp>
+#include <gu_throw.hpp>
+#include <gu_time.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+gu::Atomic<int> galera::trx_trace::enabled_(0);
+
+namespace
+{
+    using galera::trx_trace::Record;
+
+    uint32_t thread_id()
+    {
+#ifdef __linux__
+        return syscall(SYS_gettid);
+#else
+        return reinterpret_cast<uintptr_t>(pthread_self());
+#endif
+    }
+
+    /* written only by the owning thread, pos_ is read by dump() */
+    struct Ring
+    {
+        explicit Ring(size_t const size)
+            : pos_(0), tid_(0), size_(size), buf_(new Record[size]())
+        {}
+
+        ~Ring() { delete[] buf_; }
+
+        long long    pos_;
+        uint32_t     tid_;
+        size_t const size_; // power of 2
+        Record*      buf_;
+
+    private:
+        Ring(const Ring&);
+        Ring& operator=(const Ring&);
+    };
+
+    /* When a thread exits its ring goes to the free list with the records
+     * intact and is reused by the next new thread, so the number of rings
+     * is bounded by peak thread count. Rings are freed only when the ring
+     * size changes. */
+    class Registry
+    {
+    public:
+
+        Registry()
+            :
+            mtx_  (),
+            rings_(),
+            free_ (),
+            key_  (),
+            size_ (galera::trx_trace::RING_SIZE_DEFAULT)
+        {
+            int const err(pthread_key_create(&key_, release));
+            if (err) gu_throw_error(err) << "Failed to create trace key";
+        }
+
+        Ring* ring()
+        {
+            Ring* const ret(static_cast<Ring*>(pthread_getspecific(key_)));
+            return gu_likely(ret != 0) ? ret : acquire();
+        }
+
+        size_t dump(FILE* file);
+
+        void   size(size_t size);
+        size_t size();
+
+    private:
+
+        Ring* acquire();
+
+        /* must be called with mtx_ locked */
+        void  destroy(Ring* ring);
+
+        static void release(void* arg);
+
+        gu::Mutex          mtx_;
+        std::vector<Ring*> rings_;
+        std::vector<Ring*> free_;
+        pthread_key_t      key_;
+        size_t             size_; // records in new rings
+
+        Registry(const Registry&);
+        Registry& operator=(const Registry&);
+    };
+
+    Registry& registry()
+    {
+        static Registry reg;
+        return reg;
+    }
+
+    Ring* Registry::acquire()
+    {
+        Ring* ret;
+
+        {
+            gu::Lock lock(mtx_);
+
+            if (free_.empty())
+            {
+                ret = new Ring(size_);
+                rings_.push_back(ret);
+            }
+            else
+            {
+                ret = free_.back();
+                free_.pop_back();
+            }
+        }
+
+        ret->tid_ = thread_id();
+        pthread_setspecific(key_, ret);
+
+        return ret;
+    }
+
+    void Registry::destroy(Ring* const ring)
+    {
+        rings_.erase(std::find(rings_.begin(), rings_.end(), ring));
+        delete ring;
+    }
+
+    void Registry::release(void* const arg)
+    {
+        Registry& reg(registry());
+        Ring* const ring(static_cast<Ring*>(arg));
+        gu::Lock lock(reg.mtx_);
+
+        if (ring->size_ == reg.size_)
+        {
+            reg.free_.push_back(ring);
+        }
+        else
+        {
+            reg.destroy(ring);
+        }
+    }
+
+    void Registry::size(size_t const size)
+    {
+        gu::Lock lock(mtx_);
+
+        if (size == size_) return;
+
+        size_ = size;
+
+        for (size_t i(0); i < free_.size(); ++i) destroy(free_[i]);
+
+        free_.clear();
+    }
+
+    size_t Registry::size()
+    {
+        gu::Lock lock(mtx_);
+        return size_;
+    }
+
+    size_t Registry::dump(FILE* const file)
+    {
+        gu::Lock lock(mtx_);
+
+        size_t ret(0);
+
+        for (size_t i(0); i < rings_.size(); ++i)
+        {
+            const Ring& r(*rings_[i]);
+            long long pos;
+            gu_atomic_get(&r.pos_, &pos);
+
+            long long const n(std::min<long long>(pos, r.size_));
+            size_t const begin((pos - n) & (r.size_ - 1));
+            size_t const first(std::min<size_t>(n, r.size_ - begin));
+
+            if (fwrite(r.buf_ + begin, sizeof(Record), first, file) != first ||
+                fwrite(r.buf_, sizeof(Record), n - first, file) != n - first)
+            {
+                gu_throw_error(errno) << "Failed to write trace records";
+            }
+
+            ret += n;
+        }
+
+        return ret;
+    }
+}
+
+void
+galera::trx_trace::enable(bool const val)
+{
+    if (val) registry(); // make sure it is initialized before use
+    enabled_ = val;
+}
+
+void
+galera::trx_trace::ring_size(size_t const size)
+{
+    static size_t const max_size(1 << 24);
+
+    if (size == 0 || size > max_size)
+    {
+        gu_throw_error(EINVAL) << "Invalid trace ring size " << size
+                               << ", must be in range [1, " << max_size << ']';
+    }
+
+    size_t n(1);
+    while (n < size) n <<= 1;
+
+    registry().size(n);
+}
+
+size_t
+galera::trx_trace::ring_size()
+{
+    return registry().size();
+}
+
+void
+galera::trx_trace::record_(Event const    ev,
+                           int64_t const  seqno,
+                           uint64_t const trx_id,
+                           int const      arg)
+{
+    Ring* const r(registry().ring());
+    Record& rec(r->buf_[r->pos_ & (r->size_ - 1)]);
+
+    rec.ts     = gu_time_monotonic();
+    rec.seqno  = seqno;
+    rec.trx_id = trx_id;
+    rec.tid    = r->tid_;
+    rec.event  = ev;
+    rec.arg    = arg;
+
+    long long const pos(r->pos_ + 1);
+    gu_atomic_set(&r->pos_, &pos);
+}
+
+size_t
+galera::trx_trace::dump(const std::string& path)
+{
+    FILE* const file(fopen(path.c_str(), "w"));
+
+    if (!file) gu_throw_error(errno) << "Failed to open '" << path << "'";
+
+    size_t ret(0);
+
+    try
+    {
+        Header hdr;
+        ::memcpy(hdr.magic, MAGIC, sizeof(hdr.magic));
+        hdr.record_size = sizeof(Record);
+        hdr.byte_order  = BYTE_ORDER_MARK;
+
+        if (fwrite(&hdr, sizeof(hdr), 1, file) != 1)
+        {
+            gu_throw_error(errno) << "Failed to write trace header";
+        }
+
+        ret = registry().dump(file);
+    }
+    catch (...)
+    {
+        fclose(file);
+        throw;
+    }
+
+    if (fclose(file))
+    {
+        gu_throw_error(errno) << "Failed to close '" << path << "'";
+    }
+
+    return ret;
+}
+
+const char*
+galera::trx_trace::event_str(int const ev)
+{
+    static const char* const str[EV_MAX] =
+    {
+        "NONE", "STATE", "MON_WAIT", "MON_ENTER", "MON_LEAVE", "MON_CANCEL",
+        "GCS_SEND", "GCS_REPL", "GCS_RECV"
+    };
+
+    return (ev >= 0 && ev < EV_MAX) ? str[ev] : "UNKNOWN";
+}
+
+const char*
+galera::trx_trace::monitor_str(int const mon)
+{
+    static const char* const str[MON_MAX] =
+    {
+        "none", "local", "apply", "commit"
+    };
+
+    return (mon >= 0 && mon < MON_MAX) ? str[mon] : "unknown";
+}
@@ -0,0 +1,114 @@
+//
+// Copyright (C) 2018 Codership Oy <info@codership.com>
+//
+
+//! @file trx_trace.hpp
+//
+// @brief Binary tracing of writeset lifecycle events.
+//
+// Every thread writes fixed size records into its own ring buffer, so
+// recording is lock-free and costs a timestamp and a few stores. Rings
+// keep the last debug.trace_ring_size events per thread and are written to
+// a file on demand (debug.trace_dump), which can be read by
+// galera_trace_decode.
+//
+// Tracing is off by default (debug.trace). When off, recording is a single
+// predictable branch.
+//
+
+#ifndef GALERA_TRX_TRACE_HPP
+#define GALERA_TRX_TRACE_HPP
+
+#include <gu_atomic.hpp>
+#include <gu_macros.h>
+
+#include <string>
+#include <stdint.h>
+
+namespace galera
+{
+    namespace trx_trace
+    {
+        enum Event
+        {
+            EV_NONE = 0,
+            EV_STATE,      // TrxHandle state change, arg: new state
+            EV_MON_WAIT,   // started to wait for monitor, arg: Monitor
+            EV_MON_ENTER,  // entered monitor, arg: Monitor
+            EV_MON_LEAVE,  // left monitor, arg: Monitor
+            EV_MON_CANCEL, // self-cancelled in monitor, arg: Monitor
+            EV_GCS_SEND,   // local writeset handed to GCS, arg: 1 if priority
+            EV_GCS_REPL,   // local writeset delivered back from GCS
+            EV_GCS_RECV,   // remote writeset received from GCS
+            EV_MAX
+        };
+
+        enum Monitor
+        {
+            MON_NONE = 0,
+            MON_LOCAL,
+            MON_APPLY,
+            MON_COMMIT,
+            MON_MAX
+        };
+
+        /* on-disk record, native byte order */
+        struct Record
+        {
+            int64_t  ts;     // monotonic clock, ns
+            int64_t  seqno;  // global seqno, local seqno for MON_LOCAL
+            uint64_t trx_id;
+            uint32_t tid;    // kernel thread id
+            uint16_t event;
+            uint16_t arg;
+        };
+
+        /* dump file header */
+        struct Header
+        {
+            char     magic[8];
+            uint32_t record_size;
+            uint32_t byte_order; // BYTE_ORDER_MARK in writer's byte order
+        };
+
+        static const char     MAGIC[8] = { 'G','A','L','T','R','C','0','1' };
+        static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+        static const size_t   RING_SIZE_DEFAULT = (1 << 12); // 128K
+
+        extern gu::Atomic<int> enabled_;
+
+        void enable(bool val);
+
+        /*!
+         * Sets the number of records per thread ring, rounded up to a power
+         * of 2. Takes effect for rings acquired after the call, rings of
+         * exited threads which don't match the new size are freed.
+         *
+         * @throws gu::Exception if size is 0 or unreasonably large
+         */
+        void ring_size(size_t size);
+
+        size_t ring_size();
+
+        void record_(Event ev, int64_t seqno, uint64_t trx_id, int arg);
+
+        inline void record(Event ev, int64_t seqno, uint64_t trx_id, int arg)
+        {
+            if (gu_unlikely(enabled_())) record_(ev, seqno, trx_id, arg);
+        }
+
+        /*!
+         * Writes the contents of all ring buffers to file. Records which
+         * are being overwritten concurrently may come out garbled.
+         *
+         * @return number of records written
+         * @throws gu::Exception on failure
+         */
+        size_t dump(const std::string& path);
+
+        const char* event_str(int ev);
+        const char* monitor_str(int mon);
+    }
+}
+
+#endif // GALERA_TRX_TRACE_HPP
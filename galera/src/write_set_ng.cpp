@@ -232,68 +232,78 @@ WriteSetIn::init (ssize_t const st)
     }
     else /* checksum skipped, pretend it's alright */
     {
+        gu_trace(init_sets(false));
         check_ = true;
     }
 }
 
 
 void
-WriteSetIn::checksum()
+WriteSetIn::init_sets(bool const verify)
 {
     const gu::byte_t* pptr (header_.payload());
     ssize_t           psize(size_ - header_.size());
 
     assert (psize >= 0);
 
-    try
+    if (keys_.size() > 0)
     {
-        if (keys_.size() > 0)
-        {
-            gu_trace(keys_.checksum());
-            size_t const tmpsize(keys_.serial_size());
-            psize -= tmpsize;
-            pptr  += tmpsize;
-            assert (psize >= 0);
-        }
+        if (verify) gu_trace(keys_.checksum());
+        size_t const tmpsize(keys_.serial_size());
+        psize -= tmpsize;
+        pptr  += tmpsize;
+        assert (psize >= 0);
+    }
 
-        DataSet::Version const dver(header_.dataset_ver());
+    DataSet::Version const dver(header_.dataset_ver());
 
-        if (gu_likely(dver != DataSet::EMPTY))
+    if (gu_likely(dver != DataSet::EMPTY))
+    {
+        assert (psize > 0);
+        gu_trace(data_.init(dver, pptr, psize));
+        if (verify) gu_trace(data_.checksum());
+        size_t const tmpsize(data_.serial_size());
+        psize -= tmpsize;
+        pptr  += tmpsize;
+        assert (psize >= 0);
+
+        if (header_.has_unrd())
         {
-            assert (psize > 0);
-            gu_trace(data_.init(dver, pptr, psize));
-            gu_trace(data_.checksum());
-            size_t const tmpsize(data_.serial_size());
+            gu_trace(unrd_.init(dver, pptr, psize));
+            if (verify) gu_trace(unrd_.checksum());
+            size_t const tmpsize(unrd_.serial_size());
             psize -= tmpsize;
             pptr  += tmpsize;
             assert (psize >= 0);
+        }
 
-            if (header_.has_unrd())
-            {
-                gu_trace(unrd_.init(dver, pptr, psize));
-                gu_trace(unrd_.checksum());
-                size_t const tmpsize(unrd_.serial_size());
-                psize -= tmpsize;
-                pptr  += tmpsize;
-                assert (psize >= 0);
-            }
-
-            if (header_.has_annt())
-            {
-                annt_ = new DataSetIn();
-                gu_trace(annt_->init(dver, pptr, psize));
-                // we don't care for annotation checksum - it is not a reason
-                // to throw an exception and abort execution
-                // gu_trace(annt_->checksum());
+        if (header_.has_annt())
+        {
+            annt_ = new DataSetIn();
+            gu_trace(annt_->init(dver, pptr, psize));
+            // we don't care for annotation checksum - it is not a reason
+            // to throw an exception and abort execution
+            // gu_trace(annt_->checksum());
 #ifndef NDEBUG
-                psize -= annt_->serial_size();
+            psize -= annt_->serial_size();
 #endif
-            }
         }
+    }
 #ifndef NDEBUG
-        assert (psize >= 0);
-        assert (size_t(psize) < gcache::MemOps::ALIGNMENT);
+    assert (psize >= 0);
+    assert (size_t(psize) < gcache::MemOps::ALIGNMENT);
 #endif
+}
+
+
+void
+WriteSetIn::checksum(bool const preload)
+{
+    try
+    {
+        gu_trace(init_sets(true));
+        /* in background thread this overlaps unpacking with certification */
+        if (preload) gu_trace(data_.preload());
         check_ = true;
     }
     catch (std::exception& e)
@@ -358,12 +368,8 @@ WriteSetIn::gather(GatherVector& out,
             ret += buf.size;
         }
 
-        if (annotated())
-        {
-            buf = annt_->buf();
-            out->push_back (buf);
-            ret += buf.size;
-        }
+        /* header copy has annotation flag cleared, so annotation is not
+         * included either */
 
         return ret;
     }
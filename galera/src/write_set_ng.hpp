@@ -196,12 +196,12 @@ namespace galera
             {}
 
             /* for late WriteSetIn initialization */
-            void read_buf (const gu::Buf& buf)
+            void read_buf (const gu::Buf& buf, bool const verify = true)
             {
                 ver_ = version(buf);
                 ptr_ = static_cast<gu::byte_t*>(const_cast<void*>(buf.ptr));
                 size_ = check_size (ver_, ptr_, buf.size);
-                Checksum::verify(ver_, ptr_, size_);
+                if (verify) Checksum::verify(ver_, ptr_, size_);
             }
 
             Version           version() const { return ver_;  }
@@ -490,8 +490,8 @@ namespace galera
                      uint16_t                flags    = 0,
                      gu::RecordSet::Version  rsv      = gu::RecordSet::VER2,
                      WriteSetNG::Version     ver      = WriteSetNG::MAX_VERSION,
-                     DataSet::Version        dver     = DataSet::MAX_VERSION,
-                     DataSet::Version        uver     = DataSet::MAX_VERSION,
+                     DataSet::Version        dver     = DataSet::VER1,
+                     DataSet::Version        uver     = DataSet::VER1,
                      size_t                  max_size = WriteSetNG::MAX_SIZE)
             :
             header_(ver),
@@ -524,6 +524,12 @@ namespace galera
             left_ -= keys_.append(k);
         }
 
+        void append_keys(const wsrep_key_t* keys, size_t keys_num,
+                         wsrep_key_type_t type, bool copy)
+        {
+            left_ -= keys_.append(keys, keys_num, type, copy);
+        }
+
         void append_data(const void* data, size_t data_len, bool store)
         {
             left_ -= data_.append(data, data_len, store);
@@ -538,7 +544,7 @@ namespace galera
         {
             if (NULL == annt_)
             {
-                annt_ = new DataSetOut(NULL, 0, abn_, DataSet::MAX_VERSION,
+                annt_ = new DataSetOut(NULL, 0, abn_, data_.format(),
                                        // use the same version as the dataset
                                        data_.gu::RecordSet::version());
                 left_ -= annt_->size();
@@ -719,6 +725,22 @@ namespace galera
             read_buf (tmp);
         }
 
+        /* For a writeset replicated by this node: buffer is a copy of what
+         * WriteSetOut has just gathered, so header and payload checksums
+         * are not verified. */
+        void read_local_buf (const gu::byte_t* const ptr, ssize_t const len)
+        {
+            assert (ptr != NULL);
+            assert (len >= 0);
+            assert (0 == size_);
+            assert (false == check_);
+
+            gu::Buf tmp = { ptr, len };
+            header_.read_buf (tmp, false);
+            size_ = len;
+            gu_trace(init(0));
+        }
+
         ~WriteSetIn ()
         {
             if (gu_unlikely(check_thr_))
@@ -806,7 +828,13 @@ namespace galera
 
         static size_t const SIZE_THRESHOLD = 1 << 22; /* 4Mb */
 
-        void checksum (); /* checksums writeset, stores result in check_ */
+        /* checksums writeset, stores result in check_; optionally unpacks
+         * data set so that applier does not have to */
+        void checksum (bool preload = false);
+
+        /* initializes data, unordered and annotation sets which follow
+         * the keys, optionally verifying checksums on the way */
+        void init_sets (bool verify);
 
         void checksum_fin() const
         {
@@ -826,7 +854,7 @@ namespace galera
 #endif /* HAVE_PSI_INTERFACE */
 
             WriteSetIn* ws(reinterpret_cast<WriteSetIn*>(arg));
-            ws->checksum();
+            ws->checksum(true);
 
 #ifdef HAVE_PSI_INTERFACE
             pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
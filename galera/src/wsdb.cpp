@@ -32,7 +32,9 @@ void galera::Wsdb::print(std::ostream& os) const
 
 galera::Wsdb::Wsdb()
     :
-    trx_pool_  (TrxHandle::LOCAL_STORAGE_SIZE(), 512, "LocalTrxHandle"),
+    // small per-thread caches: buffers are large and there may be many
+    // client threads
+    trx_pool_  (TrxHandle::LOCAL_STORAGE_SIZE(), 512, "LocalTrxHandle", 4),
     trx_map_     (),
     conn_trx_map_(),
 #ifdef HAVE_PSI_INTERFACE
@@ -5,6 +5,7 @@
 #include "wsrep_params.hpp"
 #include "gu_dbug.h"
 #include "gu_debug_sync.hpp"
+#include "trx_trace.hpp"
 
 void
 wsrep_set_params (galera::Replicator& repl, const char* params)
@@ -33,6 +34,25 @@ wsrep_set_params (galera::Replicator& repl, const char* params)
                     gu_conf_debug_off();
                 }
             }
+            else if (key == galera::Replicator::Param::debug_trace)
+            {
+                galera::trx_trace::enable(gu::from_string<bool>(value));
+            }
+            else if (key == galera::Replicator::Param::debug_trace_ring_size)
+            {
+                galera::trx_trace::ring_size(gu::from_string<size_t>(value));
+            }
+            else if (key == galera::Replicator::Param::debug_trace_dump)
+            {
+                size_t const n(galera::trx_trace::dump(value));
+                log_info << "Dumped " << n << " trace records to '"
+                         << value << '\'';
+            }
+            else if (key == galera::Replicator::Param::debug_log_async)
+            {
+                int const err(gu_conf_log_async(gu::from_string<long>(value)));
+                if (err) gu_throw_error(-err) << "Failed to set async logging";
+            }
 #ifdef GU_DBUG_ON
             else if (key == galera::Replicator::Param::dbug)
             {
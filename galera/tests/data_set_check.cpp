@@ -104,7 +104,8 @@ private:
 };
 
 
-static void test_ver(gu::RecordSet::Version const rsv)
+static void test_ver(gu::RecordSet::Version const rsv,
+                     DataSet::Version const       dsv = DataSet::VER1)
 {
     int const alignment
         (rsv >= gu::RecordSet::VER2 ? gu::RecordSet::VER2_ALIGNMENT : 1);
@@ -128,8 +129,7 @@ static void test_ver(gu::RecordSet::Version const rsv)
 
     union { gu::byte_t buf[1024]; gu_word_t align; } reserved;
     TestBaseName str("data_set_test");
-    DataSetOut dset_out(reserved.buf, sizeof(reserved.buf), str, DataSet::VER1,
-                        rsv);
+    DataSetOut dset_out(reserved.buf, sizeof(reserved.buf), str, dsv, rsv);
 
     size_t offset(dset_out.size());
 
@@ -174,11 +174,21 @@ static void test_ver(gu::RecordSet::Version const rsv)
     fail_if(out_size % alignment, "out size %zu not aligned by %d",
             out_size,  alignment);
 
-    fail_if (out_size <= min_out_size || out_size > offset);
-    fail_if (out_bufs->size() > size_t(dset_out.page_count()) ||
-             out_bufs->size() < size_t(dset_out.page_count() - padding_page),
-             "Expected %zu buffers, got: %zd",
-             dset_out.page_count(), out_bufs->size());
+    if (DataSet::VER2 == dsv)
+    {
+        // records are mostly zeroes
+        fail_if (out_size >= min_out_size, "out size %zu not compressed",
+                 out_size);
+    }
+    else
+    {
+        fail_if (out_size <= min_out_size || out_size > offset);
+        fail_if (out_bufs->size() > size_t(dset_out.page_count()) ||
+                 out_bufs->size() <
+                 size_t(dset_out.page_count() - padding_page),
+                 "Expected %zu buffers, got: %zd",
+                 dset_out.page_count(), out_bufs->size());
+    }
 
     /* concatenate all buffers into one */
     std::vector<gu::byte_t> in_buf;
@@ -212,7 +222,8 @@ static void test_ver(gu::RecordSet::Version const rsv)
     galera::DataSetIn const dset_in(dset_out.version(),
                                     in_buf.data(), in_buf.size());
 
-    fail_if (dset_in.size()  != dset_out.size());
+    if (DataSet::VER1 == dsv) fail_if (dset_in.size() != dset_out.size());
+    fail_if (dset_in.serial_size() != out_size);
     fail_if (dset_in.count() != dset_out.count());
     try { dset_in.checksum(); }
     catch(gu::Exception& e) { fail(e.what()); }
@@ -225,10 +236,19 @@ static void test_ver(gu::RecordSet::Version const rsv)
                  i, records[i]->c_str(), rin.c_str());
     }
 
+    dset_in.rewind();
+
+    for (ssize_t i = 0; i < dset_in.count(); ++i)
+    {
+        gu::Buf data = dset_in.next();
+        TestRecord const rin(data.ptr, data.size);
+        fail_if (rin != *records[i], "Record %d failed after rewind", i);
+    }
+
     galera::DataSetIn dset_in_empty;
     dset_in_empty.init(dset_out.version(), in_buf.data(), in_buf.size());
 
-    fail_if (dset_in_empty.size()  != dset_out.size());
+    fail_if (dset_in_empty.serial_size() != out_size);
     fail_if (dset_in_empty.count() != dset_out.count());
 
     for (ssize_t i = 0; i < dset_in_empty.count(); ++i)
@@ -252,11 +272,57 @@ START_TEST (ver2)
 }
 END_TEST
 
+START_TEST (ver2_packed)
+{
+    test_ver(gu::RecordSet::VER2, DataSet::VER2);
+}
+END_TEST
+
+/* too small to be compressed, must be stored as is */
+START_TEST (ver2_stored)
+{
+    TestRecord rout(64, "stored");
+
+    union { gu::byte_t buf[1024]; gu_word_t align; } reserved;
+    TestBaseName str("data_set_test");
+    DataSetOut dset_out(reserved.buf, sizeof(reserved.buf), str,
+                        DataSet::VER2, gu::RecordSet::VER2);
+
+    dset_out.append (rout.buf(), rout.serial_size(), true);
+
+    DataSetOut::GatherVector out_bufs;
+    size_t const out_size (dset_out.gather (out_bufs));
+    fail_if (out_size <= dset_out.size(), "out size: %zu, set size: %zu",
+             out_size, dset_out.size());
+
+    std::vector<gu::byte_t> in_buf;
+    for (size_t i = 0; i < out_bufs->size(); ++i)
+    {
+        const gu::byte_t* ptr
+            (reinterpret_cast<const gu::byte_t*>(out_bufs[i].ptr));
+        in_buf.insert (in_buf.end(), ptr, ptr + out_bufs[i].size);
+    }
+    fail_if (in_buf.size() != out_size);
+
+    galera::DataSetIn const dset_in(dset_out.version(),
+                                    in_buf.data(), in_buf.size());
+    try { dset_in.checksum(); }
+    catch(gu::Exception& e) { fail(e.what()); }
+
+    fail_if (1 != dset_in.count());
+    gu::Buf data = dset_in.next();
+    TestRecord const rin(data.ptr, data.size);
+    fail_if (rin != rout, "expected %s, found %s", rout.c_str(), rin.c_str());
+}
+END_TEST
+
 Suite* data_set_suite ()
 {
     TCase* t = tcase_create ("DataSet");
     tcase_add_test (t, ver1);
     tcase_add_test (t, ver2);
+    tcase_add_test (t, ver2_packed);
+    tcase_add_test (t, ver2_stored);
     tcase_set_timeout(t, 60);
 
     Suite* s = suite_create ("DataSet");
@@ -30,7 +30,12 @@ static const char* Defaults[] =
     "base_port",                   "4567",
     "cert.log_conflicts",          "no",
     "cert.optimistic_pa",          "yes",
+    "cert.purge_batch",            "1024",
     "debug",                       "no",
+    "debug.log_async",             "0",
+    "debug.trace",                 "no",
+    "debug.trace_dump",            "",
+    "debug.trace_ring_size",       "4096",
 #ifndef NDEBUG
     "dbug",                        "",
 #endif
@@ -51,6 +56,7 @@ static const char* Defaults[] =
     "evs.suspect_timeout",         "PT5S",
     "evs.use_aggregate",           "true",
     "evs.user_send_window",        "4",
+    "evs.user_send_window_auto",   "false",
     "evs.version",                 "0",
     "evs.view_forget_timeout",     "P1D",
 #ifndef NDEBUG
@@ -58,10 +64,12 @@ static const char* Defaults[] =
 #endif
     "gcache.dir",                  ".",
     "gcache.freeze_purge_at_seqno","-1",
+    "gcache.huge_pages",           "no",
     "gcache.keep_pages_size",      "0",
     "gcache.keep_pages_count",     "0",
     "gcache.mem_size",             "0",
     "gcache.name",                 "./galera.cache",
+    "gcache.numa_node",            "-1",
     "gcache.page_size",            "128M",
     "gcache.recover",              "no",
     "gcache.size",                 "128M",
@@ -70,6 +78,7 @@ static const char* Defaults[] =
     "gcs.fc_factor",               "1",
     "gcs.fc_limit",                "100",
     "gcs.fc_master_slave",         "no",
+    "gcs.fc_size_limit",           "0",
     "gcs.max_packet_size",         "64500",
     "gcs.max_throttle",            "0.25",
 #if (GU_WORDSIZE == 32)
@@ -84,6 +93,7 @@ static const char* Defaults[] =
     "gmcast.mcast_ttl",            "1",
     "gmcast.peer_timeout",         "PT3S",
     "gmcast.segment",              "0",
+    "gmcast.segment_fanout",       "0",
     "gmcast.time_wait",            "PT5S",
     "gmcast.version",              "0",
 //  "ist.recv_addr",               no default,
@@ -100,15 +110,21 @@ static const char* Defaults[] =
     "pc.weight",                   "1",
     "protonet.backend",            "asio",
     "protonet.version",            "0",
+    "repl.apply_order",            "0",
     "repl.causal_read_timeout",    "PT30S",
     "repl.commit_order",           "3",
+    "repl.data_compression",       "no",
     "repl.key_format",             "FLAT8",
     "repl.max_ws_size",            "2147483647",
-    "repl.proto_max",              "9",
+    "repl.priority_ws_size",       "0",
+    "repl.proto_max",              "10",
+    "repl.ws_heap_limit",          "0",
+    "repl.ws_spill_pool",          "128M",
 #ifndef NDEBUG
     "signal",                      "",
 #endif
     "socket.checksum",             "2",
+    "socket.io_threads",           "0",
     "socket.recv_buf_size",        "212992",
 //  "socket.ssl",                  no default,
 //  "socket.ssl_cert",             no default,
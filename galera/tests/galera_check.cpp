@@ -18,8 +18,10 @@ extern Suite* write_set_ng_suite();
 extern Suite* write_set_suite();
 extern Suite* trx_handle_suite();
 extern Suite* service_thd_suite();
+extern Suite* monitor_suite();
 extern Suite* ist_suite();
 extern Suite* saved_state_suite();
+extern Suite* trx_trace_suite();
 extern Suite* defaults_suite();
 
 static suite_creator_t suites[] =
@@ -30,8 +32,10 @@ static suite_creator_t suites[] =
     write_set_suite,
     trx_handle_suite,
     service_thd_suite,
+    monitor_suite,
     ist_suite,
     saved_state_suite,
+    trx_trace_suite,
     defaults_suite,
     0
 };
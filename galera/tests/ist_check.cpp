@@ -73,11 +73,13 @@ public:
     void lock() { }
     void unlock() { }
     wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
+    wsrep_trx_id_t trx_id() const { return trx_.trx_id(); }
     bool condition(wsrep_seqno_t last_entered,
                    wsrep_seqno_t last_left) const
     {
         return (last_left >= trx_.depends_seqno());
     }
+    const galera::TrxHandle::Dependencies* dependencies() const { return 0; }
 #ifdef GU_DBUG_ON
     void debug_sync(gu::Mutex&) { }
 #endif // GU_DBUG_ON
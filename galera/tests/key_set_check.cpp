@@ -10,6 +10,7 @@
 
 #include "gu_logger.hpp"
 #include "gu_hexdump.hpp"
+#include "gu_utils.hpp"
 
 #include <check.h>
 
@@ -318,12 +319,96 @@ START_TEST (ver2_4)
 }
 END_TEST
 
+static void gather_key_set(KeySetOut& kso, std::vector<gu::byte_t>& in)
+{
+    KeySetOut::GatherVector out;
+    out->reserve(kso.page_count());
+    size_t const out_size(kso.gather(out));
+
+    in.reserve(out_size);
+    for (size_t i(0); i < out->size(); ++i)
+    {
+        const gu::byte_t* ptr(reinterpret_cast<const gu::byte_t*>(out[i].ptr));
+        in.insert (in.end(), ptr, ptr + out[i].size);
+    }
+}
+
+/* bulk append must produce exactly the same key set as appending keys
+ * one by one */
+START_TEST (bulk)
+{
+    gu::RecordSet::Version const rsv(gu::RecordSet::VER2);
+    KeySet::Version const tk_ver(KeySet::FLAT16A);
+    int const ws_ver(4);
+
+    size_t const keys_num(203);
+    std::vector<std::string> rows;
+    rows.reserve(keys_num);
+    for (size_t i(0); i < keys_num; ++i)
+    {
+        size_t const k(i % 150); /* some duplicates */
+        rows.push_back(std::string(k % 37 + 1, 'a' + k % 26) +
+                       gu::to_string(k));
+    }
+
+    const char db[] = "db";
+    const char t1[] = "table1";
+    const char t2[] = "t2";
+
+    std::vector<wsrep_buf_t> parts(keys_num * 3);
+    std::vector<wsrep_key_t> keys(keys_num);
+    for (size_t i(0); i < keys_num; ++i)
+    {
+        wsrep_buf_t* const p(&parts[i * 3]);
+        p[0].ptr = db;
+        p[0].len = sizeof(db);
+        p[1].ptr = (i % 50 < 45) ? t1 : t2;
+        p[1].len = (i % 50 < 45) ? sizeof(t1) : sizeof(t2);
+        p[2].ptr = rows[i].data();
+        p[2].len = rows[i].length();
+        keys[i].key_parts     = p;
+        keys[i].key_parts_num = 3;
+    }
+
+    TestBaseName const str("key_set_bulk_test");
+
+    union { gu::byte_t buf[1024]; gu_word_t align; } r1;
+    KeySetOut kso1 (r1.buf, sizeof(r1.buf), str, tk_ver, rsv, ws_ver);
+    size_t s1(0);
+    for (size_t i(0); i < keys_num; ++i)
+    {
+        KeyData const kd(0, keys[i].key_parts, keys[i].key_parts_num,
+                         WSREP_KEY_EXCLUSIVE, true);
+        s1 += kso1.append(kd);
+    }
+
+    union { gu::byte_t buf[1024]; gu_word_t align; } r2;
+    KeySetOut kso2 (r2.buf, sizeof(r2.buf), str, tk_ver, rsv, ws_ver);
+    size_t s2(0);
+    /* uneven batches to exercise partial lanes */
+    s2 += kso2.append(&keys[0], 1, WSREP_KEY_EXCLUSIVE, true);
+    s2 += kso2.append(&keys[1], 6, WSREP_KEY_EXCLUSIVE, true);
+    s2 += kso2.append(&keys[7], keys_num - 7, WSREP_KEY_EXCLUSIVE, true);
+
+    fail_if (s1 != s2, "appended: %zu, expected: %zu", s2, s1);
+    fail_if (kso1.count() != kso2.count(), "key count: %d, expected: %d",
+             kso2.count(), kso1.count());
+
+    std::vector<gu::byte_t> in1, in2;
+    gather_key_set(kso1, in1);
+    gather_key_set(kso2, in2);
+
+    fail_if (in1 != in2, "bulk key set differs from sequential one");
+}
+END_TEST
+
 Suite* key_set_suite ()
 {
     TCase* t = tcase_create ("KeySet");
     tcase_add_test (t, ver1_3);
     tcase_add_test (t, ver2_3);
     tcase_add_test (t, ver2_4);
+    tcase_add_test (t, bulk);
     tcase_set_timeout(t, 60);
 
     Suite* s = suite_create ("KeySet");
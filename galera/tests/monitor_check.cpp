@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ */
+
+#include "../src/monitor.hpp"
+
+#include <gu_threads.h>
+
+#include <check.h>
+#include <unistd.h>
+
+namespace
+{
+    class TestOrder
+    {
+    public:
+        TestOrder(wsrep_seqno_t seqno, wsrep_seqno_t depends_seqno)
+            :
+            seqno_        (seqno),
+            depends_seqno_(depends_seqno),
+            deps_         ()
+        { }
+
+        void lock()   { }
+        void unlock() { }
+        wsrep_seqno_t seqno() const { return seqno_; }
+        wsrep_trx_id_t trx_id() const { return 0; }
+        bool condition(wsrep_seqno_t last_entered,
+                       wsrep_seqno_t last_left) const
+        {
+            return (last_left >= depends_seqno_);
+        }
+        const galera::TrxHandle::Dependencies* dependencies() const
+        {
+            return &deps_;
+        }
+#ifdef GU_DBUG_ON
+        void debug_sync(gu::Mutex&) { }
+#endif // GU_DBUG_ON
+
+        galera::TrxHandle::Dependencies& deps() { return deps_; }
+
+    private:
+        wsrep_seqno_t const             seqno_;
+        wsrep_seqno_t const             depends_seqno_;
+        galera::TrxHandle::Dependencies deps_;
+    };
+
+    typedef galera::Monitor<TestOrder> TestMonitor;
+
+    struct EnterArgs
+    {
+        TestMonitor&     monitor_;
+        TestOrder&       obj_;
+        gu::Atomic<int>  entered_;
+
+        EnterArgs(TestMonitor& monitor, TestOrder& obj)
+            : monitor_(monitor), obj_(obj), entered_(0) { }
+    };
+
+    void* enter_thd(void* arg)
+    {
+        EnterArgs* const args(static_cast<EnterArgs*>(arg));
+        args->monitor_.enter(args->obj_);
+        args->entered_.add_and_fetch(1);
+        return 0;
+    }
+}
+
+START_TEST(test_monitor_dependency_order)
+{
+#ifdef HAVE_PSI_INTERFACE
+    TestMonitor mon(WSREP_PFS_INSTR_TAG_APPLY_MONITOR_MUTEX,
+                    WSREP_PFS_INSTR_TAG_APPLY_MONITOR_CONDVAR);
+#else
+    TestMonitor mon;
+#endif /* HAVE_PSI_INTERFACE */
+
+    mon.set_initial_position(0);
+    mon.set_dependency_order(true);
+
+    // 2 is unrelated to 3 and 4 but it is below their watermark
+    TestOrder o1(1, 0), o2(2, 0), o3(3, 2), o4(4, 3);
+    o1.deps().reset(0);
+    o2.deps().reset(0);
+    o3.deps().reset(0);
+    o3.deps().add(1);
+    o4.deps().reset(0);
+    o4.deps().add(2);
+
+    mon.enter(o1);
+    mon.enter(o2);
+    mon.leave(o1);
+
+    // all dependencies of 3 have left, must not block behind 2
+    mon.enter(o3);
+    mon.leave(o3);
+    fail_unless(mon.last_left() == 1);
+
+    EnterArgs args(mon, o4);
+    gu_thread_t thd;
+    fail_if(gu_thread_create(&thd, 0, enter_thd, &args) != 0);
+
+    usleep(100000);
+    fail_unless(args.entered_() == 0, "4 entered before 2 left");
+
+    mon.leave(o2);
+    gu_thread_join(thd, 0);
+    fail_unless(args.entered_() == 1);
+    fail_unless(mon.last_left() == 3);
+
+    mon.leave(o4);
+    fail_unless(mon.last_left() == 4);
+}
+END_TEST
+
+Suite* monitor_suite()
+{
+    Suite* s = suite_create("monitor");
+    TCase* tc;
+
+    tc = tcase_create("test_monitor_dependency_order");
+    tcase_add_test(tc, test_monitor_dependency_order);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
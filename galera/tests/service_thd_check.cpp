@@ -129,6 +129,48 @@ START_TEST(service_thd3)
 }
 END_TEST
 
+namespace
+{
+    class TestPurger : public galera::ServiceThd::Purger
+    {
+    public:
+        TestPurger() : calls_(0), seqno_(0) {}
+        void purge_upto(gcs_seqno_t seqno) { ++calls_; seqno_ = seqno; }
+        int         calls_;
+        gcs_seqno_t seqno_;
+    };
+}
+
+START_TEST(service_thd4)
+{
+    TestEnv env;
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    fail_if (thd == 0);
+
+    TestPurger purger;
+
+    thd->purge(purger, 5);
+    thd->flush();
+    WAIT_FOR(purger.calls_ == 1);
+    fail_if (purger.calls_ != 1);
+    fail_if (purger.seqno_ != 5, "seqno = %" PRId64, purger.seqno_);
+
+    // completed purge is not delivered again
+    thd->report_last_committed(1);
+    thd->flush();
+    fail_if (purger.calls_ != 1);
+
+    // lower seqno after completed purge is delivered as is
+    thd->purge(purger, 3);
+    thd->flush();
+    WAIT_FOR(purger.calls_ == 2);
+    fail_if (purger.calls_ != 2);
+    fail_if (purger.seqno_ != 3, "seqno = %" PRId64, purger.seqno_);
+
+    delete thd;
+}
+END_TEST
+
 Suite* service_thd_suite()
 {
     Suite* s = suite_create ("service_thd");
@@ -138,6 +180,7 @@ Suite* service_thd_suite()
     tcase_add_test  (tc, service_thd1);
     tcase_add_test  (tc, service_thd2);
     tcase_add_test  (tc, service_thd3);
+    tcase_add_test  (tc, service_thd4);
     suite_add_tcase (s, tc);
 
     return s;
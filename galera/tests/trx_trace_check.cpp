@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ */
+
+#define __STDC_FORMAT_MACROS
+
+#include "../src/trx_trace.hpp"
+
+#include <gu_throw.hpp>
+#include <gu_threads.h>
+
+#include <check.h>
+
+#include <cstdio>
+#include <cstring>
+#include <inttypes.h>
+#include <unistd.h>
+
+using namespace galera;
+
+static const char* const dump_file("trx_trace_check.dump");
+
+static void*
+thread_routine (void* arg)
+{
+    long const id(reinterpret_cast<long>(arg));
+
+    for (long i(0); i < id * 100; ++i)
+    {
+        trx_trace::record(trx_trace::EV_STATE, i, id, 0);
+    }
+
+    return NULL;
+}
+
+/* reads dump file back, returns number of records for given trx id */
+static long
+count_records(uint64_t const trx_id, long& total)
+{
+    FILE* const f(fopen(dump_file, "r"));
+    fail_if(f == NULL);
+
+    trx_trace::Header hdr;
+    fail_if(fread(&hdr, sizeof(hdr), 1, f) != 1);
+    fail_if(memcmp(hdr.magic, trx_trace::MAGIC, sizeof(hdr.magic)));
+    fail_if(hdr.record_size != sizeof(trx_trace::Record));
+    fail_if(hdr.byte_order  != trx_trace::BYTE_ORDER_MARK);
+
+    long ret(0);
+    int64_t last_seqno(-1);
+    trx_trace::Record r;
+    total = 0;
+
+    while (fread(&r, sizeof(r), 1, f) == 1)
+    {
+        ++total;
+        if (r.trx_id == trx_id)
+        {
+            /* records of one thread come out in order */
+            fail_if(r.seqno != last_seqno + 1, "%" PRId64 " after %" PRId64,
+                    r.seqno, last_seqno);
+            last_seqno = r.seqno;
+            ++ret;
+        }
+    }
+
+    fclose(f);
+
+    return ret;
+}
+
+START_TEST(test_trx_trace)
+{
+    long total;
+
+    /* disabled tracing records nothing */
+    trx_trace::enable(false);
+    trx_trace::record(trx_trace::EV_STATE, 1, 1, 0);
+    trx_trace::dump(dump_file);
+    fail_if(count_records(1, total) != 0);
+
+    trx_trace::enable(true);
+
+    static const long n_threads(4);
+    gu_thread_t threads[n_threads];
+
+    for (long i(0); i < n_threads; ++i)
+    {
+        gu_thread_create(&threads[i], NULL, thread_routine,
+                         reinterpret_cast<void*>(i + 1));
+    }
+
+    for (long i(0); i < n_threads; ++i) gu_thread_join(threads[i], NULL);
+
+    size_t const n(trx_trace::dump(dump_file));
+
+    for (long i(0); i < n_threads; ++i)
+    {
+        fail_if(count_records(i + 1, total) != (i + 1) * 100);
+    }
+
+    fail_if(size_t(total) != n);
+
+    /* ring size is rounded up to power of 2, applies to new rings and
+     * frees the rings of exited threads */
+    fail_if(trx_trace::ring_size() != trx_trace::RING_SIZE_DEFAULT);
+    try { trx_trace::ring_size(0); fail("size 0 accepted"); }
+    catch (gu::Exception& e) { fail_if(e.get_errno() != EINVAL); }
+    trx_trace::ring_size(1000);
+    size_t const ring_size(trx_trace::ring_size());
+    fail_if(ring_size != 1024, "%zu", ring_size);
+    trx_trace::dump(dump_file);
+    fail_if(count_records(1, total) != 0);
+    fail_if(total != 0, "%ld", total);
+
+    /* ring overflow keeps the most recent records */
+    for (size_t i(0); i < ring_size + 10; ++i)
+    {
+        trx_trace::record(trx_trace::EV_STATE, i, 100, 0);
+    }
+
+    trx_trace::dump(dump_file);
+    trx_trace::enable(false);
+
+    FILE* const f(fopen(dump_file, "r"));
+    fail_if(f == NULL);
+    trx_trace::Header hdr;
+    fail_if(fread(&hdr, sizeof(hdr), 1, f) != 1);
+    trx_trace::Record r;
+    long cnt(0);
+    int64_t first(-1);
+    while (fread(&r, sizeof(r), 1, f) == 1)
+    {
+        if (r.trx_id != 100) continue;
+        if (0 == cnt) first = r.seqno;
+        ++cnt;
+    }
+    fclose(f);
+
+    fail_if(cnt != long(ring_size), "%ld", cnt);
+    fail_if(first != 10, "%" PRId64, first);
+
+    trx_trace::ring_size(trx_trace::RING_SIZE_DEFAULT);
+    ::unlink(dump_file);
+}
+END_TEST
+
+Suite* trx_trace_suite()
+{
+    Suite* s = suite_create ("trx_trace");
+    TCase* tc;
+
+    tc = tcase_create ("trx_trace");
+    tcase_add_test  (tc, test_trx_trace);
+    suite_add_tcase (s, tc);
+
+    return s;
+}
@@ -10,6 +10,7 @@
 #include "wsdb.cpp"
 #include "gcs_action_source.hpp"
 #include "galera_service_thd.hpp"
+#include "gu_debug_sync.hpp"
 
 #include <cstdlib>
 #include <check.h>
@@ -644,6 +645,140 @@ START_TEST(test_trac_726)
 END_TEST
 
 
+#ifdef GU_DBUG_ON
+
+// appends and commits trx with a unique key at seqno, last seen seqno - 1
+static void
+append_committed(Certification& cert, int const version,
+                 wsrep_seqno_t const seqno)
+{
+    galera::TrxHandle::Params const trx_params("", version,KeySet::MAX_VERSION);
+    wsrep_uuid_t uuid = {{1, }};
+    char const key_str[] = { char('0' + seqno % 10), char('0' + seqno / 10) };
+    wsrep_buf_t key = {key_str, sizeof(key_str)};
+
+    TrxHandle* trx(TrxHandle::New(lp, trx_params, uuid, 0, seqno));
+
+    trx->append_key(KeyData(version, &key, 1, WSREP_KEY_EXCLUSIVE, true));
+    trx->set_last_seen_seqno(seqno - 1);
+    trx->flush(0);
+
+    const galera::MappedBuffer& wc(trx->write_set_collection());
+    gu::Buffer buf(wc.size());
+    std::copy(&wc[0], &wc[0] + wc.size(), &buf[0]);
+    trx->unref();
+    trx = TrxHandle::New(sp);
+    size_t offset(trx->unserialize(&buf[0], buf.size(), 0));
+    trx->append_write_set(&buf[0] + offset, buf.size() - offset);
+
+    trx->set_received(0, seqno, seqno);
+    Certification::TestResult result(cert.append_trx(trx));
+    fail_unless(result == Certification::TEST_OK, "seqno %lld", seqno);
+    cert.set_trx_committed(trx);
+    trx->unref();
+}
+
+static bool
+cert_has_trx(Certification& cert, wsrep_seqno_t const seqno)
+{
+    TrxHandle* const trx(cert.get_trx(seqno));
+    if (trx) trx->unref();
+    return trx != 0;
+}
+
+static void
+wait_cert_purge_sync()
+{
+    while (gu_debug_sync_waiters() != "cert_purge_after_batch")
+    {
+        usleep(1000);
+    }
+}
+
+struct purge_ctx
+{
+    Certification& cert;
+    wsrep_seqno_t  seqno;
+
+    purge_ctx(Certification& c, wsrep_seqno_t s) : cert(c), seqno(s) {}
+};
+
+static void* purge_thread(void* arg)
+{
+    purge_ctx& ctx(*static_cast<purge_ctx*>(arg));
+    ctx.seqno = ctx.cert.purge_trxs_upto(ctx.seqno, false);
+    return NULL;
+}
+
+START_TEST(test_cert_purge_batches)
+{
+    log_info << "test_cert_purge_batches";
+
+    const int version(2);
+    TestEnv env;
+    galera::Certification cert(env.conf(), env.thd(), env.gcache());
+    cert.assign_initial_position(0, version);
+    cert.param_set(Certification::PARAM_PURGE_BATCH, "2");
+
+    for (wsrep_seqno_t s(1); s <= 5; ++s) append_committed(cert, version, s);
+
+    GU_DBUG_PUSH("d,cert_purge_after_batch");
+
+    purge_ctx ctx(cert, 4);
+    gu_thread_t thd;
+    fail_if(gu_thread_create(&thd, NULL, purge_thread, &ctx));
+
+    wait_cert_purge_sync();
+
+    // first batch is purged and certification lock is released
+    fail_if(cert_has_trx(cert, 2));
+    fail_unless(cert_has_trx(cert, 3));
+
+    GU_DBUG_POP();
+    gu_debug_sync_signal("cert_purge_after_batch");
+    gu_thread_join(thd, NULL);
+
+    fail_if(ctx.seqno != 4, "purged up to %lld", ctx.seqno);
+    fail_if(cert_has_trx(cert, 4));
+    fail_unless(cert_has_trx(cert, 5));
+}
+END_TEST
+
+START_TEST(test_cert_purge_sync)
+{
+    log_info << "test_cert_purge_sync";
+
+    const int version(2);
+    TestEnv env;
+    env.conf().set("cert.max_length", "4");
+    env.conf().set("cert.length_check", "0"); // check on every append
+    galera::Certification cert(env.conf(), env.thd(), env.gcache());
+    cert.assign_initial_position(0, version);
+    cert.param_set(Certification::PARAM_PURGE_BATCH, "1");
+
+    // stall the purge scheduled to service thread after the first batch
+    GU_DBUG_PUSH("d,cert_purge_after_batch");
+
+    for (wsrep_seqno_t s(1); s <= 6; ++s) append_committed(cert, version, s);
+
+    wait_cert_purge_sync();
+
+    // once index exceeds max_length by half, it is purged synchronously
+    for (wsrep_seqno_t s(7); s <= 20; ++s)
+    {
+        append_committed(cert, version, s);
+        fail_if(cert_has_trx(cert, s - 7), "seqno %lld", s - 7);
+    }
+
+    GU_DBUG_POP();
+    gu_debug_sync_signal("cert_purge_after_batch");
+    env.thd().flush();
+}
+END_TEST
+
+#endif /* GU_DBUG_ON */
+
+
 Suite* write_set_suite()
 {
     Suite* s = suite_create("write_set");
@@ -684,5 +819,13 @@ Suite* write_set_suite()
     tcase_set_timeout(tc, 20);
     suite_add_tcase(s, tc);
 
+#ifdef GU_DBUG_ON
+    tc = tcase_create("test_cert_purge");
+    tcase_add_test(tc, test_cert_purge_batches);
+    tcase_add_test(tc, test_cert_purge_sync);
+    tcase_set_timeout(tc, 20);
+    suite_add_tcase(s, tc);
+#endif /* GU_DBUG_ON */
+
     return s;
 }
@@ -17,7 +17,8 @@
 using namespace galera;
 
 static void ver3_basic(gu::RecordSet::Version const rsv,
-                       WriteSetNG::Version    const wsv)
+                       WriteSetNG::Version    const wsv,
+                       DataSet::Version       const dsv = DataSet::VER1)
 {
     union {
         wsrep_uuid_t source;
@@ -32,7 +33,8 @@ static void ver3_basic(gu::RecordSet::Version const rsv,
 
     std::string const dir(".");
     wsrep_trx_id_t trx_id(1);
-    WriteSetOut wso (dir, trx_id, KeySet::FLAT8A, 0, 0, flag1, rsv, wsv);
+    WriteSetOut wso (dir, trx_id, KeySet::FLAT8A, 0, 0, flag1, rsv, wsv,
+                     dsv, dsv);
 
     fail_unless (wso.is_empty());
 
@@ -225,6 +227,49 @@ static void ver3_basic(gu::RecordSet::Version const rsv,
         fail_if (e.get_errno() != EINVAL);
     }
 
+    mark_point();
+
+    /* this is to test initialization of a locally replicated writeset:
+     * checksums are skipped but all sets must be accessible */
+    {
+        WriteSetIn wsi;
+        wsi.read_local_buf(in.data(), in.size());
+        mark_point();
+        wsi.verify_checksum();
+        fail_unless(wsi.certified());
+        fail_if (wsi.seqno()           != seqno);
+        fail_if (wsi.flags()           != flags);
+        fail_if (wsi.keyset().count()  != 1);
+        fail_if (wsi.dataset().count() != 1);
+
+        wsi.dataset().rewind();
+        gu::Buf const d(wsi.dataset().next());
+        fail_if (d.size !=
+                 sizeof(data_out_volatile) + sizeof(data_out_persistent));
+
+        /* same for skipped checksum of a received one */
+        WriteSetIn wsi0;
+        wsi0.read_buf(in_buf, 0);
+        fail_if (wsi0.dataset().count() != 1);
+        fail_if (wsi0.dataset().size()  != wsi.dataset().size());
+    }
+
+    mark_point();
+
+    /* this is to test data set unpacked by background checksum thread */
+    {
+        WriteSetIn wsi(in_buf, 1);
+        mark_point();
+        wsi.verify_checksum();
+        fail_if (wsi.dataset().count() != 1);
+
+        wsi.dataset().rewind();
+        gu::Buf const d(wsi.dataset().next());
+        fail_if (d.size !=
+                 sizeof(data_out_volatile) + sizeof(data_out_persistent));
+        fail_if (*(static_cast<const uint64_t*>(d.ptr)) != data_out_volatile);
+    }
+
     in[in.size() - 1] ^= 1; // corrupted the last byte (payload)
 
     mark_point();
@@ -293,7 +338,14 @@ START_TEST (ver3_basic_rsv2_wsv4)
 }
 END_TEST
 
-static void ver3_annotation(gu::RecordSet::Version const rsv)
+START_TEST (ver3_basic_rsv2_wsv4_dsv2)
+{
+    ver3_basic(gu::RecordSet::VER2, WriteSetNG::VER4, DataSet::VER2);
+}
+END_TEST
+
+static void ver3_annotation(gu::RecordSet::Version const rsv,
+                            DataSet::Version       const dsv = DataSet::VER1)
 {
     union {
         wsrep_uuid_t source;
@@ -310,7 +362,7 @@ static void ver3_annotation(gu::RecordSet::Version const rsv)
     wsrep_trx_id_t trx_id(1);
 
     WriteSetOut wso (dir, trx_id, KeySet::FLAT16, 0, 0, flag1, rsv,
-                     WriteSetNG::VER3);
+                     WriteSetNG::VER3, dsv, dsv);
 
     fail_unless (wso.is_empty());
 
@@ -319,7 +371,8 @@ static void ver3_annotation(gu::RecordSet::Version const rsv)
     fail_if (wso.is_empty());
 
     uint64_t const data(0xaabbccdd);
-    std::string const annotation("0xaabbccdd");
+    // long enough to be compressed with DataSet::VER2
+    std::string const annotation(std::string(512, ' ') + "0xaabbccdd");
     uint16_t const flag2(0x1234);
 
     wso.append_data (&data, sizeof(data), true);
@@ -332,7 +385,8 @@ static void ver3_annotation(gu::RecordSet::Version const rsv)
 
     log_info << "Gather size: " << out_size << ", buf count: " << out->size();
     fail_if((out_size % alignment) != 0);
-    fail_if(out_size < (sizeof(data) + annotation.size()));
+    if (DataSet::VER1 == dsv)
+        fail_if(out_size < (sizeof(data) + annotation.size()));
 
     wsrep_seqno_t const last_seen(1);
     wso.set_last_seen(last_seen);
@@ -389,6 +443,12 @@ START_TEST (ver3_annotation_rsv2)
 }
 END_TEST
 
+START_TEST (ver3_annotation_rsv2_dsv2)
+{
+    ver3_annotation(gu::RecordSet::VER2, DataSet::VER2);
+}
+END_TEST
+
 Suite* write_set_ng_suite ()
 {
     Suite* s = suite_create ("WriteSet");
@@ -397,12 +457,14 @@ Suite* write_set_ng_suite ()
     tcase_add_test (t, ver3_basic_rsv1);
     tcase_add_test (t, ver3_basic_rsv2_wsv3);
     tcase_add_test (t, ver3_basic_rsv2_wsv4);
+    tcase_add_test (t, ver3_basic_rsv2_wsv4_dsv2);
     tcase_set_timeout(t, 60);
     suite_add_tcase (s, t);
 
     t = tcase_create ("WriteSet annotation");
     tcase_add_test (t, ver3_annotation_rsv1);
     tcase_add_test (t, ver3_annotation_rsv2);
+    tcase_add_test (t, ver3_annotation_rsv2_dsv2);
     tcase_set_timeout(t, 60);
     suite_add_tcase (s, t);
 
@@ -10,9 +10,173 @@
 #include "gu_assert.hpp"
 #include "gu_arch.h"
 #include "gu_limits.h"
+#include "gu_lock.hpp"
 
 #include <sstream>
 #include <iomanip> // for std::setfill() and std::setw()
+#include <vector>
+
+
+class gu::Allocator::Arena
+{
+public:
+
+    Arena()
+        :
+        mtx_          (),
+        pool_         (),
+        heap_limit_   (0),
+        heap_used_    (0),
+        pool_limit_   (size_t(1) << 27), /* 2 default file pages */
+        pooled_       (0),
+        spill_created_(0),
+        spill_reused_ (0),
+        spill_in_use_ (0)
+    {}
+
+    void configure(size_t const heap_limit, size_t const pool_limit)
+    {
+        std::vector<FilePage*> trimmed;
+
+        {
+            Lock lock(mtx_);
+
+            heap_limit_ = heap_limit;
+            pool_limit_ = pool_limit;
+
+            while (pooled_ > pool_limit_)
+            {
+                pooled_ -= pool_.back()->capacity();
+                trimmed.push_back(pool_.back());
+                pool_.pop_back();
+            }
+        }
+
+        /* unmap outside the lock */
+        for (size_t i(0); i < trimmed.size(); ++i) delete trimmed[i];
+    }
+
+    bool heap_reserve(size_t const size)
+    {
+        Lock lock(mtx_);
+
+        if (heap_limit_ > 0 && heap_used_ + size > heap_limit_) return false;
+
+        heap_used_ += size;
+        return true;
+    }
+
+    void heap_release(size_t const size)
+    {
+        Lock lock(mtx_);
+        assert(heap_used_ >= size);
+        heap_used_ -= size;
+    }
+
+    /* returns a pooled page of at least size bytes or NULL */
+    FilePage* get_file_page(size_t const size)
+    {
+        Lock lock(mtx_);
+
+        for (size_t i(pool_.size()); i > 0; --i)
+        {
+            FilePage* const ret(pool_[i - 1]);
+            size_t const    cap(ret->capacity());
+
+            if (cap >= size)
+            {
+                pool_.erase(pool_.begin() + (i - 1));
+                pooled_       -= cap;
+                spill_in_use_ += cap;
+                ++spill_reused_;
+                return ret;
+            }
+        }
+
+        return NULL;
+    }
+
+    void file_page_created(size_t const size)
+    {
+        Lock lock(mtx_);
+        spill_in_use_ += size;
+        ++spill_created_;
+    }
+
+    void put_file_page(FilePage* const page)
+    {
+        size_t const cap(page->capacity());
+
+        {
+            Lock lock(mtx_);
+
+            assert(spill_in_use_ >= cap);
+            spill_in_use_ -= cap;
+
+            if (pooled_ + cap <= pool_limit_)
+            {
+                page->unlink();
+                page->reset();
+                pool_.push_back(page);
+                pooled_ += cap;
+                return;
+            }
+        }
+
+        delete page;
+    }
+
+    void stats(ArenaStats& s) const
+    {
+        Lock lock(mtx_);
+
+        s.heap_limit    = heap_limit_;
+        s.heap_used     = heap_used_;
+        s.spill_created = spill_created_;
+        s.spill_reused  = spill_reused_;
+        s.spill_in_use  = spill_in_use_;
+        s.spill_pooled  = pooled_;
+    }
+
+private:
+
+    Mutex                  mtx_;
+    std::vector<FilePage*> pool_;
+    size_t                 heap_limit_;
+    size_t                 heap_used_;
+    size_t                 pool_limit_;
+    size_t                 pooled_;
+    size_t                 spill_created_;
+    size_t                 spill_reused_;
+    size_t                 spill_in_use_;
+
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+    ~Arena(); // never destroyed, see arena()
+};
+
+/* Arena is created on first use and intentionally never destroyed: allocators
+ * may still be released during static destruction, and pooled pages are
+ * already unlinked, so nothing is left on disk when the process exits. */
+gu::Allocator::Arena&
+gu::Allocator::arena()
+{
+    static Arena* const arena(new Arena());
+    return *arena;
+}
+
+void
+gu::Allocator::arena_configure (size_t const heap_limit,
+                                size_t const pool_limit)
+{
+    arena().configure(heap_limit, pool_limit);
+}
+
+void
+gu::Allocator::arena_stats (ArenaStats& stats)
+{
+    arena().stats(stats);
+}
 
 
 gu::Allocator::HeapPage::HeapPage (page_size_type const size) :
@@ -22,6 +186,12 @@ gu::Allocator::HeapPage::HeapPage (page_size_type const size) :
     if (0 == base_ptr_) gu_throw_error (ENOMEM);
 }
 
+gu::Allocator::HeapPage::~HeapPage ()
+{
+    arena().heap_release(capacity());
+    free (base_ptr_);
+}
+
 
 gu::Allocator::Page*
 gu::Allocator::HeapStore::my_new_page (page_size_type const size)
@@ -34,7 +204,22 @@ gu::Allocator::HeapStore::my_new_page (page_size_type const size)
         page_size_type const page_size
             (std::min(std::max(size, PAGE_SIZE), left_));
 
-        Page* ret = new HeapPage (page_size);
+        if (!arena().heap_reserve(page_size))
+        {
+            gu_throw_error (ENOMEM) << "out of memory in shared RAM pool";
+        }
+
+        Page* ret(0);
+
+        try
+        {
+            ret = new HeapPage (page_size);
+        }
+        catch (...)
+        {
+            arena().heap_release(page_size);
+            throw;
+        }
 
         assert (ret != 0);
 
@@ -56,7 +241,8 @@ gu::Allocator::FilePage::FilePage (const std::string& name,
 #else
     fd_  (name, size, false, false),
 #endif /* HAVE_PSI_INTERFACE */
-    mmap_(fd_, true)
+    mmap_(fd_, true),
+    linked_(true)
 {
     base_ptr_ = static_cast<byte_t*>(mmap_.ptr);
     assert(0 == (uintptr_t(base_ptr_) % GU_WORD_BYTES));
@@ -64,11 +250,25 @@ gu::Allocator::FilePage::FilePage (const std::string& name,
     left_     = mmap_.size;
 }
 
+void
+gu::Allocator::FilePage::release ()
+{
+    arena().put_file_page(this);
+}
+
 
 gu::Allocator::Page*
 gu::Allocator::FileStore::my_new_page (page_size_type const size)
 {
-    Page* ret = 0;
+    page_size_type const page_size(std::max(size, page_size_));
+
+    Page* ret = arena().get_file_page(page_size);
+
+    if (ret)
+    {
+        ++n_;
+        return ret;
+    }
 
     try {
         std::ostringstream fname;
@@ -76,10 +276,12 @@ gu::Allocator::FileStore::my_new_page (page_size_type const size)
         fname << base_name_
               << '.' << std::dec << std::setfill('0') << std::setw(6) << n_;
 
-        ret = new FilePage(fname.str(), std::max(size, page_size_));
+        ret = new FilePage(fname.str(), page_size);
 
         assert (ret != 0);
 
+        arena().file_page_created(ret->capacity());
+
         ++n_;
     }
     catch (std::exception& e)
@@ -203,6 +405,6 @@ gu::Allocator::~Allocator ()
          i > 0 /* don't delete first_page_ - we didn't allocate it */;
          --i)
     {
-        delete (pages_[i]);
+        pages_[i]->release();
     }
 }
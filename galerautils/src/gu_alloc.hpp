@@ -68,6 +68,26 @@ public:
      * be an issue. */
     static size_t const INITIAL_VECTOR_SIZE = 4;
 
+    /* Process-wide arena shared by all allocators: heap pages are accounted
+     * against a common budget and released file pages are kept for reuse
+     * by subsequent allocators instead of being destroyed. Pooled pages are
+     * unlinked from the file system and only keep their mapping. */
+    struct ArenaStats
+    {
+        size_t heap_limit;    // common heap budget, 0 - unlimited
+        size_t heap_used;     // heap currently held by all allocators
+        size_t spill_created; // file pages created
+        size_t spill_reused;  // file pages taken from the arena pool
+        size_t spill_in_use;  // file page bytes held by allocators
+        size_t spill_pooled;  // file page bytes kept for reuse
+    };
+
+    /*! @param heap_limit - total heap size for all allocators, 0 - unlimited
+     *  @param pool_limit - total size of released file pages kept for reuse */
+    static void arena_configure (size_t heap_limit, size_t pool_limit);
+
+    static void arena_stats (ArenaStats& stats);
+
 private:
 
     class Page /* base class for memory and file pages */
@@ -82,6 +102,9 @@ private:
 
         virtual ~Page() {};
 
+        /* hands the page back when the allocator is done with it */
+        virtual void release() { delete this; }
+
         byte_t* alloc (size_t size)
         {
             byte_t* ret = NULL;
@@ -99,6 +122,11 @@ private:
         const byte_t* base() const { return base_ptr_; }
         ssize_t       size() const { return ptr_ - base_ptr_; }
 
+        /* total page capacity, used and unused */
+        size_t        capacity() const { return size() + left_; }
+
+        void reset() { left_ += ptr_ - base_ptr_; ptr_ = base_ptr_; }
+
     protected:
 
         byte_t*        base_ptr_;
@@ -115,7 +143,7 @@ private:
 
         HeapPage (page_size_type max_size);
 
-        ~HeapPage () { free (base_ptr_); }
+        ~HeapPage ();
     };
 
     class FilePage : public Page
@@ -124,12 +152,22 @@ private:
 
         FilePage (const std::string& name, page_size_type size);
 
-        ~FilePage () { fd_.unlink(); }
+        ~FilePage () { unlink(); }
+
+        void release(); /* to arena pool */
+
+        /* Removes file name, so that another allocator with the same base
+         * name can't open this page. Mapping stays valid. */
+        void unlink()
+        {
+            if (linked_) { fd_.unlink(); linked_ = false; }
+        }
 
     private:
 
         FileDescriptor fd_;
         MMap           mmap_;
+        bool           linked_;
     };
 
     class PageStore
@@ -192,6 +230,9 @@ private:
         FileStore& operator= (const FileStore&);
     };
 
+    class Arena;
+    static Arena& arena();
+
     Page       first_page_;
     Page*      current_page_;
 
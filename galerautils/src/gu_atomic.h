@@ -58,6 +58,16 @@ extern "C" {
 #define gu_atomic_get(ptr, vptr)                        \
     __atomic_load(ptr, vptr, GU_ATOMIC_SYNC_DEFAULT)
 
+// same without memory ordering, for single-writer variables
+#define gu_atomic_set_relaxed(ptr, vptr)                \
+    __atomic_store(ptr, vptr, GU_ATOMIC_SYNC_NONE)
+#define gu_atomic_get_relaxed(ptr, vptr)                \
+    __atomic_load(ptr, vptr, GU_ATOMIC_SYNC_NONE)
+
+// if *ptr equals oldval, replaces it with newval, returns true on success
+#define gu_atomic_bool_cas(ptr, oldval, newval)         \
+    __sync_bool_compare_and_swap(ptr, oldval, newval)
+
 #elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8) // use __sync_XXX builtins
 
 #define GU_ATOMIC_SYNC_NONE    0
@@ -83,6 +93,11 @@ extern "C" {
 
 #define gu_atomic_get(ptr, vptr) *vptr = __sync_fetch_and_or(ptr, 0)
 
+#define gu_atomic_set_relaxed gu_atomic_set
+#define gu_atomic_get_relaxed gu_atomic_get
+
+#define gu_atomic_bool_cas __sync_bool_compare_and_swap
+
 #else
 #error "This GCC version does not support 8-byte atomics on this platform. Use GCC >= 4.7.x."
 #endif /* __ATOMIC_RELAXED */
@@ -34,6 +34,20 @@ namespace gu
             return *this;
         }
 
+        // no memory ordering: for variables modified by a single thread
+        // and only sampled by others
+        I load_relaxed() const
+        {
+            I i;
+            gu_atomic_get_relaxed(&i_, &i);
+            return i;
+        }
+
+        void store_relaxed(I i)
+        {
+            gu_atomic_set_relaxed(&i_, &i);
+        }
+
         I fetch_and_zero()
         {
             return gu_atomic_fetch_and_and(&i_, 0);
@@ -26,6 +26,20 @@ extern int gu_conf_self_tstamp_off  ();
 extern int gu_conf_debug_on         ();
 extern int gu_conf_debug_off        ();
 
+/**
+ * Turns asynchronous logging on (queue_len > 0) or off (queue_len == 0).
+ * In asynchronous mode messages are queued and written to log by a
+ * separate thread. If the queue is full, messages are dropped.
+ * Turning it off flushes the queue, messages logged concurrently are
+ * written synchronously.
+ *
+ * @return 0 on success, negative error code otherwise
+ */
+extern int gu_conf_log_async        (long queue_len);
+
+/** @return total number of messages dropped in asynchronous logging mode */
+extern long long gu_log_dropped     ();
+
 #ifdef __cplusplus
 }
 #endif
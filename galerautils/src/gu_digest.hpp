@@ -55,6 +55,20 @@ public:
         gu_mmh128_append (&ctx_, buf, size);
     }
 
+    static int const LANES = GU_MMH128_LANES;
+
+    /* same as h[i]->append(buf[i], size[i]) for up to LANES hashes,
+     * but mixes the blocks of all hashes in one loop */
+    static void append_lanes (MMH3* const* const         h,
+                              const void* const* const   buf,
+                              const size_t* const        size,
+                              int const                  lanes)
+    {
+        gu_mmh128_ctx_t* ctx[LANES];
+        for (int i(0); i < lanes; ++i) ctx[i] = &h[i]->ctx_;
+        gu_mmh128_append_lanes (ctx, buf, size, lanes);
+    }
+
     template <size_t size>
     int  gather (void* const buf) const
     {
@@ -8,6 +8,7 @@
 #include "gu_string_utils.hpp" // strsplit()
 
 #include <cmath>
+#include <algorithm>
 
 #include <sstream>
 #include <limits>
@@ -103,3 +104,58 @@ std::string gu::Histogram::to_string() const
     os << *this;
     return os.str();
 }
+
+long long gu::LatencyHistogram::upper_bound(int const idx)
+{
+    if (idx < SUB) return idx;
+
+    /* computed unsigned: the bound of the last buckets does not fit in
+     * long long, those are clamped to the largest sample value */
+    int const shift((idx >> SUB_BITS) - 1);
+    unsigned long long const ret(
+        (static_cast<unsigned long long>(SUB + (idx & (SUB - 1)) + 1) << shift)
+        - 1);
+    long long const max(std::numeric_limits<long long>::max());
+
+    return (ret > static_cast<unsigned long long>(max) ?
+            max : static_cast<long long>(ret));
+}
+
+long long gu::LatencyHistogram::count() const
+{
+    long long ret(0);
+    for (int i(0); i < BUCKETS; ++i) ret += cnt_[i]();
+    return ret;
+}
+
+long long gu::LatencyHistogram::percentile(double const p) const
+{
+    long long snap[BUCKETS];
+    long long total(0);
+
+    for (int i(0); i < BUCKETS; ++i)
+    {
+        snap[i] = cnt_[i]();
+        total  += snap[i];
+    }
+
+    if (0 == total) return 0;
+
+    /* rank of the sample, 1-based */
+    long long const rank(std::max(1LL, static_cast<long long>(
+                                      std::ceil(p * total))));
+    long long sum(0);
+
+    for (int i(0); i < BUCKETS; ++i)
+    {
+        sum += snap[i];
+        if (sum >= rank) return upper_bound(i);
+    }
+
+    return upper_bound(BUCKETS - 1);
+}
+
+void gu::LatencyHistogram::clear()
+{
+    for (int i(0); i < BUCKETS; ++i) cnt_[i] = 0;
+}
@@ -5,6 +5,8 @@
 #ifndef _gu_histogram_hpp_
 #define _gu_histogram_hpp_
 
+#include "gu_atomic.hpp"
+
 #include <map>
 #include <ostream>
 
@@ -23,6 +25,54 @@ namespace gu
     };
 
     std::ostream& operator<<(std::ostream&, const Histogram&);
+
+    /*!
+     * Lock-free log-linear histogram of non-negative integer samples
+     * (e.g. latencies in nanoseconds). Each power of two is split into
+     * SUB linear buckets, so relative error is within 1/SUB. Insertion is
+     * a single atomic increment and may be done from any thread.
+     */
+    class LatencyHistogram
+    {
+    public:
+
+        LatencyHistogram() : cnt_() {}
+
+        void insert(long long const val)
+        {
+            cnt_[index(val > 0 ? val : 0)] += 1;
+        }
+
+        /*! @return upper bound of the bucket holding the p-th fraction
+         *          of samples, 0 if histogram is empty. Concurrent
+         *          insertions make the result approximate. */
+        long long percentile(double p) const;
+
+        long long count() const;
+
+        void clear();
+
+    private:
+
+        static int const SUB_BITS = 3;
+        static int const SUB      = 1 << SUB_BITS;
+        static int const BUCKETS  = (64 - SUB_BITS + 1) * SUB;
+
+        static int index(unsigned long long const v)
+        {
+            if (v < static_cast<unsigned long long>(SUB)) return v;
+
+            int const shift(63 - __builtin_clzll(v) - SUB_BITS);
+            return ((shift + 1) << SUB_BITS) + int(v >> shift) - SUB;
+        }
+
+        static long long upper_bound(int idx);
+
+        LatencyHistogram(const LatencyHistogram&);
+        LatencyHistogram& operator=(const LatencyHistogram&);
+
+        gu::Atomic<long long> cnt_[BUCKETS];
+    };
 }
 
 #endif // _gu_histogram_hpp_
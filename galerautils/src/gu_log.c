@@ -13,8 +13,14 @@
 #include <time.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include "gu_log.h"
+#include "gu_conf.h"
 #include "gu_macros.h"
+#include "gu_atomic.h"
+#include "gu_time.h"
 
 /* Global configurable variables */
 static FILE*      gu_log_file        = NULL;
@@ -67,23 +73,35 @@ gu_conf_debug_off ()
     return 0;
 }
 
-/** Returns current timestamp in the provided buffer */
-static inline int
-log_tstamp (char* tstamp, size_t const len)
+/* Date and time formatting is by far the most expensive part of the
+ * timestamp, and it changes only once a second, so it is cached per thread.
+ * "YYYY-MM-DD HH:MM:SS" */
+#define GU_LOG_TSTAMP_DATE_LEN 19
+
+static __thread time_t tstamp_sec = -1;
+static __thread char   tstamp_date[GU_LOG_TSTAMP_DATE_LEN + 1];
+
+int
+gu_log_tstamp (char* tstamp, size_t const len)
 {
-    int            ret = 0;
-    struct tm      date;
     struct timeval time;
 
     gettimeofday (&time, NULL);
-    localtime_r  (&time.tv_sec, &date);
 
-    /* 23 symbols */
-    ret = snprintf (tstamp, len, "%04d-%02d-%02d %02d:%02d:%02d.%03d ",
-                    date.tm_year + 1900, date.tm_mon + 1, date.tm_mday,
-                    date.tm_hour, date.tm_min, date.tm_sec,
-                    (int)time.tv_usec / 1000);
-    return ret;
+    if (gu_unlikely(time.tv_sec != tstamp_sec)) {
+        struct tm date;
+
+        localtime_r (&time.tv_sec, &date);
+        snprintf (tstamp_date, sizeof(tstamp_date),
+                  "%04d-%02d-%02d %02d:%02d:%02d",
+                  date.tm_year + 1900, date.tm_mon + 1, date.tm_mday,
+                  date.tm_hour, date.tm_min, date.tm_sec);
+        tstamp_sec = time.tv_sec;
+    }
+
+    /* 24 symbols */
+    return snprintf (tstamp, len, "%s.%03d ", tstamp_date,
+                     (int)time.tv_usec / 1000);
 }
 
 const char* gu_log_level_str[GU_LOG_DEBUG + 2] = 
@@ -143,7 +161,7 @@ gu_log (gu_log_severity_t severity,
     int   len;
 
     if (gu_log_self_tstamp) {
-        len = log_tstamp (str, max_string);
+        len = gu_log_tstamp (str, max_string);
         str += len;
         max_string -= len;
     }
@@ -175,7 +193,370 @@ gu_log (gu_log_severity_t severity,
     }
 
     /* actual logging */
-    gu_log_cb (severity, string);
+    gu_log_dispatch (severity, string);
 
     return 0;
 }
+
+/*
+ * Asynchronous logging.
+ *
+ * Messages are copied into a bounded multi-producer single-consumer ring
+ * (D. Vyukov's bounded queue: every slot carries a sequence number which
+ * tells producers and consumer whose turn it is), and written by a
+ * dedicated thread through gu_log_cb. Producers never block: if the ring
+ * is full the message is dropped and counted. FATAL messages are always
+ * written synchronously, as the process is likely about to abort.
+ */
+
+/* messages shorter than that are copied into the slot itself */
+#define GU_LOG_ASYNC_MSG_LEN 256
+
+/* writer thread wakes up at least that often when idle */
+#define GU_LOG_ASYNC_IDLE_NS 100000000LL
+
+typedef struct gu_log_slot
+{
+    long long seq;
+    int       severity;
+    char*     ext; /* malloc'ed copy of a long message */
+    char      msg[GU_LOG_ASYNC_MSG_LEN];
+}
+gu_log_slot_t;
+
+typedef struct gu_log_queue
+{
+    long long      enq_pos; /* contended by producers */
+    char           pad[64 - sizeof(long long)];
+    long long      deq_pos; /* touched only by the writer thread */
+    long long      mask;
+    gu_log_slot_t* slots;
+}
+gu_log_queue_t;
+
+static gu_log_queue_t* gu_log_q       = NULL;
+static int             gu_log_async   = 0;     /* producers use the queue */
+static int             gu_log_producers = 0;   /* producers pushing now */
+static long long       gu_log_drops   = 0;
+static int             gu_log_waiting = 0;     /* writer is asleep */
+static bool            gu_log_stop    = false;
+
+static pthread_t       gu_log_thd;
+static pthread_mutex_t gu_log_mtx  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  gu_log_cond = PTHREAD_COND_INITIALIZER;
+/* serializes gu_conf_log_async() calls */
+static pthread_mutex_t gu_log_conf_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static long long
+log_queue_size (long const len)
+{
+    long long ret = 1;
+    while (ret < len) ret <<= 1;
+    return ret;
+}
+
+static gu_log_queue_t*
+log_queue_create (long const len)
+{
+    gu_log_queue_t* ret;
+    long long const size = log_queue_size (len);
+    long long       i;
+
+    ret = calloc (1, sizeof(gu_log_queue_t));
+    if (!ret) return NULL;
+
+    ret->slots = calloc (size, sizeof(gu_log_slot_t));
+    if (!ret->slots) {
+        free (ret);
+        return NULL;
+    }
+
+    ret->mask = size - 1;
+    for (i = 0; i < size; i++) ret->slots[i].seq = i;
+
+    return ret;
+}
+
+static void
+log_queue_free (gu_log_queue_t* const q)
+{
+    free (q->slots);
+    free (q);
+}
+
+/* @return false if queue is full */
+static bool
+log_queue_push (gu_log_queue_t* const q, int const severity,
+                const char* const msg)
+{
+    gu_log_slot_t* slot;
+    long long      pos;
+    long long      seq;
+
+    gu_atomic_get (&q->enq_pos, &pos);
+
+    for (;;) {
+        slot = &q->slots[pos & q->mask];
+        gu_atomic_get (&slot->seq, &seq);
+
+        if (seq == pos) {
+            if (gu_atomic_bool_cas (&q->enq_pos, pos, pos + 1)) break;
+            gu_atomic_get (&q->enq_pos, &pos);
+        }
+        else if (seq < pos) {
+            return false; /* slot still holds a message from previous lap */
+        }
+        else {
+            gu_atomic_get (&q->enq_pos, &pos); /* another producer got it */
+        }
+    }
+
+    {
+        size_t const len = strlen (msg);
+
+        slot->severity = severity;
+
+        if (gu_likely(len < sizeof(slot->msg))) {
+            memcpy (slot->msg, msg, len + 1);
+            slot->ext = NULL;
+        }
+        else {
+            slot->ext = strdup (msg);
+            if (!slot->ext) {
+                /* truncate rather than lose it altogether */
+                memcpy (slot->msg, msg, sizeof(slot->msg) - 1);
+                slot->msg[sizeof(slot->msg) - 1] = '\0';
+            }
+        }
+    }
+
+    pos += 1;
+    gu_atomic_set (&slot->seq, &pos);
+
+    return true;
+}
+
+/* must be called by a single consumer
+ * @return false if queue is empty */
+static bool
+log_queue_pop (gu_log_queue_t* const q)
+{
+    gu_log_slot_t* const slot = &q->slots[q->deq_pos & q->mask];
+    long long            seq;
+
+    gu_atomic_get (&slot->seq, &seq);
+
+    if (seq != q->deq_pos + 1) return false;
+
+    if (slot->ext) {
+        gu_log_cb (slot->severity, slot->ext);
+        free (slot->ext);
+        slot->ext = NULL;
+    }
+    else {
+        gu_log_cb (slot->severity, slot->msg);
+    }
+
+    seq = q->deq_pos + q->mask + 1;
+    gu_atomic_set (&slot->seq, &seq);
+    q->deq_pos++;
+
+    return true;
+}
+
+static void
+log_queue_drain (gu_log_queue_t* const q, long long* const reported)
+{
+    long long drops;
+
+    while (log_queue_pop (q)) {}
+
+    gu_atomic_get (&gu_log_drops, &drops);
+
+    if (gu_unlikely(drops != *reported)) {
+        char msg[64];
+        snprintf (msg, sizeof(msg), "%s%lld log messages dropped",
+                  gu_log_cb_default == gu_log_cb ?
+                  gu_log_level_str[GU_LOG_WARN] : "",
+                  drops - *reported);
+        gu_log_cb (GU_LOG_WARN, msg);
+        *reported = drops;
+    }
+}
+
+static void*
+log_writer_thread (void* arg)
+{
+    gu_log_queue_t* const q        = arg;
+    long long             reported;
+    int                   one      = 1;
+    int                   zero     = 0;
+
+    gu_atomic_get (&gu_log_drops, &reported);
+
+    for (;;) {
+        log_queue_drain (q, &reported);
+
+        pthread_mutex_lock (&gu_log_mtx);
+
+        if (gu_log_stop) {
+            pthread_mutex_unlock (&gu_log_mtx);
+            break;
+        }
+
+        /* announce the intention to sleep and recheck the queue to avoid
+         * a lost wakeup, see gu_log_dispatch() */
+        gu_atomic_set (&gu_log_waiting, &one);
+
+        {
+            long long seq;
+            gu_atomic_get (&q->slots[q->deq_pos & q->mask].seq, &seq);
+
+            if (seq != q->deq_pos + 1) {
+                struct timespec ts;
+                long long const until = gu_time_calendar()+GU_LOG_ASYNC_IDLE_NS;
+
+                ts.tv_sec  = until / 1000000000LL;
+                ts.tv_nsec = until % 1000000000LL;
+                pthread_cond_timedwait (&gu_log_cond, &gu_log_mtx, &ts);
+            }
+        }
+
+        gu_atomic_set (&gu_log_waiting, &zero);
+        pthread_mutex_unlock (&gu_log_mtx);
+    }
+
+    log_queue_drain (q, &reported);
+
+    return NULL;
+}
+
+void
+gu_log_dispatch (int const severity, const char* const msg)
+{
+    int async;
+
+    gu_atomic_get (&gu_log_async, &async);
+
+    if (gu_likely(!async) || GU_LOG_FATAL == severity) {
+        gu_log_cb (severity, msg);
+        return;
+    }
+
+    /* register and recheck: log_async_stop() clears gu_log_async and then
+     * waits for registered producers, so a message either makes it into
+     * the queue before the final drain or is written synchronously */
+    gu_atomic_fetch_and_add (&gu_log_producers, 1);
+    gu_atomic_get (&gu_log_async, &async);
+
+    if (gu_unlikely(!async)) {
+        gu_atomic_fetch_and_add (&gu_log_producers, -1);
+        gu_log_cb (severity, msg);
+        return;
+    }
+
+    if (gu_likely(log_queue_push (gu_log_q, severity, msg))) {
+        int waiting;
+
+        gu_atomic_get (&gu_log_waiting, &waiting);
+
+        if (waiting) {
+            pthread_mutex_lock   (&gu_log_mtx);
+            pthread_cond_signal  (&gu_log_cond);
+            pthread_mutex_unlock (&gu_log_mtx);
+        }
+    }
+    else {
+        gu_atomic_fetch_and_add (&gu_log_drops, 1);
+    }
+
+    gu_atomic_fetch_and_add (&gu_log_producers, -1);
+}
+
+long long
+gu_log_dropped ()
+{
+    long long ret;
+    gu_atomic_get (&gu_log_drops, &ret);
+    return ret;
+}
+
+static void
+log_async_stop ()
+{
+    int const off = 0;
+    int       producers;
+
+    gu_atomic_set (&gu_log_async, &off);
+
+    /* from now on producers write synchronously, wait for those which
+     * are still pushing into the queue, it won't take long */
+    for (;;) {
+        gu_atomic_get (&gu_log_producers, &producers);
+        if (0 == producers) break;
+        sched_yield ();
+    }
+
+    pthread_mutex_lock   (&gu_log_mtx);
+    gu_log_stop = true;
+    pthread_cond_signal  (&gu_log_cond);
+    pthread_mutex_unlock (&gu_log_mtx);
+
+    pthread_join (gu_log_thd, NULL);
+
+    /* pick up whatever producers managed to push after writer's last look,
+     * nothing can be pushed after that */
+    {
+        long long reported = gu_log_dropped();
+        log_queue_drain (gu_log_q, &reported);
+    }
+}
+
+int
+gu_conf_log_async (long const queue_len)
+{
+    /* The queue is reused on restart unless a different length is
+     * requested. Once the writer is stopped no producer touches it. */
+    static long queue_len_cur = 0;
+    int         ret           = 0;
+
+    if (queue_len < 0) return -EINVAL;
+
+    pthread_mutex_lock (&gu_log_conf_mtx);
+
+    if (queue_len == queue_len_cur) goto out;
+
+    if (queue_len_cur > 0) {
+        log_async_stop ();
+        queue_len_cur = 0;
+    }
+
+    if (queue_len > 0) {
+        int const on = 1;
+
+        if (!gu_log_q || gu_log_q->mask + 1 != log_queue_size (queue_len)) {
+            gu_log_queue_t* const q = log_queue_create (queue_len);
+            if (!q) { ret = -ENOMEM; goto out; }
+            if (gu_log_q) log_queue_free (gu_log_q);
+            gu_log_q = q;
+        }
+
+        gu_log_stop = false;
+
+        ret = -pthread_create (&gu_log_thd, NULL, log_writer_thread, gu_log_q);
+        if (ret) goto out;
+
+        gu_atomic_set (&gu_log_async, &on);
+        queue_len_cur = queue_len;
+    }
+
+out:
+    pthread_mutex_unlock (&gu_log_conf_mtx);
+
+    if (!ret) {
+        gu_debug ("Asynchronous logging %s, queue length %ld",
+                  queue_len > 0 ? "on" : "off", queue_len);
+    }
+
+    return ret;
+}
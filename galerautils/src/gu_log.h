@@ -56,6 +56,17 @@ gu_log (gu_log_severity_t severity,
         const int         line,
         ...);
 
+/** Helper for gu_log() and C++ logger: passes formatted message to the
+ *  log callback, either directly or through the asynchronous queue if it
+ *  is enabled (see gu_conf_log_async()). */
+extern void
+gu_log_dispatch (int severity, const char* msg);
+
+/** Writes "YYYY-MM-DD HH:MM:SS.mmm " timestamp to the buffer.
+ *  @return snprintf() result */
+extern int
+gu_log_tstamp (char* tstamp, size_t len);
+
 /** This variable is made global only for the purpose of using it in
  *  gu_debug() macro and avoid calling gu_log() when debug is off.
  *  Don't use it directly! */
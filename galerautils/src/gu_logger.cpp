@@ -132,6 +132,11 @@ namespace gu
     Logger::prepare_default()
     {
         if (do_timestamp) {
+#ifdef _gu_log_h_
+            char tstamp[32];
+            gu_log_tstamp (tstamp, sizeof(tstamp));
+            os << tstamp;
+#else
             using namespace std;
             struct tm      date;
             struct timeval time;
@@ -146,6 +151,7 @@ namespace gu
                << setw(2) << setfill('0') << date.tm_min  << ':'
                << setw(2) << setfill('0') << date.tm_sec  << '.'
                << setw(3) << setfill('0') << (time.tv_usec / 1000) << ' ';
+#endif
         }
 
         os << level_str[level];
@@ -71,7 +71,11 @@ namespace gu
             os     ()
         {}
 
+#ifdef _gu_log_h_
+        virtual ~Logger() { gu_log_dispatch (level, os.str().c_str()); }
+#else
         virtual ~Logger() { logger (level, os.str().c_str()); }
+#endif
 
         std::ostringstream& get(const char* file,
                                 const char* func,
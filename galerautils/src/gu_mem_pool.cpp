@@ -0,0 +1,227 @@
+/* Copyright (C) 2018 Codership Oy <info@codership.com> */
+
+#include "gu_mem_pool.hpp"
+#include "gu_throw.hpp"
+
+#include <algorithm>
+
+/* Serializes pool destruction with thread exit: a thread-specific data
+ * destructor may already be running when pthread_key_delete() is called.
+ * Static initializer, so it is usable during static destruction. */
+static pthread_mutex_t teardown_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+int const gu::MemPoolCached::MAX_MAGAZINE_SIZE;
+
+gu::MemPoolCached::MemPoolCached(int const         buf_size,
+                                 int const         reserve,
+                                 const char* const name,
+                                 int const         magazine_size)
+    :
+    base_         (buf_size, reserve, name),
+#ifdef HAVE_PSI_INTERFACE
+    mtx_          (WSREP_PFS_INSTR_TAG_MEMPOOL_MUTEX),
+#else
+    mtx_          (),
+#endif /* HAVE_PSI_INTERFACE */
+    mags_         (),
+    retired_hits_ (0),
+    key_          (),
+    magazine_size_(std::min(std::max(magazine_size, 2), MAX_MAGAZINE_SIZE))
+{
+    int const err(pthread_key_create(&key_, magazine_dtor));
+
+    if (err) gu_throw_error(err) << "Failed to create MemPool thread key";
+}
+
+gu::MemPoolCached::~MemPoolCached()
+{
+    Magazine* const own(static_cast<Magazine*>(pthread_getspecific(key_)));
+
+    pthread_mutex_lock(&teardown_mtx);
+
+    /* after that magazine_dtor() won't be called for this pool, but it may
+     * be already waiting for teardown_mtx */
+    pthread_key_delete(key_);
+
+    {
+        Lock lock(mtx_);
+
+        while (!mags_.empty())
+        {
+            Magazine* const mag(mags_.back());
+
+            assert(this == mag->pool_);
+            release_magazine(mag);
+
+            if (mag == own)
+            {
+                delete mag;
+            }
+            else
+            {
+                /* the owner thread may be exiting right now, leave it to
+                 * magazine_dtor() */
+                mag->pool_ = NULL;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&teardown_mtx);
+}
+
+gu::MemPoolCached::Magazine*
+gu::MemPoolCached::new_magazine()
+{
+    Magazine* const ret(new Magazine(this, magazine_size_));
+
+    {
+        Lock lock(mtx_);
+        mags_.push_back(ret);
+    }
+
+    int const err(pthread_setspecific(key_, ret));
+
+    if (err)
+    {
+        {
+            Lock lock(mtx_);
+            release_magazine(ret);
+        }
+        delete ret;
+        gu_throw_error(err) << "Failed to set MemPool thread cache";
+    }
+
+    return ret;
+}
+
+void*
+gu::MemPoolCached::refill(Magazine* const mag)
+{
+    assert(0 == mag->size_());
+
+    void* ret;
+
+    {
+        Lock lock(mtx_);
+
+        MemPoolVector& pool(base_.pool_);
+
+        if (pool.empty())
+        {
+            ret = base_.from_pool(); // counts a miss
+            assert(NULL == ret);
+        }
+        else
+        {
+            int const batch(std::min<size_t>(magazine_size_/2, pool.size()));
+
+            for (int i(1); i < batch; ++i)
+            {
+                mag->bufs_[i - 1] = pool.back();
+                pool.pop_back();
+            }
+
+            mag->size_.store_relaxed(batch - 1);
+
+            ret = pool.back();
+            pool.pop_back();
+            mag->hits_.store_relaxed(mag->hits_.load_relaxed() + 1);
+        }
+    }
+
+    if (!ret) ret = base_.alloc();
+
+    return ret;
+}
+
+void
+gu::MemPoolCached::flush(Magazine* const mag, void* const buf)
+{
+    assert(magazine_size_ == mag->size_());
+
+    int const batch(magazine_size_/2);
+    void*     rejected[MAX_MAGAZINE_SIZE/2 + 1];
+    int       n_rejected(0);
+
+    {
+        Lock lock(mtx_);
+
+        if (!base_.to_pool(buf)) rejected[n_rejected++] = buf;
+
+        for (int i(1); i <= batch; ++i)
+        {
+            void* const b(mag->bufs_[magazine_size_ - i]);
+            if (!base_.to_pool(b)) rejected[n_rejected++] = b;
+        }
+    }
+
+    mag->size_.store_relaxed(magazine_size_ - batch);
+
+    for (int i(0); i < n_rejected; ++i) base_.free(rejected[i]);
+}
+
+void
+gu::MemPoolCached::release_magazine(Magazine* const mag)
+{
+    for (int i(mag->size_()); i > 0; --i)
+    {
+        void* const b(mag->bufs_[i - 1]);
+        if (!base_.to_pool(b)) base_.free(b);
+    }
+
+    mag->size_ = 0;
+    retired_hits_ += mag->hits_();
+
+    std::vector<Magazine*>::iterator const i
+        (std::find(mags_.begin(), mags_.end(), mag));
+    assert(i != mags_.end());
+    mags_.erase(i);
+}
+
+void
+gu::MemPoolCached::magazine_dtor(void* const arg)
+{
+    Magazine* const mag(static_cast<Magazine*>(arg));
+
+    pthread_mutex_lock(&teardown_mtx);
+
+    if (mag->pool_) /* otherwise already released by pool destructor */
+    {
+        Lock lock(mag->pool_->mtx_);
+        mag->pool_->release_magazine(mag);
+    }
+
+    pthread_mutex_unlock(&teardown_mtx);
+
+    delete mag;
+}
+
+void
+gu::MemPoolCached::print(std::ostream& os) const
+{
+    Lock lock(mtx_);
+
+    /* magazine counters are updated by owner threads without lock, so this
+     * is only a snapshot */
+    size_t hits(retired_hits_);
+    size_t cached(0);
+
+    for (size_t i(0); i < mags_.size(); ++i)
+    {
+        hits   += mags_[i]->hits_();
+        cached += mags_[i]->size_();
+    }
+
+    size_t const misses(base_.misses_);
+    double hr(hits);
+
+    if (hr > 0) hr /= hits + misses;
+
+    os << "MemPool("       << base_.name_
+       << "): hit ratio: " << hr
+       << ", misses: "     << misses
+       << ", in use: "     << base_.allocd_ - base_.pool_.size() - cached
+       << ", in pool: "    << base_.pool_.size()
+       << ", cached: "     << cached
+       << ", threads: "    << mags_.size();
+}
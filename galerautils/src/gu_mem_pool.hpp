@@ -15,8 +15,10 @@
 
 #include "gu_lock.hpp"
 #include "gu_macros.hpp"
+#include "gu_atomic.hpp"
 
 #include <assert.h>
+#include <pthread.h>
 
 #include <vector>
 #include <ostream>
@@ -149,6 +151,7 @@ namespace gu
         }
 
         friend class MemPool<true>;
+        friend class MemPoolCached;
 
     private:
 
@@ -233,6 +236,123 @@ namespace gu
 
     }; /* class MemPool<true>: thread-safe */
 
+
+    /* Thread-safe MemPool with per-thread caches.
+     *
+     * Each thread keeps a small magazine of free buffers and goes to the
+     * shared depot (MemPool<false> under mutex) only when the magazine gets
+     * empty or full, moving half a magazine at a time. Magazine of exiting
+     * thread is flushed back to depot. Pool destructor empties magazines of
+     * all threads. Magazine of a thread that outlives the pool is then left
+     * to the thread-exit destructor if that is already running, otherwise
+     * it is leaked. */
+    class MemPoolCached
+    {
+    public:
+
+        explicit
+        MemPoolCached(int buf_size, int reserve = 0, const char* name = "",
+                      int magazine_size = 8);
+
+        ~MemPoolCached();
+
+        void* acquire()
+        {
+            Magazine* const mag(magazine());
+            int const size(mag->size_.load_relaxed());
+
+            if (gu_likely(size > 0))
+            {
+                mag->hits_.store_relaxed(mag->hits_.load_relaxed() + 1);
+                mag->size_.store_relaxed(size - 1);
+                return mag->bufs_[size - 1];
+            }
+
+            return refill(mag);
+        }
+
+        void recycle(void* buf)
+        {
+            Magazine* const mag(magazine());
+            int const size(mag->size_.load_relaxed());
+
+            if (gu_likely(size < magazine_size_))
+            {
+                mag->bufs_[size] = buf;
+                mag->size_.store_relaxed(size + 1);
+                return;
+            }
+
+            flush(mag, buf);
+        }
+
+        void print(std::ostream& os) const;
+
+        size_t buf_size() const { return base_.buf_size(); }
+
+    private:
+
+        static int const MAX_MAGAZINE_SIZE = 64;
+
+        /* size_ and hits_ are modified only by the owner thread, hence
+         * relaxed load + store there, but are atomic to be read by print()
+         * from other threads */
+        struct Magazine
+        {
+            MemPoolCached*      pool_; // NULL if pool was destroyed
+            void**              bufs_;
+            gu::Atomic<int>     size_;
+            gu::Atomic<size_t>  hits_;
+
+            Magazine(MemPoolCached* pool, int capacity)
+                : pool_(pool), bufs_(new void*[capacity]), size_(0), hits_(0)
+            {}
+
+            ~Magazine() { delete[] bufs_; }
+
+        private:
+
+            Magazine(const Magazine&);
+            Magazine& operator=(const Magazine&);
+        };
+
+        Magazine* magazine()
+        {
+            Magazine* const ret(static_cast<Magazine*>
+                                (pthread_getspecific(key_)));
+
+            return (gu_likely(ret != NULL) ? ret : new_magazine());
+        }
+
+        Magazine* new_magazine();
+        void*     refill(Magazine* mag);
+        void      flush (Magazine* mag, void* buf);
+        void      release_magazine(Magazine* mag); // under mtx_
+
+        static void magazine_dtor(void* mag);
+
+        MemPool<false>         base_;
+#ifdef HAVE_PSI_INTERFACE
+        gu::MutexWithPFS       mtx_;
+#else
+        gu::Mutex              mtx_;
+#endif /* HAVE_PSI_INTERFACE */
+        std::vector<Magazine*> mags_;
+        size_t                 retired_hits_; // hits of exited threads
+        pthread_key_t          key_;
+        int const              magazine_size_;
+
+        MemPoolCached (const MemPoolCached&);
+        MemPoolCached operator= (const MemPoolCached&);
+
+    }; /* class MemPoolCached: thread-safe with per-thread caches */
+
+    inline std::ostream& operator << (std::ostream& os,
+                                      const MemPoolCached& mp)
+    {
+        mp.print(os); return os;
+    }
+
     template <bool thread_safe>
     std::ostream& operator << (std::ostream& os,
                                const MemPool<thread_safe>& mp)
@@ -20,6 +20,10 @@
 #include <unistd.h>
 #include "gu_limits.h"
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #if defined(__FreeBSD__) && defined(MAP_NORESERVE)
 /* FreeBSD has never implemented this flags and will deprecate it. */
 #undef MAP_NORESERVE
@@ -84,6 +88,114 @@ namespace gu
         }
     }
 
+    void
+    MMap::huge_pages() const
+    {
+#if defined(MADV_HUGEPAGE)
+        if (::madvise(ptr, size, MADV_HUGEPAGE))
+        {
+            log_warn << "Failed to set MADV_HUGEPAGE on " << ptr << ": "
+                     << errno << " (" << strerror(errno) << ')';
+        }
+#else
+        log_warn << "Huge pages are not supported on this platform";
+#endif /* MADV_HUGEPAGE */
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    static int    const MPOL_DEFAULT_  (0); /* from <numaif.h> */
+    static int    const MPOL_PREFERRED_(1);
+    static size_t const MASK_BITS(sizeof(unsigned long) * 8);
+
+    static bool
+    node_mask(int const node, unsigned long& mask)
+    {
+        if (node < 0 || size_t(node) >= MASK_BITS)
+        {
+            log_warn << "NUMA node " << node << " is out of range [0, "
+                     << MASK_BITS << ')';
+            return false;
+        }
+
+        mask = 1UL << node;
+        return true;
+    }
+#endif /* __linux__ && SYS_mbind */
+
+    void
+    MMap::prefer_node(int const node) const
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        unsigned long mask;
+
+        if (!node_mask(node, mask)) return;
+
+        /* maxnode is the mask size + 1, kernel discounts the last bit */
+        if (::syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_, &mask,
+                      MASK_BITS + 1, 0))
+        {
+            log_warn << "Failed to bind " << ptr << " to NUMA node " << node
+                     << ": " << errno << " (" << strerror(errno) << ')';
+        }
+#else
+        log_warn << "NUMA binding is not supported on this platform";
+#endif /* __linux__ && SYS_mbind */
+    }
+
+    PreferredNode::PreferredNode (int const node)
+        :
+        mode_(-1),
+        mask_(0)
+    {
+        if (node < 0) return;
+
+#if defined(__linux__) && defined(SYS_mbind)
+        unsigned long mask;
+
+        if (!node_mask(node, mask)) return;
+
+        int mode;
+
+        if (::syscall(SYS_get_mempolicy, &mode, &mask_, MASK_BITS + 1,
+                      NULL, 0))
+        {
+            log_warn << "Failed to get thread NUMA policy: "
+                     << errno << " (" << strerror(errno) << ')';
+            return;
+        }
+
+        if (::syscall(SYS_set_mempolicy, MPOL_PREFERRED_, &mask,
+                      MASK_BITS + 1))
+        {
+            log_warn << "Failed to make thread prefer NUMA node " << node
+                     << ": " << errno << " (" << strerror(errno) << ')';
+            return;
+        }
+
+        mode_ = mode;
+#else
+        log_warn << "NUMA binding is not supported on this platform";
+#endif /* __linux__ && SYS_mbind */
+    }
+
+    void
+    PreferredNode::reset()
+    {
+        if (mode_ < 0) return;
+
+#if defined(__linux__) && defined(SYS_mbind)
+        if (MPOL_DEFAULT_ == mode_ ?
+            ::syscall(SYS_set_mempolicy, MPOL_DEFAULT_, NULL, 0) :
+            ::syscall(SYS_set_mempolicy, mode_, &mask_, MASK_BITS + 1))
+        {
+            log_warn << "Failed to restore thread NUMA policy: "
+                     << errno << " (" << strerror(errno) << ')';
+        }
+#endif /* __linux__ && SYS_mbind */
+
+        mode_ = -1;
+    }
+
     void
     MMap::sync(void* const addr, size_t const length) const
     {
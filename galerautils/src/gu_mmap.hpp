@@ -25,6 +25,17 @@ public:
     ~MMap ();
 
     void dont_need() const;
+
+    /* Asks the kernel to back the mapping with transparent huge pages.
+     * Best effort: for regular file mappings it has effect only on tmpfs
+     * (mounted with huge=) or with file THP support. */
+    void huge_pages() const;
+
+    /* Makes the pages of the mapping prefer the given NUMA node. Does not
+     * move pages that are already resident and, like above, is honored only
+     * for tmpfs files. See also PreferredNode below. */
+    void prefer_node(int node) const;
+
     void sync(void *addr, size_t length) const;
     void sync() const;
     void unmap();
@@ -38,6 +49,29 @@ private:
     MMap& operator = (const MMap);
 };
 
+/* Makes the calling thread prefer the given NUMA node for new memory until
+ * reset() or destruction, so that pages allocated by file creation and
+ * preallocation are placed there too. node < 0 means no preference. */
+class PreferredNode
+{
+public:
+
+    explicit PreferredNode (int node);
+
+    ~PreferredNode () { reset(); }
+
+    /* restores previous thread policy */
+    void reset();
+
+private:
+
+    int           mode_; // previous mode, -1 if policy was not changed
+    unsigned long mask_; // previous node mask
+
+    PreferredNode (const PreferredNode&);
+    PreferredNode& operator = (const PreferredNode&);
+};
+
 } /* namespace gu */
 
 #endif /* __GCACHE_MMAP__ */
@@ -15,6 +15,7 @@
 #include "gu_byteswap.h"
 
 #include <string.h> // for memset() and memcpy()
+#include <assert.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -352,6 +353,93 @@ gu_mmh128_append (gu_mmh128_ctx_t* const mmh,
     memcpy (mmh->tail, blocks + nblocks, len & 15);
 }
 
+/*! Maximum number of contexts for gu_mmh128_append_lanes() */
+#define GU_MMH128_LANES 4
+
+/*! Append message parts to several independent hash contexts at once.
+ *  Full blocks of all contexts are mixed in one interleaved loop, so that
+ *  per-context dependency chains can overlap in the CPU pipeline.
+ *  The result is identical to calling gu_mmh128_append() on every context. */
+static GU_INLINE void
+gu_mmh128_append_lanes (gu_mmh128_ctx_t* const* const mmh,
+                        const void*      const* const parts,
+                        const size_t*    const        lens,
+                        int              const        lanes)
+{
+    const uint64_t* blocks [GU_MMH128_LANES];
+    size_t          nblocks[GU_MMH128_LANES];
+    size_t          rest   [GU_MMH128_LANES];
+    uint64_t        h1     [GU_MMH128_LANES];
+    uint64_t        h2     [GU_MMH128_LANES];
+    size_t          common = (size_t)-1;
+    size_t          i;
+    int             l;
+
+    assert (lanes > 0 && lanes <= GU_MMH128_LANES);
+
+    for (l = 0; l < lanes; l++)
+    {
+        gu_mmh128_ctx_t* const m = mmh[l];
+        const uint8_t*   part    = (const uint8_t*)parts[l];
+        size_t           len     = lens[l];
+        size_t const     tail_len = m->length & 15;
+
+        m->length += len;
+        h1[l] = m->hash[0];
+        h2[l] = m->hash[1];
+
+        if (tail_len)
+        {
+            size_t const to_fill  = 16 - tail_len;
+            void*  const tail_end = (uint8_t*)m->tail + tail_len;
+
+            if (len >= to_fill)
+            {
+                memcpy (tail_end, part, to_fill);
+                _mmh3_128_block (gu_le64(m->tail[0]), gu_le64(m->tail[1]),
+                                 &h1[l], &h2[l]);
+                part += to_fill;
+                len  -= to_fill;
+            }
+            else
+            {
+                memcpy (tail_end, part, len);
+                len = 0; /* nothing left for blocks and tail */
+            }
+        }
+
+        blocks [l] = (const uint64_t*)part;
+        nblocks[l] = (len >> 4) << 1; /* using 64-bit half-blocks */
+        rest   [l] = len & 15;
+
+        if (nblocks[l] < common) common = nblocks[l];
+    }
+
+    /* interleaved part: all lanes have at least that many blocks */
+    for (i = 0; i < common; i += 2)
+    {
+        for (l = 0; l < lanes; l++)
+        {
+            _mmh3_128_block (gu_le64(blocks[l][i]), gu_le64(blocks[l][i + 1]),
+                             &h1[l], &h2[l]);
+        }
+    }
+
+    for (l = 0; l < lanes; l++)
+    {
+        gu_mmh128_ctx_t* const m = mmh[l];
+
+        _mmh3_128_blocks (blocks[l] + common, nblocks[l] - common,
+                          &h1[l], &h2[l]);
+
+        m->hash[0] = h1[l];
+        m->hash[1] = h2[l];
+
+        /* save possible trailing bytes to tail */
+        if (rest[l]) memcpy (m->tail, blocks[l] + nblocks[l], rest[l]);
+    }
+}
+
 /*! Get the accumulated message hash (does not change the context) */
 static GU_INLINE void
 gu_mmh128_get (const gu_mmh128_ctx_t* const mmh, void* const res)
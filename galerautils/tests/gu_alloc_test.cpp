@@ -7,6 +7,8 @@
 
 #include "gu_alloc_test.hpp"
 
+#include <unistd.h> // access()
+
 class TestBaseName : public gu::Allocator::BaseName
 {
     std::string str_;
@@ -83,10 +85,91 @@ START_TEST (basic)
 }
 END_TEST
 
+START_TEST (arena)
+{
+    TestBaseName test_name("gu_alloc_arena_test");
+    size_t const page_size(1 << 16);
+    bool   n;
+
+    gu::Allocator::arena_configure(0, page_size);
+
+    gu::Allocator::ArenaStats st0;
+    gu::Allocator::arena_stats(st0);
+
+    {
+        /* no heap store, everything goes to file pages */
+        gu::Allocator a(test_name, NULL, 0, 0, page_size);
+        fail_if (0 == a.alloc(page_size / 2, n));
+        fail_if (!n);
+
+        gu::Allocator::ArenaStats st;
+        gu::Allocator::arena_stats(st);
+        fail_if (st.spill_created + st.spill_reused !=
+                 st0.spill_created + st0.spill_reused + 1);
+        fail_if (st.spill_in_use != st0.spill_in_use + page_size);
+    }
+
+    gu::Allocator::ArenaStats st1;
+    gu::Allocator::arena_stats(st1);
+    fail_if (st1.spill_in_use != st0.spill_in_use);
+    fail_if (st1.spill_pooled != page_size, "spill_pooled: %zu",
+             st1.spill_pooled);
+
+    /* pooled page must not be reachable by its file name */
+    fail_if (0 == access("gu_alloc_arena_test.000000", F_OK));
+
+    {
+        /* released page must be picked up by the next allocator */
+        gu::Allocator a(test_name, NULL, 0, 0, page_size);
+        void* const p(a.alloc(page_size, n));
+        fail_if (0 == p);
+        memset (p, 0, page_size);
+
+        gu::Allocator::ArenaStats st;
+        gu::Allocator::arena_stats(st);
+        fail_if (st.spill_reused  != st1.spill_reused + 1);
+        fail_if (st.spill_created != st1.spill_created);
+        fail_if (st.spill_pooled  != 0);
+
+        /* allocator with the same base name must get a separate page */
+        gu::Allocator b(test_name, NULL, 0, 0, page_size);
+        void* const q(b.alloc(page_size, n));
+        fail_if (0 == q);
+        memset (q, 1, page_size);
+        fail_if (static_cast<const char*>(p)[0] != 0);
+    }
+
+    /* common heap budget: second allocator must spill to disk */
+    gu::Allocator::arena_configure(page_size, page_size);
+    {
+        gu::Allocator a(test_name, NULL, 0, page_size, page_size);
+        gu::Allocator b(test_name, NULL, 0, page_size, page_size);
+
+        fail_if (0 == a.alloc(page_size, n));
+        fail_if (0 == b.alloc(page_size, n));
+
+        gu::Allocator::ArenaStats st;
+        gu::Allocator::arena_stats(st);
+        fail_if (st.heap_used != page_size);
+        fail_if (st.spill_pooled != 0);
+    }
+
+    gu::Allocator::ArenaStats st2;
+    gu::Allocator::arena_stats(st2);
+    fail_if (st2.heap_used != 0);
+
+    /* drop pooled pages */
+    gu::Allocator::arena_configure(0, 0);
+    gu::Allocator::arena_stats(st2);
+    fail_if (st2.spill_pooled != 0);
+}
+END_TEST
+
 Suite* gu_alloc_suite ()
 {
     TCase* t = tcase_create ("Allocator");
     tcase_add_test (t, basic);
+    tcase_add_test (t, arena);
 
     Suite* s = suite_create ("gu::Allocator");
     suite_add_tcase (s, t);
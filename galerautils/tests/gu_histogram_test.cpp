@@ -5,6 +5,7 @@
 #include "../src/gu_histogram.hpp"
 #include "../src/gu_logger.hpp"
 #include <cstdlib>
+#include <limits>
 
 #include "gu_histogram_test.hpp"
 
@@ -31,10 +32,51 @@ START_TEST(test_histogram)
 }
 END_TEST
 
+START_TEST(test_latency_histogram)
+{
+    LatencyHistogram hs;
+
+    fail_if(hs.percentile(0.5) != 0);
+
+    for (long long i = 0; i < 8; ++i) hs.insert(i);
+    fail_if(hs.count() != 8);
+    fail_if(hs.percentile(0.5) != 3, "%lld", hs.percentile(0.5));
+    fail_if(hs.percentile(1.0) != 7, "%lld", hs.percentile(1.0));
+
+    hs.clear();
+    fail_if(hs.count() != 0);
+
+    /* 1..100000: percentiles must be within 1/8 of the exact value */
+    for (long long i = 1; i <= 100000; ++i) hs.insert(i);
+    fail_if(hs.count() != 100000);
+
+    double const p[] = { 0.5, 0.9, 0.99, 0.999 };
+    for (size_t i = 0; i < sizeof(p)/sizeof(p[0]); ++i)
+    {
+        double const exact(p[i] * 100000);
+        double const val(hs.percentile(p[i]));
+        fail_if(val < exact || val > exact * 1.125,
+                "p%g: %g, expected %g", p[i], val, exact);
+    }
+
+    hs.insert(-1); // clamped to 0
+    fail_if(hs.percentile(0.0) != 0);
+
+    hs.insert(1LL << 62);
+    fail_if(hs.percentile(1.0) < (1LL << 62));
+
+    /* bound of the last bucket is clamped rather than overflown */
+    long long const max(std::numeric_limits<long long>::max());
+    hs.insert(max);
+    fail_if(hs.percentile(1.0) != max, "%lld", hs.percentile(1.0));
+}
+END_TEST
+
 Suite* gu_histogram_suite()
 {
     TCase* t = tcase_create ("test_histogram");
     tcase_add_test (t, test_histogram);
+    tcase_add_test (t, test_latency_histogram);
 
     Suite* s = suite_create ("gu::Histogram");
     suite_add_tcase (s, t);
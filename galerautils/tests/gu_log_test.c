@@ -0,0 +1,172 @@
+// Copyright (C) 2018 Codership Oy <info@codership.com>
+
+// $Id$
+
+#include <check.h>
+#include <pthread.h>
+#include <string.h>
+#include "gu_log_test.h"
+#include "../src/gu_conf.h"
+#include "../src/gu_atomic.h"
+
+START_TEST (gu_log_tstamp_test)
+{
+    char buf[32];
+    int  len = gu_log_tstamp (buf, sizeof(buf));
+
+    fail_if (len != 24, "Expected 24 symbols, got %d: '%s'", len, buf);
+    fail_if (buf[4] != '-' || buf[10] != ' ' || buf[19] != '.' ||
+             buf[23] != ' ', "Malformed timestamp: '%s'", buf);
+
+    /* cached date part must not leak into a shorter buffer */
+    len = gu_log_tstamp (buf, 8);
+    fail_if (strlen(buf) != 7, "Expected truncation to 7, got '%s'", buf);
+}
+END_TEST
+
+static long long log_async_count = 0;
+static long      log_async_long  = 0;
+
+static void
+log_async_cb (int severity, const char* msg)
+{
+    /* called from the writer thread, or from producers while stopping */
+    if (strlen(msg) > 1024) gu_atomic_fetch_and_add (&log_async_long, 1);
+    gu_atomic_fetch_and_add (&log_async_count, 1);
+}
+
+#define LOG_ASYNC_THREADS 4
+#define LOG_ASYNC_MSGS    10000
+
+static void*
+log_async_thread (void* arg)
+{
+    int i;
+    for (i = 0; i < LOG_ASYNC_MSGS; i++) gu_info ("message %d", i);
+    return NULL;
+}
+
+START_TEST (gu_log_async_test)
+{
+    pthread_t         thd[LOG_ASYNC_THREADS];
+    gu_log_severity_t max_level = gu_log_max_level;
+    long long         dropped0  = gu_log_dropped();
+    long long         count;
+    char              long_msg[1500];
+    int               i;
+
+    gu_log_max_level = GU_LOG_INFO;
+    gu_conf_set_log_callback (log_async_cb);
+
+    fail_if (gu_conf_log_async (-1) == 0);
+    fail_if (gu_conf_log_async (16));
+
+    /* longer than inline slot buffer */
+    memset (long_msg, 'x', sizeof(long_msg) - 1);
+    long_msg[sizeof(long_msg) - 1] = '\0';
+    gu_info ("%s", long_msg);
+
+    for (i = 0; i < LOG_ASYNC_THREADS; i++)
+        pthread_create (&thd[i], NULL, log_async_thread, NULL);
+    for (i = 0; i < LOG_ASYNC_THREADS; i++)
+        pthread_join (thd[i], NULL);
+
+    fail_if (gu_conf_log_async (0)); // flushes the queue
+
+    gu_conf_set_log_callback (NULL);
+    gu_log_max_level = max_level;
+
+    gu_atomic_get (&log_async_count, &count);
+
+    /* every message is either written or dropped, drop reports are extra */
+    fail_if (count < LOG_ASYNC_THREADS * LOG_ASYNC_MSGS + 1
+             - (gu_log_dropped() - dropped0),
+             "Lost messages: written %lld, dropped %lld",
+             count, gu_log_dropped() - dropped0);
+    fail_if (count > LOG_ASYNC_THREADS * LOG_ASYNC_MSGS + 1 +
+             (gu_log_dropped() - dropped0),
+             "Too many messages: written %lld, dropped %lld",
+             count, gu_log_dropped() - dropped0);
+    fail_if (log_async_long != 1, "Long message not written");
+}
+END_TEST
+
+static int log_async_run = 0;
+
+static void*
+log_async_stop_thread (void* arg)
+{
+    long long* const sent = arg;
+    int              run;
+
+    do {
+        gu_info ("message %lld", *sent);
+        (*sent)++;
+        gu_atomic_get (&log_async_run, &run);
+    } while (run);
+
+    return NULL;
+}
+
+/* messages logged while asynchronous logging is being turned off must be
+ * either queued before the final drain or written synchronously */
+START_TEST (gu_log_async_stop_test)
+{
+    pthread_t         thd[LOG_ASYNC_THREADS];
+    long long         sent[LOG_ASYNC_THREADS] = { 0, };
+    gu_log_severity_t max_level = gu_log_max_level;
+    long long         dropped0  = gu_log_dropped();
+    long long         total     = 0;
+    long long         dropped;
+    long long         count;
+    int               run       = 1;
+    int               i;
+
+    gu_atomic_set (&log_async_count, &total);
+    gu_atomic_set (&log_async_run, &run);
+
+    gu_log_max_level = GU_LOG_INFO;
+    gu_conf_set_log_callback (log_async_cb);
+
+    for (i = 0; i < LOG_ASYNC_THREADS; i++)
+        pthread_create (&thd[i], NULL, log_async_stop_thread, &sent[i]);
+
+    for (i = 0; i < 100; i++) {
+        fail_if (gu_conf_log_async (1024));
+        fail_if (gu_conf_log_async (0));
+    }
+
+    run = 0;
+    gu_atomic_set (&log_async_run, &run);
+
+    for (i = 0; i < LOG_ASYNC_THREADS; i++) {
+        pthread_join (thd[i], NULL);
+        total += sent[i];
+    }
+
+    gu_conf_set_log_callback (NULL);
+    gu_log_max_level = max_level;
+
+    gu_atomic_get (&log_async_count, &count);
+    dropped = gu_log_dropped() - dropped0;
+
+    fail_if (count < total - dropped,
+             "Lost messages: sent %lld, written %lld, dropped %lld",
+             total, count, dropped);
+    fail_if (count > total + dropped,
+             "Too many messages: sent %lld, written %lld, dropped %lld",
+             total, count, dropped);
+}
+END_TEST
+
+Suite *gu_log_suite(void)
+{
+  Suite *s  = suite_create("Galera logging");
+  TCase *tc = tcase_create("gu_log");
+
+  suite_add_tcase (s, tc);
+  tcase_add_test  (tc, gu_log_tstamp_test);
+  tcase_add_test  (tc, gu_log_async_test);
+  tcase_add_test  (tc, gu_log_async_stop_test);
+  return s;
+}
@@ -0,0 +1,10 @@
+// Copyright (C) 2018 Codership Oy <info@codership.com>
+
+// $Id$
+
+#ifndef __gu_log_test__
+#define __gu_log_test__
+
+Suite *gu_log_suite(void);
+
+#endif /* __gu_log_test__ */
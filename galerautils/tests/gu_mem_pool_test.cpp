@@ -5,9 +5,13 @@
 #define TEST_SIZE 1024
 
 #include "gu_mem_pool.hpp"
+#include "gu_threads.h"
+#include "gu_lock.hpp"
 
 #include "gu_mem_pool_test.hpp"
 
+#include <sstream>
+
 START_TEST (unsafe)
 {
     gu::MemPoolUnsafe mp(10, 1, "unsafe");
@@ -56,6 +60,121 @@ START_TEST (safe)
 }
 END_TEST
 
+static void* cached_thread(void* arg)
+{
+    gu::MemPoolCached& mp(*static_cast<gu::MemPoolCached*>(arg));
+
+    void* bufs[TEST_SIZE];
+
+    for (int i(0); i < TEST_SIZE; ++i)
+    {
+        bufs[i] = mp.acquire();
+        fail_if(NULL == bufs[i]);
+    }
+
+    for (int i(0); i < TEST_SIZE; ++i) mp.recycle(bufs[i]);
+
+    return NULL;
+}
+
+START_TEST (cached)
+{
+    gu::MemPoolCached mp(10, 1, "cached", 4);
+
+    void* const buf0(mp.acquire());
+    fail_if(NULL == buf0);
+
+    void* const buf1(mp.acquire());
+    fail_if(NULL == buf1);
+    fail_if(buf0 == buf1);
+
+    mp.recycle(buf0);
+
+    void* const buf2(mp.acquire());
+    fail_if(NULL == buf2);
+    fail_if(buf0 != buf2);
+
+    /* buffers released by other threads end up in the depot */
+    gu_thread_t threads[4];
+
+    for (int i(0); i < 4; ++i)
+    {
+        fail_if(gu_thread_create(&threads[i], NULL, cached_thread, &mp));
+    }
+
+    for (int i(0); i < 4; ++i) gu_thread_join(threads[i], NULL);
+
+    log_info << mp;
+
+    mp.recycle(buf1);
+    mp.recycle(buf2);
+}
+END_TEST
+
+struct teardown_ctx
+{
+    gu::MemPoolCached* mp;
+    gu::Mutex          mtx;
+    gu::Cond           cond;
+    int                stage;
+
+    explicit teardown_ctx(gu::MemPoolCached* const pool)
+        : mp(pool), mtx(), cond(), stage(0)
+    {}
+
+private:
+
+    teardown_ctx(const teardown_ctx&);
+    teardown_ctx& operator=(const teardown_ctx&);
+};
+
+static void* teardown_thread(void* arg)
+{
+    teardown_ctx& ctx(*static_cast<teardown_ctx*>(arg));
+
+    ctx.mp->recycle(ctx.mp->acquire()); // leaves buffer in thread cache
+
+    gu::Lock lock(ctx.mtx);
+    ctx.stage = 1;
+    ctx.cond.signal();
+    while (ctx.stage < 2) lock.wait(ctx.cond); // outlive the pool
+
+    return NULL;
+}
+
+/* pool is destroyed while another thread still has a cache in it */
+START_TEST (cached_teardown)
+{
+    teardown_ctx ctx(new gu::MemPoolCached(10, 0, "teardown", 4));
+
+    gu_thread_t thread;
+    fail_if(gu_thread_create(&thread, NULL, teardown_thread, &ctx));
+
+    {
+        gu::Lock lock(ctx.mtx);
+        while (ctx.stage < 1) lock.wait(ctx.cond);
+    }
+
+    ctx.mp->recycle(ctx.mp->acquire());
+
+    std::ostringstream os;
+    os << *ctx.mp;
+    log_info << os.str();
+    fail_if(os.str().find("cached: 2, threads: 2") == std::string::npos,
+            "%s", os.str().c_str());
+
+    delete ctx.mp;
+
+    {
+        gu::Lock lock(ctx.mtx);
+        ctx.stage = 2;
+        ctx.cond.signal();
+    }
+
+    gu_thread_join(thread, NULL);
+}
+END_TEST
+
 Suite *gu_mem_pool_suite(void)
 {
     Suite *s = suite_create("gu::MemPool");
@@ -64,6 +183,8 @@ Suite *gu_mem_pool_suite(void)
     suite_add_tcase (s, tc_mem);
     tcase_add_test(tc_mem, unsafe);
     tcase_add_test(tc_mem, safe);
+    tcase_add_test(tc_mem, cached);
+    tcase_add_test(tc_mem, cached_teardown);
 
     return s;
 }
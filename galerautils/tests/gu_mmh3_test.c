@@ -228,6 +228,44 @@ START_TEST (gu_mmh128_partial)
 }
 END_TEST
 
+/* Tests multi-lane appending against gu_mmh128_append() */
+START_TEST (gu_mmh128_lanes)
+{
+    gu_mmh128_ctx_t  ref  [GU_MMH128_LANES];
+    gu_mmh128_ctx_t  lane [GU_MMH128_LANES];
+    gu_mmh128_ctx_t* ptr  [GU_MMH128_LANES];
+    const void*      parts[GU_MMH128_LANES];
+    size_t           lens [GU_MMH128_LANES];
+    hash128_t        r, h;
+    int              l, pre;
+
+    /* different prefixes leave different tails in the contexts */
+    for (pre = 0; pre < 16; pre++)
+    {
+        for (l = 0; l < GU_MMH128_LANES; l++)
+        {
+            gu_mmh128_init (&ref[l]);
+            gu_mmh128_append (&ref[l], test_input, pre + l);
+            lane[l]  = ref[l];
+            ptr[l]   = &lane[l];
+            parts[l] = test_input + l;
+            lens[l]  = sizeof(test_input) - 1 - l*7;
+            gu_mmh128_append (&ref[l], parts[l], lens[l]);
+        }
+
+        gu_mmh128_append_lanes (ptr, parts, lens, GU_MMH128_LANES);
+
+        for (l = 0; l < GU_MMH128_LANES; l++)
+        {
+            gu_mmh128_get (&ref[l],  &r);
+            gu_mmh128_get (&lane[l], &h);
+            fail_if(check (&r, &h, sizeof(h)),
+                    "lane %d differs with prefix %d", l, pre);
+        }
+    }
+}
+END_TEST
+
 Suite *gu_mmh3_suite(void)
 {
   Suite *s  = suite_create("MurmurHash3");
@@ -238,6 +276,7 @@ Suite *gu_mmh3_suite(void)
 //  tcase_add_test (tc, gu_mmh128_x86_test);
   tcase_add_test (tc, gu_mmh128_x64_test);
   tcase_add_test (tc, gu_mmh128_partial);
+  tcase_add_test (tc, gu_mmh128_lanes);
 
   return s;
 }
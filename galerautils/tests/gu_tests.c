@@ -23,6 +23,7 @@
 #include "gu_lock_step_test.h"
 #include "gu_str_test.h"
 #include "gu_utils_test.h"
+#include "gu_log_test.h"
 
 typedef Suite *(*suite_creator_t)(void);
 
@@ -42,6 +43,7 @@ static suite_creator_t suites[] =
         gu_lock_step_suite,
         gu_str_suite,
         gu_utils_suite,
+        gu_log_suite,
         NULL
     };
 
@@ -42,6 +42,8 @@ Config::Config (int argc, char* argv[])
       options_ (),
       log_     (),
       cfg_     (),
+      ist_donor_(false),
+      workdir_ ("."),
       exit_    (false)
 {
     po::options_description other ("Other options");
@@ -61,6 +63,8 @@ Config::Config (int argc, char* argv[])
         ("donor",    po::value<std::string>(&donor_),   "SST donor name")
         ("options,o",po::value<std::string>(&options_), "GCS/GCOMM option list")
         ("log,l",    po::value<std::string>(&log_),     "Log file")
+        ("ist-donor","Keep writesets in GCache and serve IST to joiners")
+        ("workdir,w",po::value<std::string>(&workdir_), "Working directory")
         ;
 
     po::options_description cfg_opt;
@@ -126,6 +130,11 @@ Config::Config (int argc, char* argv[])
         daemon_ = true;
     }
 
+    if (vm.count("ist-donor"))
+    {
+        ist_donor_ = true;
+    }
+
     /* Seeing how https://svn.boost.org/trac/boost/ticket/850 is fixed long and
      * hard, it becomes clear what an undercooked piece of... cake(?) boost is.
      * - need to strip quotes manually if used in config file.
@@ -138,6 +147,14 @@ Config::Config (int argc, char* argv[])
     strip_quotes(options_);
     strip_quotes(log_);
     strip_quotes(cfg_);
+    strip_quotes(workdir_);
+
+    if (ist_donor_ && daemon_ && (workdir_.empty() || '/' != workdir_[0]))
+    {
+        /* daemon changes working directory to / */
+        gu_throw_error(EINVAL) << "Working directory must be an absolute path "
+                               << "in daemon mode, got '" << workdir_ << "'";
+    }
 
     if (options_.length() > 0) options_ += "; ";
     options_ += "gcs.fc_limit=9999999; gcs.fc_factor=1.0; gcs.fc_master_slave=yes";
@@ -168,7 +185,9 @@ std::ostream& operator << (std::ostream& os, const Config& c)
        << "\n\tdonor:   " << c.donor()
        << "\n\toptions: " << c.options()
        << "\n\tcfg:     " << c.cfg()
-       << "\n\tlog:     " << c.log();
+       << "\n\tlog:     " << c.log()
+       << "\n\tist-donor: " << c.ist_donor()
+       << "\n\tworkdir: " << c.workdir();
     return os;
 }
 
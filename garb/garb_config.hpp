@@ -27,6 +27,8 @@ public:
     const std::string& options() const { return options_; }
     const std::string& cfg()     const { return cfg_    ; }
     const std::string& log()     const { return log_    ; }
+    bool               ist_donor() const { return ist_donor_; }
+    const std::string& workdir() const { return workdir_; }
     bool               exit()    const { return exit_   ; }
 
 private:
@@ -40,6 +42,8 @@ private:
     std::string options_;
     std::string log_;
     std::string cfg_;
+    bool        ist_donor_;
+    std::string workdir_;
     bool exit_; /* Exit on --help or --version */
 
 }; /* class Config */
@@ -11,13 +11,14 @@ static int const REPL_PROTO_VER(127);
 static int const APPL_PROTO_VER(127);
 
 Gcs::Gcs (gu::Config&        gconf,
+          gcache_t*          cache,
           const std::string& name,
           const std::string& address,
           const std::string& group)
 :
     closed_ (true),
     gcs_ (gcs_create (reinterpret_cast<gu_config_t*>(&gconf),
-                      NULL,
+                      cache,
                       name.c_str(),
                       "",
                       REPL_PROTO_VER, APPL_PROTO_VER))
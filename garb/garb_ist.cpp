@@ -0,0 +1,249 @@
+/* Copyright (C) 2018 Codership Oy <info@codership.com> */
+
+#include "garb_ist.hpp"
+
+#include <gu_byteswap.h>
+#include <gu_serialize.hpp>
+#include <gu_throw.hpp>
+
+#include <sstream>
+#include <cstring>
+
+namespace garb
+{
+
+void
+IstDonor::register_params (gu::Config& conf)
+{
+    gcache::GCache::register_params(conf);
+    galera::Certification::register_params(conf);
+    galera::ist::register_params(conf);
+}
+
+IstDonor::IstDonor (gu::Config& conf, const std::string& workdir)
+    :
+    conf_       (conf),
+    gcache_     (conf, workdir),
+    gcs_        (conf, gcache_),
+    service_thd_(gcs_, gcache_),
+    cert_       (conf, service_thd_, gcache_),
+    trx_pool_   (sizeof(galera::TrxHandle), 1024, "SlaveTrxHandle"),
+    ist_senders_(gcache_),
+    uuid_       (),
+    cc_seqno_   (GCS_SEQNO_ILL),
+    proto_ver_  (-1)
+{
+    log_info << "Serving IST from GCache in '" << workdir << "'";
+}
+
+IstDonor::~IstDonor ()
+{
+    ist_senders_.cancel();
+    service_thd_.flush();
+}
+
+/* must be kept in sync with ReplicatorSMM::establish_protocol_versions() */
+static int
+trx_proto_ver (int const repl_proto_ver)
+{
+    switch (repl_proto_ver)
+    {
+    case 1:
+    case 2: return 1;
+    case 3:
+    case 4: return 2;
+    case 5:
+    case 6:
+    case 7:
+    case 8: return 3;
+    case 9:
+    case 10: return 4;
+    }
+
+    gu_throw_error(EPROTO) << "Unsupported replication protocol version: "
+                           << repl_proto_ver;
+    GU_DEBUG_NORETURN;
+}
+
+void
+IstDonor::process_trx (const gcs_action& act)
+{
+    assert(act.buf);
+
+    if (gu_unlikely(cc_seqno_ < 0))
+    {
+        /* can't be certified before the first primary configuration */
+        gcache_.free(const_cast<void*>(act.buf));
+        return;
+    }
+
+    galera::TrxHandle* const trx(galera::TrxHandle::New(trx_pool_));
+
+    try
+    {
+        gu_trace(trx->unserialize(static_cast<const gu::byte_t*>(act.buf),
+                                  act.size, 0));
+        trx->set_received(act.buf, act.seqno_l, act.seqno_g);
+
+        /* Joiners trust dependencies recorded in IST writesets and skip the
+         * ones marked as failed, so GCache must contain the same as on data
+         * nodes. */
+        gu_trace(cert_.append_trx(trx));
+        trx->verify_checksum();
+
+        gcache_.seqno_assign(act.buf, act.seqno_g, trx->depends_seqno());
+
+        cert_.set_trx_committed(trx);
+    }
+    catch (...)
+    {
+        /* certification index keeps its own reference if it took one */
+        trx->unref();
+        throw;
+    }
+
+    trx->unref();
+}
+
+void
+IstDonor::process_commit_cut (const gcs_action& act)
+{
+    gcs_seqno_t seq;
+    gu::unserialize8(static_cast<const gu::byte_t*>(act.buf), act.size, 0,
+                     seq);
+
+    if (seq >= cc_seqno_) /* see ReplicatorSMM::process_commit_cut() */
+        cert_.schedule_purge(seq);
+}
+
+void
+IstDonor::process_conf (const gcs_act_conf_t& cc)
+{
+    if (cc.conf_id < 0) return;
+
+    int const trx_ver(trx_proto_ver(cc.repl_proto_ver));
+
+    cert_.assign_initial_position(cc.seqno, trx_ver);
+    service_thd_.flush();
+
+    uuid_      = gu::UUID(*reinterpret_cast<const gu_uuid_t*>(cc.uuid));
+    cc_seqno_  = cc.seqno;
+    proto_ver_ = cc.repl_proto_ver;
+
+    /* no-op unless there is a gap in history */
+    gcache_.seqno_reset(uuid_, cc_seqno_);
+}
+
+/* Extracts IST part of the request prepared by ReplicatorSMM, see
+ * StateRequest_v1 and IST_request in galera/src/replicator_str.cpp.
+ * @return false if request is not IST-only */
+static bool
+parse_ist_request (const gcs_action& act,
+                   gu::UUID&         uuid,
+                   gcs_seqno_t&      last_applied,
+                   std::string&      peer)
+{
+    static char const MAGIC[] = "STRv1";
+
+    const char* const req(static_cast<const char*>(act.buf));
+    size_t const      len(act.size);
+    size_t const      sst_off(sizeof(MAGIC));
+
+    if (len < sst_off + 2*sizeof(uint32_t) || memcmp(req, MAGIC, sst_off))
+        return false;
+
+    uint32_t sst_len;
+    memcpy(&sst_len, req + sst_off, sizeof(sst_len));
+    if (gtohl(sst_len) != 0) return false;
+
+    size_t const ist_off(sst_off + sizeof(uint32_t));
+
+    uint32_t ist_len;
+    memcpy(&ist_len, req + ist_off, sizeof(ist_len));
+    ist_len = gtohl(ist_len);
+
+    if (0 == ist_len || ist_off + sizeof(uint32_t) + ist_len != len)
+        return false;
+
+    std::istringstream is(std::string(req + ist_off + sizeof(uint32_t),
+                                      ist_len));
+    gcs_seqno_t group_seqno;
+    char c;
+
+    try
+    {
+        is >> uuid >> c >> last_applied >> c >> group_seqno >> c >> peer;
+    }
+    catch (gu::UUIDScanException&)
+    {
+        return false;
+    }
+
+    return !is.fail();
+}
+
+gcs_seqno_t
+IstDonor::process_state_req (const gcs_action& act)
+{
+    gu::UUID    uuid;
+    gcs_seqno_t last_applied;
+    std::string peer;
+
+    if (!parse_ist_request(act, uuid, last_applied, peer))
+    {
+        log_info << "Can't serve SST, state transfer request ignored";
+        return -ENOSYS;
+    }
+
+    if (!(uuid == uuid_))
+    {
+        log_info << "IST request for foreign history " << uuid
+                 << ", current: " << uuid_;
+        return -ENOSYS;
+    }
+
+    log_info << "IST request: " << uuid << ':' << last_applied << '-'
+             << cc_seqno_ << '|' << peer;
+
+    try
+    {
+        gcache_.seqno_lock(last_applied + 1);
+    }
+    catch (gu::NotFound&)
+    {
+        log_info << "IST first seqno " << last_applied + 1
+                 << " not found from cache";
+        return -ENODATA;
+    }
+
+    try
+    {
+        ist_senders_.run(conf_, peer, last_applied + 1, cc_seqno_,
+                         proto_ver_);
+    }
+    catch (gu::Exception& e)
+    {
+        log_error << "IST failed: " << e.what();
+        return -e.get_errno();
+    }
+
+    return act.seqno_g;
+}
+
+void
+IstDonor::release (const gcs_action& act)
+{
+    switch (act.type)
+    {
+    case GCS_ACT_TORDERED:
+        break;
+    case GCS_ACT_STATE_REQ:
+        gcache_.free(const_cast<void*>(act.buf));
+        break;
+    default:
+        ::free(const_cast<void*>(act.buf));
+        break;
+    }
+}
+
+} /* namespace garb */
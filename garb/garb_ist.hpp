@@ -0,0 +1,67 @@
+/* Copyright (C) 2018 Codership Oy <info@codership.com> */
+
+#ifndef _GARB_IST_HPP_
+#define _GARB_IST_HPP_
+
+#include <GCache.hpp>
+#include <galera_gcs.hpp>
+#include <galera_service_thd.hpp>
+#include <certification.hpp>
+#include <trx_handle.hpp>
+#include <ist.hpp>
+
+#include <gcs.hpp>
+#include <gu_config.hpp>
+#include <gu_uuid.hpp>
+
+namespace garb
+{
+
+/*! Keeps replicated writesets in a local GCache and serves IST to joiners
+ *  which need only writesets and no SST. Writesets are certified to learn
+ *  their dependencies (and rollbacks) exactly as data nodes record them. */
+class IstDonor
+{
+public:
+
+    static void register_params (gu::Config&);
+
+    IstDonor (gu::Config& conf, const std::string& workdir);
+
+    ~IstDonor ();
+
+    gcache_t* gcache() { return reinterpret_cast<gcache_t*>(&gcache_); }
+
+    void process_trx (const gcs_action& act);
+
+    void process_commit_cut (const gcs_action& act);
+
+    void process_conf (const gcs_act_conf_t& cc);
+
+    /*! @return seqno to join with or negative error code */
+    gcs_seqno_t process_state_req (const gcs_action& act);
+
+    /*! returns action buffer to where it was allocated from */
+    void release (const gcs_action& act);
+
+private:
+
+    gu::Config&                  conf_;
+    gcache::GCache               gcache_;
+    galera::DummyGcs             gcs_;     // service thread needs one
+    galera::ServiceThd           service_thd_;
+    galera::Certification        cert_;
+    galera::TrxHandle::SlavePool trx_pool_;
+    galera::ist::AsyncSenderMap  ist_senders_;
+    gu::UUID                     uuid_;
+    gcs_seqno_t                  cc_seqno_;
+    int                          proto_ver_;
+
+    IstDonor (const IstDonor&);
+    IstDonor& operator= (const IstDonor&);
+
+}; /* class IstDonor */
+
+} /* namespace garb */
+
+#endif /* _GARB_IST_HPP_ */
@@ -24,7 +24,9 @@ RecvLoop::RecvLoop (const Config& config)
     gconf_ (),
     params_(gconf_),
     parse_ (gconf_, config_.options()),
-    gcs_   (gconf_, config_.name(), config_.address(), config_.group())
+    ist_   (config_.ist_donor() ? new IstDonor(gconf_, config_.workdir()) : 0),
+    gcs_   (gconf_, ist_.get() ? ist_->gcache() : 0,
+            config_.name(), config_.address(), config_.group())
 {
     /* set up signal handlers */
     global_gcs = &gcs_;
@@ -62,6 +64,8 @@ RecvLoop::loop()
         switch (act.type)
         {
         case GCS_ACT_TORDERED:
+            if (ist_.get()) ist_->process_trx(act);
+
             if (gu_unlikely(!(act.seqno_g & 127)))
                 /* == report_interval_ of 128 */
             {
@@ -69,15 +73,19 @@ RecvLoop::loop()
             }
             break;
         case GCS_ACT_COMMIT_CUT:
+            if (ist_.get()) ist_->process_commit_cut(act);
             break;
         case GCS_ACT_STATE_REQ:
-            gcs_.join (-ENOSYS); /* we can't donate state */
+            /* we can't donate state, only writesets from GCache */
+            gcs_.join (ist_.get() ? ist_->process_state_req(act) : -ENOSYS);
             break;
         case GCS_ACT_CONF:
         {
             const gcs_act_conf_t* const cc
                 (reinterpret_cast<const gcs_act_conf_t*>(act.buf));
 
+            if (ist_.get()) ist_->process_conf(*cc);
+
             if (cc->conf_id > 0) /* PC */
             {
                 if (GCS_NODE_STATE_PRIM == cc->my_state)
@@ -111,7 +119,10 @@ RecvLoop::loop()
 
         if (act.buf)
         {
-            free (const_cast<void*>(act.buf));
+            if (ist_.get())
+                ist_->release(act);
+            else
+                free (const_cast<void*>(act.buf));
         }
     }
 }
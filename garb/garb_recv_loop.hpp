@@ -5,12 +5,15 @@
 
 #include "garb_gcs.hpp"
 #include "garb_config.hpp"
+#include "garb_ist.hpp"
 
 #include <gu_throw.hpp>
 #include <gu_asio.hpp>
 
 #include <pthread.h>
 
+#include <memory>
+
 namespace garb
 {
 
@@ -34,6 +37,7 @@ private:
         RegisterParams(gu::Config& cnf)
         {
             gu::ssl_register_params(cnf);
+            IstDonor::register_params(cnf);
             if (gcs_register_params(reinterpret_cast<gu_config_t*>(&cnf)))
             {
                 gu_throw_fatal << "Error initializing GCS parameters";
@@ -51,6 +55,8 @@ private:
     }
         parse_;
 
+    /* must outlive gcs_ which allocates from its GCache */
+    std::auto_ptr<IstDonor> ist_;
     Gcs           gcs_;
 }; /* RecvLoop */
 
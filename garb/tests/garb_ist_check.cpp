@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ */
+
+#include "garb_ist.hpp"
+
+#include "replicator_smm.hpp"
+
+#include <gu_byteswap.h>
+
+#include <check.h>
+
+#include <sstream>
+#include <cstring>
+#include <unistd.h>
+
+using galera::TrxHandle;
+
+static std::string const GCACHE_FILE("garb_ist_check.cache");
+
+static int const REPL_PROTO_VER(5);
+static int const TRX_PROTO_VER (3);
+
+static gcache::GCache&
+donor_gcache(garb::IstDonor& donor)
+{
+    return *reinterpret_cast<gcache::GCache*>(donor.gcache());
+}
+
+static void
+donor_conf(garb::IstDonor&       donor,
+           const wsrep_uuid_t&   uuid,
+           gcs_seqno_t     const seqno)
+{
+    gcs_act_conf_t cc;
+    memset(&cc, 0, sizeof(cc));
+
+    cc.seqno          = seqno;
+    cc.conf_id        = seqno + 1;
+    memcpy(cc.uuid, &uuid, sizeof(cc.uuid));
+    cc.memb_num       = 1;
+    cc.my_state       = GCS_NODE_STATE_SYNCED;
+    cc.repl_proto_ver = REPL_PROTO_VER;
+
+    donor.process_conf(cc);
+}
+
+/* replicates writeset with seqno to donor, like recv loop does,
+ * corrupt payload fails checksum after certification */
+static void
+donor_trx(garb::IstDonor&             donor,
+          TrxHandle::LocalPool&       lp,
+          const wsrep_uuid_t&         uuid,
+          gcs_seqno_t           const seqno,
+          bool                  const corrupt = false)
+{
+    TrxHandle::Params const trx_params("", TRX_PROTO_VER,
+                                       galera::KeySet::MAX_VERSION);
+    TrxHandle* const trx(TrxHandle::New(lp, trx_params, uuid, 1, seqno));
+
+    char const key_str[] = { char('0' + seqno % 10), char('0' + seqno / 10) };
+    wsrep_buf_t const key = { key_str, sizeof(key_str) };
+
+    trx->append_key(galera::KeyData(TRX_PROTO_VER, &key, 1,
+                                    WSREP_KEY_EXCLUSIVE, true));
+    trx->append_data("bar", 3, WSREP_DATA_ORDERED, true);
+
+    galera::WriteSetNG::GatherVector bufs;
+    ssize_t const size(trx->write_set_out().gather(trx->source_id(),
+                                                   trx->conn_id(),
+                                                   trx->trx_id(),
+                                                   bufs));
+    trx->set_last_seen_seqno(seqno - 1);
+
+    gu::byte_t* const ptr(static_cast<gu::byte_t*>
+                          (donor_gcache(donor).malloc(size)));
+    gu::byte_t* p(ptr);
+    for (size_t i(0); i < bufs->size(); ++i)
+    {
+        ::memcpy(p, bufs[i].ptr, bufs[i].size); p += bufs[i].size;
+    }
+    trx->unref();
+
+    if (corrupt) ptr[size - 1] ^= 0xff;
+
+    gcs_action const act = { ptr, size, seqno, seqno, GCS_ACT_TORDERED };
+    donor.process_trx(act);
+}
+
+static gcs_seqno_t
+donor_state_req(garb::IstDonor&    donor,
+                const std::string& sst,
+                const std::string& ist)
+{
+    static char const MAGIC[] = "STRv1";
+
+    std::vector<char> req(sizeof(MAGIC));
+    ::memcpy(&req[0], MAGIC, sizeof(MAGIC));
+
+    uint32_t len(htogl(sst.length()));
+    req.insert(req.end(), reinterpret_cast<char*>(&len),
+               reinterpret_cast<char*>(&len) + sizeof(len));
+    req.insert(req.end(), sst.begin(), sst.end());
+
+    len = htogl(ist.length());
+    req.insert(req.end(), reinterpret_cast<char*>(&len),
+               reinterpret_cast<char*>(&len) + sizeof(len));
+    req.insert(req.end(), ist.begin(), ist.end());
+
+    gcs_action const act = { &req[0], ssize_t(req.size()), 100, 100,
+                             GCS_ACT_STATE_REQ };
+
+    return donor.process_state_req(act);
+}
+
+static std::string
+ist_req(const wsrep_uuid_t& uuid, gcs_seqno_t const last_applied,
+        gcs_seqno_t const group_seqno, const std::string& peer)
+{
+    std::ostringstream os;
+    os << gu::UUID(*reinterpret_cast<const gu_uuid_t*>(&uuid))
+       << ':' << last_applied << '-' << group_seqno << '|' << peer;
+    return os.str();
+}
+
+START_TEST(test_ist_donor)
+{
+    gu::Config conf;
+    garb::IstDonor::register_params(conf);
+    conf.set("gcache.name", GCACHE_FILE);
+    conf.set("gcache.size", "1M");
+
+    wsrep_uuid_t uuid;
+    gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&uuid), 0, 0);
+    wsrep_uuid_t foreign;
+    gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&foreign), 0, 0);
+
+    TrxHandle::LocalPool lp(TrxHandle::LOCAL_STORAGE_SIZE(), 4, "garb_ist");
+
+    {
+        garb::IstDonor donor(conf, ".");
+
+        donor_conf(donor, uuid, 0);
+        for (gcs_seqno_t s(1); s <= 3; ++s) donor_trx(donor, lp, uuid, s);
+        donor_conf(donor, uuid, 3);
+
+        // SST can't be served
+        fail_if(donor_state_req(donor, "", "") != -ENOSYS);
+        fail_if(donor_state_req(donor, "rsync", ist_req(uuid, 1, 3, "x"))
+                != -ENOSYS);
+        fail_if(donor_state_req(donor, "", "garbage") != -ENOSYS);
+
+        // IST from other history or from seqno not in cache
+        fail_if(donor_state_req(donor, "", ist_req(foreign, 1, 3, "x"))
+                != -ENOSYS);
+        fail_if(donor_state_req(donor, "", ist_req(uuid, 5, 7, "x"))
+                != -ENODATA);
+
+        // IST to a real receiver
+        gu::Config rconf;
+        galera::ReplicatorSMM::InitConfig(rconf, NULL, NULL);
+        rconf.set(galera::ist::Receiver::RECV_ADDR, "tcp://127.0.0.1:0");
+        TrxHandle::SlavePool sp(sizeof(TrxHandle), 4, "garb_ist");
+        galera::ist::Receiver receiver(rconf, sp, 0);
+        std::string const peer(receiver.prepare(2, 3, REPL_PROTO_VER));
+
+        fail_if(donor_state_req(donor, "", ist_req(uuid, 1, 3, peer)) != 100);
+
+        receiver.ready();
+
+        gcs_seqno_t expected(2);
+        TrxHandle* trx(0);
+        while (receiver.recv(&trx) == 0)
+        {
+            fail_if(trx->global_seqno() != expected);
+            ++expected;
+            trx->unref();
+            trx = 0;
+        }
+        fail_if(expected != 4, "received up to %lld", expected - 1);
+        receiver.finished();
+    }
+
+    ::unlink(GCACHE_FILE.c_str());
+}
+END_TEST
+
+START_TEST(test_ist_donor_bad_trx)
+{
+    gu::Config conf;
+    garb::IstDonor::register_params(conf);
+    conf.set("gcache.name", GCACHE_FILE);
+    conf.set("gcache.size", "1M");
+
+    wsrep_uuid_t uuid;
+    gu_uuid_generate(reinterpret_cast<gu_uuid_t*>(&uuid), 0, 0);
+
+    TrxHandle::LocalPool lp(TrxHandle::LOCAL_STORAGE_SIZE(), 4, "garb_ist");
+
+    {
+        garb::IstDonor donor(conf, ".");
+
+        donor_conf(donor, uuid, 0);
+
+        bool thrown(false);
+        try
+        {
+            donor_trx(donor, lp, uuid, 1, true);
+        }
+        catch (gu::Exception& e)
+        {
+            fail_if(e.get_errno() != EINVAL, "%s", e.what());
+            thrown = true;
+        }
+        fail_unless(thrown);
+
+        /* failed trx handle must have been returned to the pool, which
+         * asserts that on destruction together with the donor */
+    }
+
+    ::unlink(GCACHE_FILE.c_str());
+}
+END_TEST
+
+Suite* garb_ist_suite()
+{
+    Suite* s = suite_create("garb::IstDonor");
+    TCase* tc;
+
+    tc = tcase_create("test_ist_donor");
+    tcase_set_timeout(tc, 60);
+    tcase_add_test(tc, test_ist_donor);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("test_ist_donor_bad_trx");
+    tcase_add_test(tc, test_ist_donor_bad_trx);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -15,6 +15,11 @@ namespace gcache
     void
     GCache::reset()
     {
+        {
+            gu::Lock lock(free_mtx);
+            free_pending.clear();
+        }
+
         mem.reset();
         rb.reset();
         ps.reset();
@@ -46,11 +51,15 @@ namespace gcache
         mtx       (),
         cond      (),
 #endif /* HAVE_PSI_INTERFACE */
+        free_mtx  (),
+        free_pending(),
+        free_draining(),
         seqno2ptr (),
         gid       (),
         mem       (params.mem_size(), seqno2ptr, params.debug()),
         rb        (params.rb_name(), params.rb_size(), seqno2ptr, gid,
-                   params.debug(), params.recover()),
+                   params.debug(), params.recover(),
+                   params.huge_pages(), params.numa_node()),
         ps        (params.dir_name(),
                    params.keep_pages_size(),
                    params.page_size(),
@@ -69,11 +78,14 @@ namespace gcache
 #ifndef NDEBUG
         ,buf_tracker()
 #endif
-    {}
+    {
+        ps.set_policy(params.huge_pages(), params.numa_node());
+    }
 
     GCache::~GCache ()
     {
         gu::Lock lock(mtx);
+        drain_frees();
         log_debug << "\n" << "GCache mallocs : " << mallocs
                   << "\n" << "GCache reallocs: " << reallocs
                   << "\n" << "GCache frees   : " << frees;
@@ -82,6 +94,7 @@ namespace gcache
     size_t GCache::allocated_pool_size ()
     {
         gu::Lock lock(mtx);
+        drain_frees();
         return mem.allocated_pool_size() +
                rb.allocated_pool_size() +
                ps.allocated_pool_size();
@@ -16,6 +16,7 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 #ifndef NDEBUG
 #include <set>
 #endif
@@ -211,6 +212,8 @@ namespace gcache
             size_t keep_pages_count()    const { return keep_pages_count_; }
             int    debug()               const { return debug_;           }
             bool   recover()             const { return recover_;         }
+            bool   huge_pages()          const { return huge_pages_;      }
+            int    numa_node()           const { return numa_node_;       }
 
             bool skip_purge(seqno_t seqno)
             {
@@ -239,6 +242,8 @@ namespace gcache
             int               debug_;
             bool        const recover_;
             seqno_t           freeze_purge_at_seqno_;
+            bool        const huge_pages_;
+            int         const numa_node_;
         }
             params;
 
@@ -250,6 +255,13 @@ namespace gcache
         gu::Cond        cond;
 #endif /* HAVE_PSI_INTERFACE */
 
+        /* Unordered buffers freed by free() are queued here and returned
+         * to their stores by the next thread that takes mtx (seqno_release()
+         * from service thread included), so that free() never waits for
+         * allocation or seqno_release(). Page store buffers are not queued.*/
+        gu::Mutex                  free_mtx;
+        std::vector<BufferHeader*> free_pending;
+        std::vector<BufferHeader*> free_draining; // protected by mtx
 
         seqno2ptr_t     seqno2ptr;
         gu::UUID        gid;
@@ -272,6 +284,9 @@ namespace gcache
 
         void discard_buffer (BufferHeader* bh);
 
+        /* returns pending free()'d buffers to stores, must hold mtx */
+        void drain_frees ();
+
         /* returns true when successfully discards all seqnos up to s */
         bool discard_seqno (int64_t s);
 
@@ -102,6 +102,8 @@ namespace gcache
 
             gu::Lock lock(mtx);
 
+            drain_frees();
+
             mallocs++;
 
             ptr = mem.malloc(size);
@@ -187,18 +189,52 @@ namespace gcache
         seqno_released = new_released;
     }
 
+    void
+    GCache::drain_frees ()
+    {
+        assert(free_draining.empty());
+
+        {
+            gu::Lock lock(free_mtx);
+            if (gu_likely(free_pending.empty())) return;
+            free_draining.swap(free_pending);
+        }
+
+        for (size_t i(0); i < free_draining.size(); ++i)
+        {
+            free_common (free_draining[i]);
+        }
+
+        free_draining.clear(); // keeps capacity for the next swap
+    }
+
     void
     GCache::free (void* ptr)
     {
         if (gu_likely(0 != ptr))
         {
             BufferHeader* const bh(ptr2BH(ptr));
-            gu::Lock      lock(mtx);
 
 #ifndef NDEBUG
             if (params.debug()) { log_info << "GCache::free() " << bh; }
 #endif
-            free_common (bh);
+            /* Unordered buffers are not in seqno2ptr and don't move
+             * seqno_released, so their release can be deferred. The caller
+             * owns the buffer, so reading seqno_g here is safe. Page store
+             * buffers are freed right away to unmap their pages even if
+             * no other thread comes to drain them. */
+            if (gu_likely(SEQNO_NONE == bh->seqno_g &&
+                          BUFFER_IN_PAGE != bh->store))
+            {
+                gu::Lock lock(free_mtx);
+                free_pending.push_back(bh);
+            }
+            else
+            {
+                gu::Lock lock(mtx);
+                drain_frees();
+                free_common (bh);
+            }
         }
         else {
             log_warn << "Attempt to free a null pointer";
@@ -237,6 +273,8 @@ namespace gcache
 
         gu::Lock      lock(mtx);
 
+        drain_frees();
+
         reallocs++;
 
         MemOps* store(0);
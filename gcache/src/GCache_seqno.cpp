@@ -5,6 +5,7 @@
 #include "gcache_bh.hpp"
 #include "GCache.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <cassert>
 
@@ -21,6 +22,8 @@ namespace gcache
     {
         gu::Lock lock(mtx);
 
+        drain_frees();
+
         assert(seqno2ptr.empty() || seqno_max == seqno2ptr.rbegin()->first);
 
         if (g == gid && s != SEQNO_ILL && seqno_max >= s)
@@ -95,6 +98,9 @@ namespace gcache
          * we want to allow some concurrency in cache access by releasing
          * buffers in small batches */
         static int const min_batch_size(32);
+        /* upper bound on how long a single batch may hold mtx and so block
+         * allocations from the receiving thread */
+        static int const max_batch_size(1024);
 
         /* Although extremely unlikely, theoretically concurrent access may
          * lead to elements being added faster than released. The following is
@@ -112,6 +118,8 @@ namespace gcache
 
             gu::Lock lock(mtx);
 
+            drain_frees();
+
             assert(seqno >= seqno_released);
 
             seqno2ptr_iter_t it(seqno2ptr.upper_bound(seqno_released));
@@ -135,6 +143,7 @@ namespace gcache
              * and if not - increase the batch_size (linearly) */
             size_t const new_gap(seqno_max - seqno_released);
             batch_size += (new_gap >= old_gap) * min_batch_size;
+            batch_size  = std::min(batch_size, max_batch_size);
             old_gap = new_gap;
 
             int64_t const start(it->first - 1);
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * Ring buffer throughput benchmark, meant to compare gcache.huge_pages and
+ * gcache.numa_node settings.
+ *
+ * Usage: gcache_bench [rb size] [buffer size] [passes] [huge pages] [node]
+ */
+
+#include "GCache.hpp"
+
+#include <gu_logger.hpp>
+#include <gu_exception.hpp>
+#include <gu_time.h>
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace gcache;
+
+static void
+faults (long& minor, long& major)
+{
+    struct rusage ru;
+    getrusage (RUSAGE_SELF, &ru);
+    minor = ru.ru_minflt;
+    major = ru.ru_majflt;
+}
+
+int
+main (int argc, char* argv[])
+{
+    std::string const rb_size (argc > 1 ? argv[1] : "128M");
+    ssize_t     const buf_size(argc > 2 ? atol(argv[2]) : 4096);
+    int         const passes  (argc > 3 ? atoi(argv[3]) : 8);
+    std::string const huge    (argc > 4 ? argv[4] : "no");
+    std::string const node    (argc > 5 ? argv[5] : "-1");
+
+    gu_conf_self_tstamp_on ();
+
+    try
+    {
+        gu::Config conf;
+        GCache::register_params(conf);
+        conf.parse("gcache.name = bench.cache; gcache.size = " + rb_size +
+                   "; gcache.page_size = " + rb_size +
+                   "; gcache.huge_pages = " + huge +
+                   "; gcache.numa_node = " + node);
+
+        GCache cache(conf, "");
+
+        /* stay well below ring buffer size so that no pages are created */
+        size_t  const per_pass(conf.get<size_t>("gcache.size") / 4 * 3 /
+                               buf_size);
+        int64_t seqno(0);
+
+        std::vector<GCache::Buffer> bufs(1024);
+
+        long min0, maj0;
+        faults (min0, maj0);
+
+        double alloc_time(0), scan_time(0);
+        double bytes(0);
+
+        for (int p(0); p < passes; ++p)
+        {
+            int64_t const first(seqno + 1);
+            double t(gu_time_monotonic());
+
+            for (size_t i(0); i < per_pass; ++i)
+            {
+                void* const ptr(cache.malloc(buf_size));
+                ::memset (ptr, i, buf_size);
+                ++seqno;
+                cache.seqno_assign(ptr, seqno, seqno - 1);
+                cache.free(ptr);
+            }
+
+            alloc_time += gu_time_monotonic() - t;
+            t = gu_time_monotonic();
+
+            long long sum(0);
+            for (int64_t s(first); s <= seqno; )
+            {
+                size_t const n(cache.seqno_get_buffers(bufs, s));
+                if (0 == n) break;
+
+                for (size_t i(0); i < n; ++i)
+                {
+                    const gu::byte_t* const b(bufs[i].ptr());
+                    for (ssize_t j(0); j < bufs[i].size(); j += 64) sum+=b[j];
+                }
+
+                s += n;
+            }
+            cache.seqno_unlock();
+
+            scan_time += gu_time_monotonic() - t;
+            bytes += double(per_pass) * buf_size;
+
+            cache.seqno_release(seqno);
+
+            if (0 == sum) { log_debug << "checksum " << sum; } // keep loop
+        }
+
+        long min1, maj1;
+        faults (min1, maj1);
+
+        double const mb(bytes / (1 << 20));
+
+        printf ("rb size: %s, buffer: %zd, passes: %d, huge pages: %s, "
+                "node: %s\n", rb_size.c_str(), buf_size, passes,
+                huge.c_str(), node.c_str());
+        printf ("alloc: %.1f MB/s, scan: %.1f MB/s, "
+                "minor faults: %ld, major faults: %ld\n",
+                mb * 1.0e9 / alloc_time, mb * 1.0e9 / scan_time,
+                min1 - min0, maj1 - maj0);
+    }
+    catch (gu::Exception& e)
+    {
+        log_error << e.what();
+        return 1;
+    }
+
+    ::unlink("bench.cache");
+
+    return 0;
+}
@@ -48,8 +48,10 @@ gcache::Page::drop_fs_cache() const
 #endif
 }
 
-gcache::Page::Page (void* ps, const std::string& name, size_t size, int dbg)
+gcache::Page::Page (void* ps, const std::string& name, size_t size, int dbg,
+                    bool const huge_pages, int const numa_node)
     :
+    numa_ (numa_node),
 #ifdef HAVE_PSI_INTERFACE
     fd_   (name, WSREP_PFS_INSTR_TAG_GCACHE_PAGE_FILE, size, true, false),
 #else
@@ -64,9 +66,15 @@ gcache::Page::Page (void* ps, const std::string& name, size_t size, int dbg)
     min_space_ (space_),
     debug_(dbg)
 {
+    /* before the first access through the mapping */
+    if (huge_pages)     mmap_.huge_pages();
+    if (numa_node >= 0) mmap_.prefer_node(numa_node);
+
     log_info << "Created page " << name << " of size " << space_
              << " bytes";
     BH_clear (reinterpret_cast<BufferHeader*>(next_));
+
+    numa_.reset();
 }
 
 void*
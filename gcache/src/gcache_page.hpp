@@ -23,7 +23,9 @@ namespace gcache
     {
     public:
 
-        Page (void* ps, const std::string& name, size_t size, int dbg);
+        /* huge_pages and numa_node: see RingBuffer */
+        Page (void* ps, const std::string& name, size_t size, int dbg,
+              bool huge_pages = false, int numa_node = -1);
         ~Page () {}
 
         void* malloc  (size_type size);
@@ -71,6 +73,7 @@ namespace gcache
 
     private:
 
+        gu::PreferredNode  numa_; // in effect only during construction
         gu::FileDescriptor fd_;
         gu::MMap           mmap_;
         void* const        ps_;
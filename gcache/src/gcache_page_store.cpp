@@ -177,7 +177,8 @@ inline void
 gcache::PageStore::new_page (size_type size)
 {
     Page* const page(new Page
-                     (this, make_page_name (base_name_, count_), size, debug_));
+                     (this, make_page_name (base_name_, count_), size, debug_,
+                      huge_pages_, numa_node_));
 
     pages_.push_back (page);
     total_size_ += page->size();
@@ -200,7 +201,9 @@ gcache::PageStore::PageStore (const std::string& dir_name,
     current_   (0),
     total_size_(0),
     delete_page_attr_(),
-    debug_     (dbg & DEBUG)
+    debug_     (dbg & DEBUG),
+    huge_pages_(false),
+    numa_node_ (-1)
 #ifndef GCACHE_DETACH_THREAD
     , delete_thr_(pthread_t(-1))
 #endif /* GCACHE_DETACH_THREAD */
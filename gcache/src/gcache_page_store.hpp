@@ -55,6 +55,13 @@ namespace gcache
 
         void  set_keep_count (size_t count) { keep_page_ = count; cleanup();}
 
+        /* applied to every page created after the call */
+        void  set_policy (bool huge_pages, int numa_node)
+        {
+            huge_pages_ = huge_pages;
+            numa_node_  = numa_node;
+        }
+
         size_t allocated_pool_size ();
 
         void  set_debug(int dbg);
@@ -79,6 +86,8 @@ namespace gcache
         size_t            total_size_;
         pthread_attr_t    delete_page_attr_;
         int               debug_;
+        bool              huge_pages_;
+        int               numa_node_;
 #ifndef GCACHE_DETACH_THREAD
         pthread_t         delete_thr_;
 #endif /* GCACHE_DETACH_THREAD */
@@ -26,6 +26,17 @@ static const std::string GCACHE_PARAMS_RECOVER    ("gcache.recover");
 static const std::string GCACHE_DEFAULT_RECOVER   ("no");
 static const std::string GCACHE_PARAMS_FREEZE_PURGE_SEQNO("gcache.freeze_purge_at_seqno");
 static const std::string GCACHE_DEFAULT_FREEZE_PURGE_SEQNO("-1");
+/* Both are best effort placement hints for ring buffer and page store files.
+ * gcache files are regular shared file mappings, so huge pages take effect
+ * only on tmpfs mounted with huge= option or with file THP support. NUMA node
+ * is preferred by the thread while it creates, preallocates and first
+ * touches the file, and by the mapping policy, which the kernel follows only
+ * for tmpfs. Pages faulted later by other threads follow their policy.
+ * gcache.mem_size store is plain heap and is not covered. */
+static const std::string GCACHE_PARAMS_HUGE_PAGES ("gcache.huge_pages");
+static const std::string GCACHE_DEFAULT_HUGE_PAGES("no");
+static const std::string GCACHE_PARAMS_NUMA_NODE  ("gcache.numa_node");
+static const std::string GCACHE_DEFAULT_NUMA_NODE ("-1");
 
 void
 gcache::GCache::Params::register_params(gu::Config& cfg)
@@ -42,6 +53,8 @@ gcache::GCache::Params::register_params(gu::Config& cfg)
 #endif
     cfg.add(GCACHE_PARAMS_RECOVER,         GCACHE_DEFAULT_RECOVER);
     cfg.add(GCACHE_PARAMS_FREEZE_PURGE_SEQNO, GCACHE_DEFAULT_FREEZE_PURGE_SEQNO);
+    cfg.add(GCACHE_PARAMS_HUGE_PAGES,      GCACHE_DEFAULT_HUGE_PAGES);
+    cfg.add(GCACHE_PARAMS_NUMA_NODE,       GCACHE_DEFAULT_NUMA_NODE);
 }
 
 static const std::string&
@@ -84,7 +97,9 @@ gcache::GCache::Params::Params (gu::Config& cfg, const std::string& data_dir)
     debug_    (0),
 #endif
     recover_  (cfg.get<bool>(GCACHE_PARAMS_RECOVER)),
-    freeze_purge_at_seqno_(cfg.get<seqno_t>(GCACHE_PARAMS_FREEZE_PURGE_SEQNO))
+    freeze_purge_at_seqno_(cfg.get<seqno_t>(GCACHE_PARAMS_FREEZE_PURGE_SEQNO)),
+    huge_pages_(cfg.get<bool>(GCACHE_PARAMS_HUGE_PAGES)),
+    numa_node_ (cfg.get<int>(GCACHE_PARAMS_NUMA_NODE))
 {}
 
 void
@@ -160,6 +175,14 @@ gcache::GCache::param_set (const std::string& key, const std::string& val)
                           params.keep_pages_count() :
                           !((params.mem_size() + params.rb_size()) > 0));
     }
+    else if (key == GCACHE_PARAMS_HUGE_PAGES)
+    {
+        gu_throw_error(EPERM) << "Can't change huge page policy in runtime.";
+    }
+    else if (key == GCACHE_PARAMS_NUMA_NODE)
+    {
+        gu_throw_error(EPERM) << "Can't change NUMA node in runtime.";
+    }
     else if (key == GCACHE_PARAMS_RECOVER)
     {
         gu_throw_error(EINVAL) << "'" << key
@@ -48,8 +48,11 @@ namespace gcache
                             seqno2ptr_t&       seqno2ptr,
                             gu::UUID&          gid,
                             int const          dbg,
-                            bool const         recover)
+                            bool const         recover,
+                            bool const         huge_pages,
+                            int const          numa_node)
     :
+        numa_      (numa_node),
 #ifdef HAVE_PSI_INTERFACE
         fd_        (name, WSREP_PFS_INSTR_TAG_RINGBUFFER_FILE, check_size(size)),
 #else
@@ -77,9 +80,17 @@ namespace gcache
         open_      (true)
     {
         assert((uintptr_t(start_) % MemOps::ALIGNMENT) == 0);
+
+        /* before the first access through the mapping, file creation and
+         * preallocation above were done under numa_ */
+        if (huge_pages)     mmap_.huge_pages();
+        if (numa_node >= 0) mmap_.prefer_node(numa_node);
+
         constructor_common ();
         open_preamble(recover);
         BH_clear (BH_cast(next_));
+
+        numa_.reset();
     }
 
     RingBuffer::~RingBuffer ()
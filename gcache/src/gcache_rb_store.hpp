@@ -28,7 +28,9 @@ namespace gcache
                     seqno2ptr_t&       seqno2ptr,
                     gu::UUID&          gid,
                     int                dbg,
-                    bool               recover);
+                    bool               recover,
+                    bool               huge_pages = false,
+                    int                numa_node  = -1);
 
         ~RingBuffer ();
 
@@ -139,6 +141,7 @@ namespace gcache
 
         static int    const DEBUG = 2; // debug flag
 
+        gu::PreferredNode  numa_;     // in effect only during construction
         gu::FileDescriptor fd_;
         gu::MMap           mmap_;
         char*        const preamble_; // ASCII text preamble
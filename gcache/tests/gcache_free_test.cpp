@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * $Id$
+ */
+
+#include "GCache.hpp"
+#include "gcache_free_test.hpp"
+
+#include <gu_logger.hpp>
+#include <gu_threads.h>
+
+#include <cstring>
+#include <unistd.h>
+
+using namespace gcache;
+
+static std::string const RB_NAME("free_test");
+
+/* page store buffers are not deferred and their pages are discarded by
+ * free() itself */
+START_TEST(page)
+{
+    gu::Config conf;
+    GCache::register_params(conf);
+    conf.parse("gcache.name = " + RB_NAME + "; gcache.size = 1M; "
+               "gcache.page_size = 1M; gcache.keep_pages_count = 1");
+
+    {
+        GCache gc(conf, "");
+
+        void* const p1(gc.malloc(2 << 20));
+        void* const p2(gc.malloc(2 << 20));
+        fail_if (NULL == p1);
+        fail_if (NULL == p2);
+        fail_if (!gc.cleanup_required(), "expected 2 pages");
+
+        gc.free(p1);
+        gc.free(p2);
+        fail_if (gc.cleanup_required(), "pages were not discarded by free()");
+    }
+
+    ::unlink(RB_NAME.c_str());
+}
+END_TEST
+
+static int const FREE_THREADS(4);
+static int const FREE_LOOPS  (10000);
+
+static void* free_thread(void* arg)
+{
+    GCache& gc(*static_cast<GCache*>(arg));
+
+    for (int i(0); i < FREE_LOOPS; ++i)
+    {
+        size_t const size(64 + (i % 16) * 64);
+        void* const  ptr(gc.malloc(size));
+        fail_if (NULL == ptr);
+        ::memset(ptr, i, size);
+        gc.free(ptr);
+    }
+
+    return NULL;
+}
+
+/* concurrent free() of unordered buffers is deferred, pending frees are
+ * drained by allocations of other threads and by seqno_release() */
+START_TEST(contention)
+{
+    gu::Config conf;
+    GCache::register_params(conf);
+    conf.parse("gcache.name = " + RB_NAME + "; gcache.size = 1M; "
+               "gcache.mem_size = 16M");
+
+    {
+        GCache gc(conf, "");
+
+        size_t const pool_size(gc.allocated_pool_size());
+
+        gu_thread_t threads[FREE_THREADS];
+
+        for (int i(0); i < FREE_THREADS; ++i)
+        {
+            fail_if (gu_thread_create(&threads[i], NULL, free_thread, &gc));
+        }
+
+        for (int i(0); i < FREE_LOOPS; ++i) gc.seqno_release(1);
+
+        for (int i(0); i < FREE_THREADS; ++i)
+        {
+            gu_thread_join(threads[i], NULL);
+        }
+
+        /* leftovers of the last frees are still pending */
+        void* const ptr(gc.malloc(64));
+        fail_if (NULL == ptr);
+        gc.free(ptr);
+
+        gc.seqno_release(1);
+
+        fail_if (gc.allocated_pool_size() != pool_size,
+                 "allocated pool size %zu, expected %zu",
+                 gc.allocated_pool_size(), pool_size);
+    }
+
+    ::unlink(RB_NAME.c_str());
+}
+END_TEST
+
+Suite* gcache_free_suite()
+{
+    Suite* ts = suite_create("gcache::GCache::free");
+    TCase* tc = tcase_create("page");
+
+    tcase_add_test(tc, page);
+    suite_add_tcase(ts, tc);
+
+    tc = tcase_create("contention");
+    tcase_set_timeout(tc, 60);
+    tcase_add_test(tc, contention);
+    suite_add_tcase(ts, tc);
+
+    return ts;
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * $Id$
+ */
+#ifndef __gcache_free_test_hpp__
+#define __gcache_free_test_hpp__
+
+extern "C" {
+#include <check.h>
+}
+
+extern Suite* gcache_free_suite();
+
+#endif // __gcache_free_test_hpp__
@@ -8,6 +8,12 @@
 #include "gcache_bh.hpp"
 #include "gcache_page_test.hpp"
 
+#include <cerrno>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 using namespace gcache;
 
 void ps_free (void* ptr)
@@ -115,6 +121,50 @@ START_TEST(test3) // check that all page size is efficiently used
 }
 END_TEST
 
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+static int
+mempolicy (void* const addr, unsigned long& mask)
+{
+    static int const MPOL_F_ADDR_(2); /* from <numaif.h> */
+    int mode(-1);
+
+    mask = 0;
+    if (::syscall(SYS_get_mempolicy, &mode, &mask, sizeof(mask) * 8 + 1,
+                  addr, addr ? MPOL_F_ADDR_ : 0)) return -errno;
+
+    return mode;
+}
+
+START_TEST(policy) // placement policy is applied to new pages
+{
+    static int const MPOL_PREFERRED_(1);
+
+    unsigned long mask0;
+    int const mode0(mempolicy(NULL, mask0));
+
+    if (mode0 < 0) return; /* kernel without NUMA support */
+
+    gcache::PageStore ps ("", 0, 1 << 20, 0, false);
+    ps.set_policy(true, 0);
+
+    void* const buf(ps.malloc(1024));
+    fail_if (0 == buf);
+
+    unsigned long mask;
+    int const mode(mempolicy(buf, mask));
+    fail_if (MPOL_PREFERRED_ != mode, "page policy: %d", mode);
+    fail_if (1 != mask, "page node mask: %lx", mask);
+
+    /* thread policy must be restored after page creation */
+    fail_if (mode0 != mempolicy(NULL, mask));
+    fail_if (mask0 != mask);
+
+    ps_free(buf);
+    ps.discard(ptr2BH(buf));
+}
+END_TEST
+#endif /* __linux__ && SYS_get_mempolicy */
+
 Suite* gcache_page_suite()
 {
     Suite* s = suite_create("gcache::PageStore");
@@ -124,6 +174,9 @@ Suite* gcache_page_suite()
     tcase_add_test(tc, test1);
     tcase_add_test(tc, test2);
     tcase_add_test(tc, test3);
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    tcase_add_test(tc, policy);
+#endif
     suite_add_tcase(s, tc);
 
     return s;
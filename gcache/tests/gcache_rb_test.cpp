@@ -7,6 +7,7 @@
 #define GCACHE_RB_UNIT_TEST
 
 #include "gcache_rb_store.hpp"
+#include "GCache.hpp"
 #include "gcache_bh.hpp"
 #include "gcache_rb_test.hpp"
 
@@ -508,6 +509,45 @@ START_TEST(recovery)
 }
 END_TEST
 
+START_TEST(policy) // placement parameters are parsed and are startup-only
+{
+    gu::Config conf;
+    GCache::register_params(conf);
+    conf.parse("gcache.name = " + RB_NAME + "; gcache.size = 1M; "
+               "gcache.huge_pages = yes; gcache.numa_node = 0");
+
+    {
+        GCache gc(conf, "");
+
+        void* const ptr(gc.malloc(1024));
+        fail_if (NULL == ptr);
+        gc.free(ptr);
+
+        try
+        {
+            gc.param_set("gcache.numa_node", "1");
+            fail("runtime change of gcache.numa_node must fail");
+        }
+        catch (gu::Exception& e)
+        {
+            fail_if (EPERM != e.get_errno(), "%d", e.get_errno());
+        }
+    }
+
+    ::unlink(RB_NAME.c_str());
+
+    conf.set("gcache.numa_node", "first");
+
+    try
+    {
+        GCache gc(conf, "");
+        fail("invalid gcache.numa_node must be rejected");
+    }
+    catch (gu::Exception&) {}
+
+    ::unlink(RB_NAME.c_str());
+}
+END_TEST
 
 Suite* gcache_rb_suite()
 {
@@ -524,5 +564,9 @@ Suite* gcache_rb_suite()
     tcase_add_test(tc, recovery);
     suite_add_tcase(ts, tc);
 
+    tc = tcase_create("policy");
+    tcase_add_test(tc, policy);
+    suite_add_tcase(ts, tc);
+
     return ts;
 }
@@ -31,7 +31,15 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
     mtu_(1 << 15),
     checksum_(NetHeader::checksum_type(
                   conf.get<int>(gcomm::Conf::SocketChecksum,
-                                NetHeader::CS_CRC32C)))
+                                NetHeader::CS_CRC32C))),
+    io_threads_(),
+    io_work_(0),
+    dispatch_mutex_(),
+    dispatch_cond_(),
+    dispatch_q_(),
+    interrupted_(false),
+    io_error_(0),
+    io_error_msg_()
 {
     conf.set(gcomm::Conf::SocketChecksum, checksum_);
     // use ssl if either private key or cert file is specified
@@ -50,11 +58,110 @@ gcomm::AsioProtonet::AsioProtonet(gu::Config& conf, int version)
         log_info << "initializing ssl context";
         gu::ssl_prepare_context(conf_, ssl_context_);
     }
+
+    int n_io_threads(
+        check_range(gcomm::Conf::SocketIoThreads,
+                    conf.get<int>(gcomm::Conf::SocketIoThreads, 0),
+                    0, 65));
+    // Composed SSL operations on a stream are not thread safe, async reads
+    // would race with writes initiated from the event loop thread.
+    if (n_io_threads > 0 && use_ssl == true)
+    {
+        log_warn << gcomm::Conf::SocketIoThreads << " = " << n_io_threads
+                 << " is not supported with SSL, using event loop thread";
+        n_io_threads = 0;
+    }
+    conf.set(gcomm::Conf::SocketIoThreads, n_io_threads);
+    if (n_io_threads > 0)
+    {
+        io_work_ = new asio::io_service::work(io_service_);
+        for (int i(0); i < n_io_threads; ++i)
+        {
+            gu_thread_t thd;
+            int err;
+            if ((err = gu_thread_create(&thd, 0, &io_thread_fn, this)) != 0)
+            {
+                stop_io_threads();
+                gu_throw_error(err) << "failed to create socket I/O thread";
+            }
+            io_threads_.push_back(thd);
+        }
+        log_info << "started " << n_io_threads << " socket I/O threads";
+    }
 }
 
 gcomm::AsioProtonet::~AsioProtonet()
 {
+    stop_io_threads();
+}
+
+
+void gcomm::AsioProtonet::stop_io_threads()
+{
+    if (io_work_ == 0) return;
+
+    delete io_work_;
+    io_work_ = 0;
+    io_service_.stop();
+    for (std::vector<gu_thread_t>::iterator i(io_threads_.begin());
+         i != io_threads_.end(); ++i)
+    {
+        gu_thread_join(*i, 0);
+    }
+    io_threads_.clear();
+}
+
+
+void* gcomm::AsioProtonet::io_thread_fn(void* arg)
+{
+    static_cast<AsioProtonet*>(arg)->io_thread();
+    return 0;
+}
+
 
+//
+// Socket I/O thread main loop. All socket handlers lock the protonet
+// mutex for socket state changes, socket events are passed to the event
+// loop thread through dispatch queue.
+//
+void gcomm::AsioProtonet::io_thread()
+{
+    while (true)
+    {
+        try
+        {
+            io_service_.run();
+            break;
+        }
+        catch (gu::Exception& e)
+        {
+            io_error(e.get_errno(), e.what());
+        }
+        catch (asio::system_error& e)
+        {
+            io_error(e.code().value(), e.what());
+        }
+        catch (std::exception& e)
+        {
+            io_error(0, e.what());
+        }
+    }
+}
+
+//
+// Passes the error to the event loop thread, which throws it from
+// event_loop(). Only the first error is kept.
+//
+void gcomm::AsioProtonet::io_error(int const err, const char* const msg)
+{
+    log_error << "exception from socket I/O thread: " << msg;
+    gu::Lock lock(dispatch_mutex_);
+    if (io_error_ == 0)
+    {
+        io_error_ = (err != 0 ? err : EPROTO);
+        io_error_msg_ = msg;
+    }
+    dispatch_cond_.signal();
 }
 
 void gcomm::AsioProtonet::enter()
@@ -106,6 +213,12 @@ gu::datetime::Period handle_timers_helper(gcomm::Protonet&            pnet,
 
 void gcomm::AsioProtonet::event_loop(const gu::datetime::Period& period)
 {
+    if (io_work_ != 0)
+    {
+        io_event_loop(period);
+        return;
+    }
+
     io_service_.reset();
     poll_until_ = gu::datetime::Date::now() + period;
 
@@ -117,10 +230,85 @@ void gcomm::AsioProtonet::event_loop(const gu::datetime::Period& period)
 }
 
 
+//
+// Event loop for the case when socket I/O is done in dedicated threads.
+// Socket events are dequeued from dispatch queue and passed to
+// protostacks in this thread in the order they were queued, timers
+// are handled between the batches.
+//
+void gcomm::AsioProtonet::io_event_loop(const gu::datetime::Period& period)
+{
+    poll_until_ = gu::datetime::Date::now() + period;
+
+    std::deque<DispatchItem> q;
+    while (true)
+    {
+        const gu::datetime::Period p(
+            handle_timers_helper(*this,
+                                 poll_until_ - gu::datetime::Date::now()));
+        {
+            gu::Lock lock(dispatch_mutex_);
+            if (io_error_ != 0)
+            {
+                const int err(io_error_);
+                io_error_ = 0;
+                gu_throw_error(err) << io_error_msg_;
+            }
+            if (interrupted_ == true)
+            {
+                interrupted_ = false;
+                break;
+            }
+            if (dispatch_q_.empty() == true && p.get_nsecs() > 0)
+            {
+                try
+                {
+                    lock.wait(dispatch_cond_, gu::datetime::Date::now() + p);
+                }
+                catch (gu::Exception& e)
+                {
+                    if (e.get_errno() != ETIMEDOUT) throw;
+                }
+            }
+            q.swap(dispatch_q_);
+        }
+
+        if (q.empty() == false)
+        {
+            Critical<AsioProtonet> crit(*this);
+            while (q.empty() == false)
+            {
+                const DispatchItem& item(q.front());
+                for (std::deque<Protostack*>::iterator i = protos_.begin();
+                     i != protos_.end(); ++i)
+                {
+                    (*i)->dispatch(item.id_, item.dg_, item.um_);
+                }
+                q.pop_front();
+            }
+        }
+
+        using std::rel_ops::operator>=;
+        if (gu::datetime::Date::now() >= poll_until_)
+        {
+            break;
+        }
+    }
+}
+
+
 void gcomm::AsioProtonet::dispatch(const SocketId& id,
                                    const Datagram& dg,
                                    const ProtoUpMeta& um)
 {
+    if (io_work_ != 0)
+    {
+        gu::Lock lock(dispatch_mutex_);
+        dispatch_q_.push_back(DispatchItem(id, dg, um));
+        if (dispatch_q_.size() == 1) dispatch_cond_.signal();
+        return;
+    }
+
     for (std::deque<Protostack*>::iterator i = protos_.begin();
          i != protos_.end(); ++i)
     {
@@ -131,6 +319,13 @@ void gcomm::AsioProtonet::dispatch(const SocketId& id,
 
 void gcomm::AsioProtonet::interrupt()
 {
+    if (io_work_ != 0)
+    {
+        gu::Lock lock(dispatch_mutex_);
+        interrupted_ = true;
+        dispatch_cond_.signal();
+        return;
+    }
     io_service_.stop();
 }
 
@@ -10,6 +10,7 @@
 
 #include "gu_monitor.hpp"
 #include "gu_asio.hpp"
+#include "gu_threads.h"
 
 #include <vector>
 #include <deque>
@@ -45,9 +46,33 @@ private:
     friend class AsioTcpAcceptor;
     friend class AsioUdpSocket;
     AsioProtonet(const AsioProtonet&);
+    void operator=(const AsioProtonet&);
 
     void handle_wait(const asio::error_code& ec);
 
+    // Event loop and I/O thread routines used when socket I/O is
+    // done in dedicated threads (socket.io_threads > 0)
+    void io_event_loop(const gu::datetime::Period& p);
+    static void* io_thread_fn(void* arg);
+    void io_thread();
+    void io_error(int err, const char* msg);
+    void stop_io_threads();
+
+    // Socket event queued by I/O thread for event loop thread
+    struct DispatchItem
+    {
+        DispatchItem(const SocketId& id, const Datagram& dg,
+                     const ProtoUpMeta& um)
+            : id_(id), dg_(dg), um_(um) { }
+        DispatchItem(const DispatchItem& other)
+            : id_(other.id_), dg_(other.dg_), um_(other.um_) { }
+        SocketId    id_;
+        Datagram    dg_;
+        ProtoUpMeta um_;
+    private:
+        void operator=(const DispatchItem&);
+    };
+
     gu::RecursiveMutex          mutex_;
     gu::datetime::Date          poll_until_;
     asio::io_service            io_service_;
@@ -56,6 +81,15 @@ private:
     size_t                      mtu_;
 
     NetHeader::checksum_t       checksum_;
+
+    std::vector<gu_thread_t>    io_threads_;
+    asio::io_service::work*     io_work_;
+    gu::Mutex                   dispatch_mutex_;
+    gu::Cond                    dispatch_cond_;
+    std::deque<DispatchItem>    dispatch_q_;
+    bool                        interrupted_;
+    int                         io_error_;
+    std::string                 io_error_msg_;
 };
 
 #endif // GCOMM_ASIO_PROTONET_HPP
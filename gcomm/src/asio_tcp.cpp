@@ -416,6 +416,18 @@ int gcomm::AsioTcpSocket::send(const Datagram& dg)
 void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
                                         const size_t bytes_transferred)
 {
+    // Messages are unserialized and checksums verified before entering
+    // critical section so that this work can proceed in socket I/O
+    // thread concurrently with protocol processing. Receive buffer is
+    // accessed only from read handlers and there is at most one read
+    // outstanding at the time.
+    std::deque<Datagram> dgs;
+    asio::error_code read_ec;
+    if (!ec)
+    {
+        read_ec = read_messages(bytes_transferred, dgs);
+    }
+
     Critical<AsioProtonet> crit(net_);
 
     if (ec)
@@ -439,6 +451,30 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
         return;
     }
 
+    for (std::deque<Datagram>::const_iterator i(dgs.begin());
+         i != dgs.end(); ++i)
+    {
+        ProtoUpMeta um;
+        net_.dispatch(id(), *i, um);
+    }
+
+    if (read_ec)
+    {
+        FAILED_HANDLER(read_ec);
+        return;
+    }
+
+    gu::array<asio::mutable_buffer, 1>::type mbs;
+    mbs[0] = asio::mutable_buffer(&recv_buf_[0] + recv_offset_,
+                                  recv_buf_.size() - recv_offset_);
+    read_one(mbs);
+}
+
+
+asio::error_code
+gcomm::AsioTcpSocket::read_messages(const size_t bytes_transferred,
+                                    std::deque<Datagram>& dgs)
+{
     recv_offset_ += bytes_transferred;
 
     while (recv_offset_ >= NetHeader::serial_size_)
@@ -450,9 +486,8 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
         }
         catch (gu::Exception& e)
         {
-            FAILED_HANDLER(asio::error_code(e.get_errno(),
-                                            asio::error::system_category));
-            return;
+            return asio::error_code(e.get_errno(),
+                                    asio::error::system_category);
         }
         if (recv_offset_ >= hdr.len() + NetHeader::serial_size_)
         {
@@ -477,14 +512,11 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
                              << " has_crc32="  << hdr.has_crc32()
                              << " has_crc32c=" << hdr.has_crc32c()
                              << " crc32=" << hdr.crc32();
-                    FAILED_HANDLER(asio::error_code(
-                                       EPROTO,
-                                       asio::error::system_category));
-                    return;
+                    return asio::error_code(EPROTO,
+                                            asio::error::system_category);
                 }
             }
-            ProtoUpMeta um;
-            net_.dispatch(id(), dg, um);
+            dgs.push_back(dg);
             recv_offset_ -= NetHeader::serial_size_ + hdr.len();
 
             if (recv_offset_ > 0)
@@ -499,11 +531,7 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
             break;
         }
     }
-
-    gu::array<asio::mutable_buffer, 1>::type mbs;
-    mbs[0] = asio::mutable_buffer(&recv_buf_[0] + recv_offset_,
-                                  recv_buf_.size() - recv_offset_);
-    read_one(mbs);
+    return asio::error_code();
 }
 
 size_t gcomm::AsioTcpSocket::read_completion_condition(
@@ -735,7 +763,7 @@ gcomm::AsioTcpAcceptor::AsioTcpAcceptor(AsioProtonet& net, const gu::URI& uri)
     Acceptor        (uri),
     net_            (net),
     acceptor_       (net_.io_service_),
-    accepted_socket_()
+    accepted_sockets_()
 {
 
 }
@@ -750,6 +778,7 @@ void gcomm::AsioTcpAcceptor::accept_handler(
     SocketPtr socket,
     const asio::error_code& error)
 {
+    Critical<AsioProtonet> crit(net_);
     if (!error)
     {
         AsioTcpSocket* s(static_cast<AsioTcpSocket*>(socket.get()));
@@ -775,7 +804,7 @@ void gcomm::AsioTcpAcceptor::accept_handler(
             {
                 s->state_ = Socket::S_CONNECTED;
             }
-            accepted_socket_ = socket;
+            accepted_sockets_.push_back(socket);
             log_debug << "accepted socket " << socket->id();
             net_.dispatch(id(), Datagram(), ProtoUpMeta(error.value()));
         }
@@ -874,9 +903,13 @@ void gcomm::AsioTcpAcceptor::close()
 
 gcomm::SocketPtr gcomm::AsioTcpAcceptor::accept()
 {
-    if (accepted_socket_->state() == Socket::S_CONNECTED)
+    Critical<AsioProtonet> crit(net_);
+    gcomm_assert(accepted_sockets_.empty() == false);
+    SocketPtr accepted_socket(accepted_sockets_.front());
+    accepted_sockets_.pop_front();
+    if (accepted_socket->state() == Socket::S_CONNECTED)
     {
-        accepted_socket_->async_receive();
+        accepted_socket->async_receive();
     }
-    return accepted_socket_;
+    return accepted_socket;
 }
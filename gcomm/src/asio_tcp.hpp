@@ -57,6 +57,8 @@ public:
         const size_t bytes_transferred);
     void read_handler(const asio::error_code& ec,
                       const size_t bytes_transferred);
+    asio::error_code read_messages(size_t bytes_transferred,
+                                   std::deque<Datagram>& dgs);
     void async_receive();
     size_t mtu() const;
     std::string local_addr() const;
@@ -138,7 +140,8 @@ private:
 
     AsioProtonet& net_;
     asio::ip::tcp::acceptor acceptor_;
-    SocketPtr accepted_socket_;
+    // Accepted sockets waiting for accept() call
+    std::deque<SocketPtr> accepted_sockets_;
 };
 
 #if defined(__GNUG__)
@@ -22,6 +22,8 @@ std::string const gcomm::Conf::SocketChecksum =
     SocketPrefix + "checksum";
 std::string const gcomm::Conf::SocketRecvBufSize =
     SocketPrefix + "recv_buf_size";
+std::string const gcomm::Conf::SocketIoThreads =
+    SocketPrefix + "io_threads";
 
 // GMCast
 std::string const gcomm::Conf::GMCastScheme = "gmcast";
@@ -50,6 +52,8 @@ std::string const gcomm::Conf::GMCastIsolate =
     GMCastPrefix + "isolate";
 std::string const gcomm::Conf::GMCastSegment =
     GMCastPrefix + "segment";
+std::string const gcomm::Conf::GMCastSegmentFanout =
+    GMCastPrefix + "segment_fanout";
 
 // EVS
 std::string const gcomm::Conf::EvsScheme = "evs";
@@ -80,6 +84,8 @@ std::string const gcomm::Conf::EvsSendWindow =
     EvsPrefix + "send_window";
 std::string const gcomm::Conf::EvsUserSendWindow =
     EvsPrefix + "user_send_window";
+std::string const gcomm::Conf::EvsUserSendWindowAuto =
+    EvsPrefix + "user_send_window_auto";
 std::string const gcomm::Conf::EvsUseAggregate =
     EvsPrefix + "use_aggregate";
 std::string const gcomm::Conf::EvsCausalKeepalivePeriod =
@@ -130,6 +136,7 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD        (TcpNonBlocking);
     GCOMM_CONF_ADD_DEFAULT(SocketChecksum);
     GCOMM_CONF_ADD_DEFAULT(SocketRecvBufSize);
+    GCOMM_CONF_ADD_DEFAULT(SocketIoThreads);
 
     GCOMM_CONF_ADD_DEFAULT(GMCastVersion);
     GCOMM_CONF_ADD        (GMCastGroup);
@@ -144,6 +151,7 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD        (GMCastPeerAddr);
     GCOMM_CONF_ADD        (GMCastIsolate);
     GCOMM_CONF_ADD_DEFAULT(GMCastSegment);
+    GCOMM_CONF_ADD_DEFAULT(GMCastSegmentFanout);
 
     GCOMM_CONF_ADD        (EvsVersion);
     GCOMM_CONF_ADD_DEFAULT(EvsViewForgetTimeout);
@@ -158,6 +166,7 @@ gcomm::Conf::register_params(gu::Config& cnf)
     GCOMM_CONF_ADD        (EvsInfoLogMask);
     GCOMM_CONF_ADD_DEFAULT(EvsSendWindow);
     GCOMM_CONF_ADD_DEFAULT(EvsUserSendWindow);
+    GCOMM_CONF_ADD_DEFAULT(EvsUserSendWindowAuto);
     GCOMM_CONF_ADD        (EvsUseAggregate);
     GCOMM_CONF_ADD        (EvsCausalKeepalivePeriod);
     GCOMM_CONF_ADD_DEFAULT(EvsMaxInstallTimeouts);
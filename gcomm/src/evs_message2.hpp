@@ -491,7 +491,8 @@ public:
     DelegateMessage(const int     version   = -1,
                     const UUID&   source         = UUID::nil(),
                     const ViewId& source_view_id = ViewId(),
-                    const int64_t fifo_seq       = -1) :
+                    const int64_t fifo_seq       = -1,
+                    const uint8_t flags          = 0) :
         Message(version,
                 EVS_T_DELEGATE,
                 source,
@@ -499,7 +500,11 @@ public:
                 ViewId(),
                 0xff,
                 O_UNRELIABLE,
-                fifo_seq)
+                fifo_seq,
+                -1,
+                -1,
+                -1,
+                flags)
     { }
     size_t serialize(gu::byte_t* buf, size_t buflen, size_t offset) const;
     size_t unserialize(const gu::byte_t* buf, size_t buflen, size_t offset,
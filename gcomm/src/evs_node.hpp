@@ -101,6 +101,7 @@ public:
 
     void set_fifo_seq(const int64_t seq) { fifo_seq_ = seq; }
     int64_t fifo_seq() const { return fifo_seq_; }
+    void set_segment(const SegmentId segment) { segment_ = segment; }
     SegmentId segment() const { return segment_; }
 
     bool is_inactive() const;
@@ -63,6 +63,8 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
     sent_msgs_(7, 0),
     retrans_msgs_(0),
     recovered_msgs_(0),
+    retrans_msgs_by_reason_(RR_MAX, 0),
+    retrans_bytes_by_reason_(RR_MAX, 0),
     recvd_msgs_(7, 0),
     delivered_msgs_(O_LOCAL_CAUSAL + 1),
     send_user_prof_    ("send_user"),
@@ -182,8 +184,23 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
                                    Defaults::EvsUserSendWindow),
                     gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin),
                     send_window_ + 1)),
+    user_send_window_auto_(param<bool>(conf, uri, Conf::EvsUserSendWindowAuto,
+                                       Defaults::EvsUserSendWindowAuto)),
+    user_send_window_cur_(user_send_window_),
+    uw_round_end_(-1),
+    uw_round_lat_(0),
+    uw_round_n_(0),
+    uw_round_retrans_(0),
+    uw_round_limited_(false),
+    uw_base_lat_(0),
     output_(),
     send_buf_(),
+    retrans_buf_(),
+    retrans_buf_reason_(RR_GAP),
+    retrans_buf_recovered_(false),
+    retrans_buf_msgs_(0),
+    retrans_buf_bytes_(0),
+    recovery_reqs_(),
     max_output_size_(128),
     mtu_(mtu),
     use_aggregate_(param<bool>(conf, uri, Conf::EvsUseAggregate, "true")),
@@ -212,6 +229,8 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
              gu::to_string(causal_keepalive_period_));
     conf.set(Conf::EvsSendWindow, gu::to_string(send_window_));
     conf.set(Conf::EvsUserSendWindow, gu::to_string(user_send_window_));
+    conf.set(Conf::EvsUserSendWindowAuto,
+             gu::to_string(user_send_window_auto_));
     conf.set(Conf::EvsUseAggregate, gu::to_string(use_aggregate_));
     conf.set(Conf::EvsDebugLogMask, gu::to_string(debug_mask_, std::hex));
     conf.set(Conf::EvsInfoLogMask, gu::to_string(info_mask_, std::hex));
@@ -225,6 +244,7 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
         std::make_pair(my_uuid_, Node(*this)));
     self_i_ = known_.begin();
     assert(NodeMap::value(self_i_).operational() == true);
+    NodeMap::value(self_i_).set_segment(segment_);
 
     NodeMap::value(self_i_).set_index(0);
     input_map_->reset(1);
@@ -271,6 +291,7 @@ gcomm::evs::Proto::set_param(const std::string& key, const std::string& val,
                                    user_send_window_,
                                    std::numeric_limits<seqno_t>::max());
         conf_.set(Conf::EvsSendWindow, gu::to_string(send_window_));
+        user_send_window_cur_ = std::min(user_send_window_cur_, send_window_);
         return true;
     }
     else if (key == gcomm::Conf::EvsUserSendWindow)
@@ -281,6 +302,16 @@ gcomm::evs::Proto::set_param(const std::string& key, const std::string& val,
             gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin),
             send_window_ + 1);
         conf_.set(Conf::EvsUserSendWindow, gu::to_string(user_send_window_));
+        user_send_window_cur_ = user_send_window_;
+        return true;
+    }
+    else if (key == gcomm::Conf::EvsUserSendWindowAuto)
+    {
+        user_send_window_auto_ = gu::from_string<bool>(val);
+        conf_.set(Conf::EvsUserSendWindowAuto,
+                  gu::to_string(user_send_window_auto_));
+        user_send_window_cur_ = user_send_window_;
+        uw_round_end_ = -1;
         return true;
     }
     else if (key == gcomm::Conf::EvsMaxInstallTimeouts)
@@ -446,6 +477,8 @@ void gcomm::evs::Proto::handle_get_status(gu::Status& status) const
 {
     status.insert("evs_state", to_string(state_));
     status.insert("evs_repl_latency", safe_deliv_latency_.to_string());
+    status.insert("evs_user_send_window",
+                  gu::to_string(user_send_window_cur_));
     std::string delayed_list_str;
     for (DelayedList::const_iterator i(delayed_list_.begin());
          i != delayed_list_.end(); ++i)
@@ -501,6 +534,15 @@ void gcomm::evs::Proto::handle_get_status(gu::Status& status) const
         status.insert("evs_deliv_safe",
                       gu::to_string(delivered_msgs_[O_SAFE]));
     }
+
+    for (int i(0); i < RR_MAX; ++i)
+    {
+        const std::string reason(to_string(static_cast<RetransReason>(i)));
+        status.insert("evs_retrans_" + reason + "_msgs",
+                      gu::to_string(retrans_msgs_by_reason_[i]));
+        status.insert("evs_retrans_" + reason + "_bytes",
+                      gu::to_string(retrans_bytes_by_reason_[i]));
+    }
 }
 
 
@@ -1688,10 +1730,10 @@ void gcomm::evs::Proto::complete_user(const seqno_t high_seq)
 }
 
 
-int gcomm::evs::Proto::send_delegate(Datagram& wb)
+int gcomm::evs::Proto::send_delegate(Datagram& wb, uint8_t flags)
 {
     DelegateMessage dm(version_, uuid(), current_view_.id(),
-                       ++fifo_seq_);
+                       ++fifo_seq_, flags);
     push_header(dm, wb);
     int ret = send_down(wb, ProtoDownMeta());
     pop_header(dm, wb);
@@ -2055,7 +2097,118 @@ void gcomm::evs::Proto::send_delayed_list()
     handle_delayed_list(elm, self_i_);
 }
 
-void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
+std::string gcomm::evs::Proto::to_string(RetransReason reason)
+{
+    switch (reason)
+    {
+    case RR_GAP:        return "gap";
+    case RR_DELAYED:    return "delayed";
+    case RR_MEMBERSHIP: return "membership";
+    default:            return "unknown";
+    }
+}
+
+
+bool gcomm::evs::Proto::combine_retrans() const
+{
+    // Receivers older than protocol version 2 don't understand
+    // combined delegate messages.
+    return (use_aggregate_ == true && current_view_.version() > 1);
+}
+
+
+void gcomm::evs::Proto::count_retrans(RetransReason const reason,
+                                      bool const          recovered,
+                                      long long int const msgs,
+                                      long long int const bytes)
+{
+    if (recovered == true)
+    {
+        recovered_msgs_ += msgs;
+    }
+    else
+    {
+        retrans_msgs_ += msgs;
+    }
+    retrans_msgs_by_reason_[reason] += msgs;
+    retrans_bytes_by_reason_[reason] += bytes;
+}
+
+
+int gcomm::evs::Proto::retrans_flush()
+{
+    if (retrans_buf_.empty() == true)
+    {
+        return 0;
+    }
+    Datagram dg(gu::SharedBuffer(new gu::Buffer(retrans_buf_.begin(),
+                                                retrans_buf_.end())));
+    retrans_buf_.clear();
+    const int err(send_delegate(dg, Message::F_AGGREGATE));
+    if (err == 0)
+    {
+        count_retrans(retrans_buf_reason_, retrans_buf_recovered_,
+                      retrans_buf_msgs_, retrans_buf_bytes_);
+    }
+    retrans_buf_msgs_ = 0;
+    retrans_buf_bytes_ = 0;
+    return err;
+}
+
+
+//
+// Append message with header pushed into retransmission buffer. Buffered
+// messages are sent as a single delegate message once the buffer
+// would grow over mtu. Each message is prefixed with AggregateMessage
+// header which carries the length of the message.
+//
+int gcomm::evs::Proto::retrans_append(Datagram& rb,
+                                      RetransReason const reason,
+                                      bool const recovered)
+{
+    const AggregateMessage am(0, std::min(rb.len(), size_t(0xffff)));
+    const size_t len(rb.len() + am.serial_size());
+    const size_t max_len(std::min(mtu(), size_t(0xffff)));
+    int err(0);
+
+    if (retrans_buf_.size() + len > max_len)
+    {
+        if ((err = retrans_flush()) != 0)
+        {
+            return err;
+        }
+    }
+
+    if (len > max_len)
+    {
+        // Message does not fit into combined datagram, send it alone
+        if ((err = send_delegate(rb)) == 0)
+        {
+            count_retrans(reason, recovered, 1, rb.len());
+        }
+        return err;
+    }
+
+    size_t offset(retrans_buf_.size());
+    retrans_buf_.resize(offset + len);
+    gu_trace(offset = am.serialize(&retrans_buf_[0],
+                                   retrans_buf_.size(), offset));
+    std::copy(rb.header() + rb.header_offset(),
+              rb.header() + rb.header_size(),
+              &retrans_buf_[0] + offset);
+    offset += rb.header_len();
+    std::copy(rb.payload().begin(), rb.payload().end(),
+              &retrans_buf_[0] + offset);
+    retrans_buf_reason_ = reason;
+    retrans_buf_recovered_ = recovered;
+    ++retrans_buf_msgs_;
+    retrans_buf_bytes_ += rb.len();
+    return 0;
+}
+
+
+void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range,
+                               RetransReason reason)
 {
     gcomm_assert(gap_source != uuid());
     gcomm_assert(range.lu() <= range.hs()) <<
@@ -2076,6 +2229,7 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
                              << range.lu() << " -> "
                              << range.hs();
 
+    const bool combine(combine_retrans());
     seqno_t seq(range.lu());
     while (seq <= range.hs())
     {
@@ -2112,12 +2266,16 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
                        msg.fifo_seq(),
                        msg.user_type(),
                        static_cast<uint8_t>(
+                           (combine ? Message::F_SOURCE : 0) |
                            Message::F_RETRANS |
                            (msg.flags() & Message::F_AGGREGATE)));
 
         push_header(um, rb);
 
-        int err = send_down(rb, ProtoDownMeta());
+        // combined messages are counted once actually sent
+        int err = (combine == true ?
+                   retrans_append(rb, reason, false) :
+                   send_down(rb, ProtoDownMeta()));
         if (err != 0)
         {
             log_debug << "send failed: " << strerror(err);
@@ -2128,14 +2286,83 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
             evs_log_debug(D_RETRANS) << "retransmitted " << um;
         }
         seq = seq + msg.seq_range() + 1;
-        retrans_msgs_++;
+        if (combine == false)
+        {
+            count_retrans(reason, false, 1, rb.len());
+        }
+    }
+
+    if (combine == true)
+    {
+        int err;
+        if ((err = retrans_flush()) != 0)
+        {
+            log_debug << "send failed: " << strerror(err);
+        }
     }
 }
 
 
+//
+// Choose single node to answer recovery request from gap_source so that
+// not all the members flood the network with the same messages.
+// Only nodes whose reported aru covers the whole requested range are
+// eligible, those are known to hold all the requested messages. Node from
+// the same segment as the requester is preferred, ties are broken by the
+// lowest UUID. If no node qualifies or the same request is seen again,
+// all the nodes take part in recovery.
+//
+bool gcomm::evs::Proto::is_recovery_peer(const UUID& gap_source,
+                                         const UUID& range_uuid,
+                                         const Range range)
+{
+    std::map<UUID, std::pair<UUID, seqno_t> >::iterator
+        ri(recovery_reqs_.find(gap_source));
+    const std::pair<UUID, seqno_t> req(range_uuid, range.lu());
+    if (ri != recovery_reqs_.end() && ri->second == req)
+    {
+        evs_log_debug(D_RETRANS) << "repeated recovery request from "
+                                 << gap_source << " " << range;
+        recovery_reqs_.erase(ri);
+        return true;
+    }
+    recovery_reqs_[gap_source] = req;
+
+    NodeMap::const_iterator si(known_.find(gap_source));
+    if (si == known_.end())
+    {
+        return true;
+    }
+    const SegmentId segment(NodeMap::value(si).segment());
+
+    const UUID* peer(0);
+    bool peer_local(false);
+    for (NodeMap::const_iterator i(known_.begin()); i != known_.end(); ++i)
+    {
+        const UUID& uuid(NodeMap::key(i));
+        const Node& node(NodeMap::value(i));
+        if (uuid == gap_source || uuid == range_uuid ||
+            node.operational() == false ||
+            node.index() == std::numeric_limits<size_t>::max() ||
+            input_map_->safe_seq(node.index()) < range.hs())
+        {
+            continue;
+        }
+        const bool local(node.segment() == segment);
+        if (peer == 0 || (local == true && peer_local == false))
+        {
+            peer = &uuid;
+            peer_local = local;
+        }
+    }
+    return (peer == 0 || *peer == uuid());
+}
+
+
 void gcomm::evs::Proto::recover(const UUID& gap_source,
                                 const UUID& range_uuid,
-                                const Range range)
+                                const Range range,
+                                RetransReason reason)
 {
     gcomm_assert(gap_source != uuid())
         << "gap_source (" << gap_source << ") == uuid() (" << uuid()
@@ -2161,7 +2388,7 @@ void gcomm::evs::Proto::recover(const UUID& gap_source,
                              << " requested range " << range
                              << " available " << im_range;
 
-
+    const bool combine(combine_retrans());
     seqno_t seq(range.lu());
     while (seq <= range.hs() && seq <= im_range.hs())
     {
@@ -2200,7 +2427,8 @@ void gcomm::evs::Proto::recover(const UUID& gap_source,
 
         push_header(um, rb);
 
-        int err = send_delegate(rb);
+        int err = (combine == true ?
+                   retrans_append(rb, reason, true) : send_delegate(rb));
         if (err != 0)
         {
             log_debug << "send failed: " << strerror(err);
@@ -2211,7 +2439,19 @@ void gcomm::evs::Proto::recover(const UUID& gap_source,
             evs_log_debug(D_RETRANS) << "recover " << um;
         }
         seq = seq + msg.seq_range() + 1;
-        recovered_msgs_++;
+        if (combine == false)
+        {
+            count_retrans(reason, true, 1, rb.len());
+        }
+    }
+
+    if (combine == true)
+    {
+        int err;
+        if ((err = retrans_flush()) != 0)
+        {
+            log_debug << "send failed: " << strerror(err);
+        }
     }
 }
 
@@ -2624,12 +2864,13 @@ int gcomm::evs::Proto::handle_down(Datagram& wb, const ProtoDownMeta& dm)
         err = send_user(wb,
                         dm.user_type(),
                         dm.order(),
-                        user_send_window_,
+                        user_send_window_cur_,
                         -1);
 
         switch (err)
         {
         case EAGAIN:
+            uw_round_limited_ = true;
             output_.push_back(std::make_pair(wb, dm));
             // fall through
         case 0:
@@ -2642,6 +2883,7 @@ int gcomm::evs::Proto::handle_down(Datagram& wb, const ProtoDownMeta& dm)
     }
     else if (output_.size() < max_output_size_)
     {
+        uw_round_limited_ = true;
         output_.push_back(std::make_pair(wb, dm));
     }
     else
@@ -2896,6 +3138,8 @@ void gcomm::evs::Proto::shift_to(const State s, const bool send_j)
 
         input_map_->reset(current_view_.members().size());
         last_sent_ = -1;
+        uw_round_end_ = -1;
+        recovery_reqs_.clear();
         state_ = S_OPERATIONAL;
         deliver_reg_view(*install_message_, previous_view_);
 
@@ -2979,6 +3223,7 @@ void gcomm::evs::Proto::validate_reg_msg(const UserMessage& msg)
                        gu::datetime::Sec);
             if (info_mask_ & I_STATISTICS) hs_safe_.insert(lat);
             safe_deliv_latency_.insert(lat);
+            if (user_send_window_auto_) adapt_user_send_window(msg.seq(), lat);
         }
         else if (msg.order() == O_AGREED)
         {
@@ -2992,6 +3237,73 @@ void gcomm::evs::Proto::validate_reg_msg(const UserMessage& msg)
 }
 
 
+// Adjusts user send window once per round in AIMD fashion: halves it if
+// own messages had to be retransmitted, shrinks it by a quarter if latency
+// has grown well above the lowest observed (messages are queueing up
+// somewhere) and grows it by one if the window was exhausted during the
+// round. Window stays between user window minimum and send window.
+// UW_LAT_SLACK (seconds) keeps sub-millisecond jitter from being taken for
+// queueing.
+static double const UW_LAT_SLACK(0.001);
+
+void gcomm::evs::Proto::adapt_user_send_window(seqno_t const seq,
+                                               double const  lat)
+{
+    uw_round_lat_ += lat;
+    ++uw_round_n_;
+
+    if (seq < uw_round_end_) return;
+
+    if (uw_round_end_ != -1)
+    {
+        double const avg_lat(uw_round_lat_/uw_round_n_);
+        long long int const retrans(retrans_msgs_ - uw_round_retrans_);
+        seqno_t const min_win(
+            gu::from_string<seqno_t>(Defaults::EvsUserSendWindowMin));
+        seqno_t const prev_win(user_send_window_cur_);
+
+        if (retrans > 0)
+        {
+            user_send_window_cur_ = std::max(min_win, prev_win/2);
+        }
+        else if (uw_base_lat_ > 0 &&
+                 avg_lat > 2*uw_base_lat_ + UW_LAT_SLACK)
+        {
+            user_send_window_cur_ = std::max(min_win, prev_win - prev_win/4);
+        }
+        else if (uw_round_limited_)
+        {
+            user_send_window_cur_ = std::min(send_window_, prev_win + 1);
+        }
+
+        // Base latency follows the minimum but creeps up slowly to
+        // adapt to path changes.
+        if (uw_base_lat_ == 0 || avg_lat < uw_base_lat_)
+        {
+            uw_base_lat_ = avg_lat;
+        }
+        else
+        {
+            uw_base_lat_ += (avg_lat - uw_base_lat_)/64;
+        }
+
+        if (user_send_window_cur_ != prev_win)
+        {
+            evs_log_debug(D_USER_MSGS)
+                << "user send window " << prev_win << " -> "
+                << user_send_window_cur_ << ", latency " << avg_lat
+                << " base " << uw_base_lat_ << " retrans " << retrans;
+        }
+    }
+
+    uw_round_end_     = last_sent_ + 1;
+    uw_round_lat_     = 0;
+    uw_round_n_       = 0;
+    uw_round_retrans_ = retrans_msgs_;
+    uw_round_limited_ = false;
+}
+
+
 void gcomm::evs::Proto::deliver_finish(const InputMapMsg& msg)
 {
     if ((msg.msg().flags() & Message::F_AGGREGATE) == 0)
@@ -3492,10 +3804,39 @@ void gcomm::evs::Proto::handle_delegate(const DelegateMessage& msg,
 {
     gcomm_assert(ii != known_.end());
     evs_log_debug(D_DELEGATE_MSGS) << "delegate message " << msg;
-    Message umsg;
-    size_t offset;
-    gu_trace(offset = unserialize_message(UUID::nil(), rb, &umsg));
-    gu_trace(handle_msg(umsg, Datagram(rb, offset), false));
+    if ((msg.flags() & Message::F_AGGREGATE) == 0)
+    {
+        Message umsg;
+        size_t offset;
+        gu_trace(offset = unserialize_message(UUID::nil(), rb, &umsg));
+        gu_trace(handle_msg(umsg, Datagram(rb, offset), false));
+        return;
+    }
+
+    // Combined retransmission, see retrans_append()
+    const gu::byte_t* const begin(gcomm::begin(rb));
+    const size_t available(gcomm::available(rb));
+    size_t offset(0);
+    while (offset < available)
+    {
+        AggregateMessage am;
+        gu_trace(offset = am.unserialize(begin, available, offset));
+        if (offset + am.len() > available)
+        {
+            gu_throw_error(EINVAL) << "combined delegate message frame "
+                                   << "length " << am.len()
+                                   << " exceeds available "
+                                   << available - offset;
+        }
+        Datagram dg(gu::SharedBuffer(
+                        new gu::Buffer(begin + offset,
+                                       begin + offset + am.len())));
+        offset += am.len();
+        Message umsg;
+        size_t umsg_offset;
+        gu_trace(umsg_offset = unserialize_message(UUID::nil(), dg, &umsg));
+        gu_trace(handle_msg(umsg, Datagram(dg, umsg_offset), false));
+    }
 }
 
 
@@ -3623,13 +3964,16 @@ void gcomm::evs::Proto::handle_gap(const GapMessage& msg, NodeMap::iterator ii)
         if (msg.range().lu() <= upper_bound)
         {
             gu_trace(resend(msg.source(),
-                            Range(msg.range().lu(), upper_bound)));
+                            Range(msg.range().lu(), upper_bound),
+                            RR_GAP));
         }
     }
     else if ((msg.flags() & Message::F_RETRANS) != 0 &&
-             msg.source() != uuid())
+             msg.source() != uuid() &&
+             is_recovery_peer(msg.source(), msg.range_uuid(), msg.range()))
     {
-        gu_trace(recover(msg.source(), msg.range_uuid(), msg.range()));
+        gu_trace(recover(msg.source(), msg.range_uuid(), msg.range(),
+                         RR_DELAYED));
     }
 
     //
@@ -3719,7 +4063,8 @@ void gcomm::evs::Proto::retrans_user(const UUID& nl_uuid,
             // Source member is missing messages from us
             gcomm_assert(mn.im_range().hs() <= last_sent_);
             gu_trace(resend(nl_uuid,
-                            Range(mn.im_range().lu(), last_sent_)));
+                            Range(mn.im_range().lu(), last_sent_),
+                            RR_MEMBERSHIP));
         }
         else if ((mn.operational() == false ||
                   mn.leaving() == true) &&
@@ -3729,7 +4074,8 @@ void gcomm::evs::Proto::retrans_user(const UUID& nl_uuid,
         {
             gu_trace(recover(nl_uuid, node_uuid,
                              Range(mn.im_range().lu(),
-                                   r.hs())));
+                                   r.hs()),
+                             RR_MEMBERSHIP));
         }
     }
 }
@@ -4296,6 +4642,13 @@ void gcomm::evs::Proto::handle_join(const JoinMessage& msg, NodeMap::iterator ii
         }
     }
 
+    // Source reports its own segment in the node list.
+    MessageNodeList::const_iterator source(msg.node_list().find(msg.source()));
+    if (msg.node_list().end() != source)
+    {
+        inst.set_segment(MessageNodeList::value(source).segment());
+    }
+
     // Timestamp source if it sees processing node as operational.
     // Adjust local entry operational status.
     MessageNodeList::const_iterator self(msg.node_list().find(uuid()));
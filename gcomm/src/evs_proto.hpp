@@ -161,7 +161,7 @@ public:
     size_t aggregate_len() const;
     int send_user(const seqno_t);
     void complete_user(const seqno_t);
-    int send_delegate(Datagram&);
+    int send_delegate(Datagram&, uint8_t flags = 0);
     void send_gap(EVS_CALLER_ARG,
                   const UUID&, const ViewId&, const Range,
                   bool commit = false, bool req_all = false);
@@ -173,8 +173,27 @@ public:
     void send_install(EVS_CALLER_ARG);
     void send_delayed_list();
 
-    void resend(const UUID&, const Range);
-    void recover(const UUID&, const UUID&, const Range);
+    /*!
+     * @brief Reasons for message retransmission, used for statistics.
+     */
+    enum RetransReason
+    {
+        RR_GAP,        /*!< Missing messages requested by gap message */
+        RR_DELAYED,    /*!< Messages of delayed node requested from all */
+        RR_MEMBERSHIP, /*!< Messages missing during membership change */
+        RR_MAX
+    };
+    static std::string to_string(RetransReason);
+
+    void resend(const UUID&, const Range, RetransReason reason = RR_GAP);
+    void recover(const UUID&, const UUID&, const Range,
+                 RetransReason reason = RR_GAP);
+    bool is_recovery_peer(const UUID&, const UUID&, const Range);
+    bool combine_retrans() const;
+    int  retrans_append(Datagram&, RetransReason, bool recovered);
+    int  retrans_flush();
+    void count_retrans(RetransReason, bool recovered,
+                       long long int msgs, long long int bytes);
 
     void retrans_user(const UUID&, const MessageNodeList&);
     void retrans_leaves(const MessageNodeList&);
@@ -191,6 +210,7 @@ public:
     size_t n_operational() const;
 
     void validate_reg_msg(const UserMessage&);
+    void adapt_user_send_window(seqno_t seq, double lat);
     void deliver_finish(const InputMapMsg&);
     void deliver();
     void deliver_local(bool trans = false);
@@ -384,6 +404,8 @@ private:
     std::vector<long long int> sent_msgs_;
     long long int retrans_msgs_;
     long long int recovered_msgs_;
+    std::vector<long long int> retrans_msgs_by_reason_;
+    std::vector<long long int> retrans_bytes_by_reason_;
     std::vector<long long int> recvd_msgs_;
     std::vector<long long int> delivered_msgs_;
     prof::Profile send_user_prof_;
@@ -483,9 +505,35 @@ private:
     seqno_t send_window_;
     // User send window size
     seqno_t user_send_window_;
+    // Auto-tune user send window
+    bool user_send_window_auto_;
+    // User send window in effect, differs from user_send_window_ only
+    // if auto-tuning is enabled
+    seqno_t user_send_window_cur_;
+    // Auto-tuning round lasts until the first message sent after
+    // the beginning of the round gets delivered, i.e. for about one
+    // round trip
+    seqno_t uw_round_end_;
+    double uw_round_lat_;
+    size_t uw_round_n_;
+    long long int uw_round_retrans_;
+    // Window was exhausted during the round
+    bool uw_round_limited_;
+    // Lowest average safe delivery latency observed
+    double uw_base_lat_;
     // Output message queue
     std::deque<std::pair<Datagram, ProtoDownMeta> > output_;
     std::vector<gu::byte_t> send_buf_;
+    // Buffer for combining retransmitted messages into single datagram
+    std::vector<gu::byte_t> retrans_buf_;
+    // Messages in retrans_buf_, counted in stats only once it is sent
+    RetransReason retrans_buf_reason_;
+    bool          retrans_buf_recovered_;
+    long long int retrans_buf_msgs_;
+    long long int retrans_buf_bytes_;
+    // Last recovery request range (range source, lowest seqno) per
+    // requesting node
+    std::map<UUID, std::pair<UUID, seqno_t> > recovery_reqs_;
     uint32_t max_output_size_;
     size_t mtu_;
     bool use_aggregate_;
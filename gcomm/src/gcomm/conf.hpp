@@ -68,6 +68,20 @@ namespace gcomm
          */
         static std::string const SocketRecvBufSize;
 
+        /*!
+         * @brief Number of dedicated socket I/O threads
+         *        ("socket.io_threads")
+         *
+         * If set to zero (default), socket I/O, checksumming and
+         * protocol processing are all done in the thread which runs
+         * the Protonet event loop. With non-zero value socket I/O and
+         * checksum verification are done in the given number of
+         * background threads while the protocol stack is still driven
+         * by the event loop thread only. Ignored if SSL is in use,
+         * since SSL streams must not be driven from several threads.
+         */
+        static std::string const SocketIoThreads;
+
         /*!
          * @brief GMCast scheme for transport URI ("gmcast")
          */
@@ -160,6 +174,18 @@ namespace gcomm
          */
         static std::string const GMCastSegment;
 
+        /*!
+         * @brief Fanout of the local segment dissemination tree
+         *        ("gmcast.segment_fanout")
+         *
+         * If set to non-zero value k, user messages are disseminated
+         * inside local segment along k-ary tree rooted at the sender
+         * instead of sending a copy to every peer. Zero (default)
+         * disables the tree. The value must be the same on all nodes
+         * in the segment.
+         */
+        static std::string const GMCastSegmentFanout;
+
 
         /*!
          * @brief EVS scheme for transport URI ("evs")
@@ -286,6 +312,18 @@ namespace gcomm
          */
         static std::string const EvsUserSendWindow;
 
+        /*!
+         * @brief EVS user send window auto-tuning
+         *        ("evs.user_send_window_auto")
+         *
+         * If enabled, Conf::EvsUserSendWindow is only the initial value
+         * of user send window, which is then adjusted between 1 and
+         * Conf::EvsSendWindow: it grows while messages are delivered
+         * without retransmissions and latency increase, and shrinks
+         * otherwise. Disabled by default.
+         */
+        static std::string const EvsUserSendWindowAuto;
+
         /*!
          * @brief EVS message aggregation mode ("evs.use_aggregate")
          *
@@ -107,6 +107,14 @@ gcomm::GMCast::GMCast(Protonet& net, const gu::URI& uri,
     relay_set_    (),
     segment_map_  (),
     self_index_   (std::numeric_limits<size_t>::max()),
+    segment_fanout_(check_range(
+                        Conf::GMCastSegmentFanout,
+                        param<int>(conf_, uri, Conf::GMCastSegmentFanout,
+                                   Defaults::GMCastSegmentFanout),
+                        0, 256)),
+    tree_members_ (),
+    tree_sockets_ (),
+    tree_sent_    (0),
     time_wait_    (param<gu::datetime::Period>(
                        conf_, uri,
                        Conf::GMCastTimeWait, Defaults::GMCastTimeWait)),
@@ -224,6 +232,7 @@ gcomm::GMCast::GMCast(Protonet& net, const gu::URI& uri,
     conf_.set(Conf::GMCastMCastTTL, gu::to_string(mcast_ttl_));
     conf_.set(Conf::GMCastPeerTimeout, gu::to_string(peer_timeout_));
     conf_.set(Conf::GMCastSegment, gu::to_string<int>(segment_));
+    conf_.set(Conf::GMCastSegmentFanout, gu::to_string(segment_fanout_));
 }
 
 gcomm::GMCast::~GMCast()
@@ -377,6 +386,8 @@ void gcomm::GMCast::close(bool force)
     listener_ = 0;
 
     segment_map_.clear();
+    tree_members_.clear();
+    tree_sockets_.clear();
     for (ProtoMap::iterator
              i = proto_map_->begin(); i != proto_map_->end(); ++i)
     {
@@ -995,6 +1006,7 @@ void gcomm::GMCast::update_addresses()
     }
 
     self_index_ = 0;
+    tree_sockets_.clear();
     for (ProtoMap::const_iterator i(proto_map_->begin()); i != proto_map_->end();
          ++i)
     {
@@ -1013,6 +1025,11 @@ void gcomm::GMCast::update_addresses()
                 {
                     ++self_index_;
                 }
+                if (segment_fanout_ > 0 && !mcast_)
+                {
+                    tree_sockets_.insert(
+                        std::make_pair(p.remote_uuid(), p.socket().get()));
+                }
             }
         }
         else
@@ -1305,6 +1322,55 @@ void send(gcomm::Socket* s, gcomm::Datagram& dg)
     }
 }
 
+void gcomm::GMCast::tree_send(const UUID& root, Datagram& dg)
+{
+    const size_t n(tree_members_.size());
+
+    std::vector<UUID>::const_iterator ri(
+        std::lower_bound(tree_members_.begin(), tree_members_.end(), root));
+    std::vector<UUID>::const_iterator si(
+        std::lower_bound(tree_members_.begin(), tree_members_.end(), uuid()));
+    if (ri == tree_members_.end() || *ri != root ||
+        si == tree_members_.end() || *si != uuid())
+    {
+        // Membership differs from the one seen by the root. Nodes
+        // not reached will recover missing messages via EVS.
+        log_debug << self_string() << " tree root " << root
+                  << " not in local segment tree";
+        return;
+    }
+
+    const size_t root_idx(ri - tree_members_.begin());
+    const size_t self_idx(si - tree_members_.begin());
+    const size_t k(segment_fanout_);
+
+    // Positions are relative to root, children of position p are
+    // k*p + 1 ... k*p + k. If a child is not directly reachable,
+    // its subtree is served by this node.
+    std::vector<size_t> pending;
+    pending.push_back((self_idx + n - root_idx) % n);
+    while (pending.empty() == false)
+    {
+        const size_t pos(pending.back());
+        pending.pop_back();
+        for (size_t c(k*pos + 1); c <= k*pos + k && c < n; ++c)
+        {
+            const UUID& child(tree_members_[(root_idx + c) % n]);
+            std::map<UUID, Socket*>::const_iterator
+                ci(tree_sockets_.find(child));
+            if (ci != tree_sockets_.end())
+            {
+                send(ci->second, dg);
+                ++tree_sent_;
+            }
+            else
+            {
+                pending.push_back(c);
+            }
+        }
+    }
+}
+
 void gcomm::GMCast::relay(const Message& msg,
                           const Datagram& dg,
                           const void* exclude_id)
@@ -1313,6 +1379,23 @@ void gcomm::GMCast::relay(const Message& msg,
     relay_dg.normalize();
     Message relay_msg(msg);
 
+    // tree relayed message is forwarded as is to own children
+    if (msg.flags() & Message::F_TREE_RELAY)
+    {
+        if (segment_fanout_ > 0)
+        {
+            gu_trace(push_header(relay_msg, relay_dg));
+            tree_send(msg.source_uuid(), relay_dg);
+        }
+        else
+        {
+            log_debug << "tree relayed message from " << msg.source_uuid()
+                      << " but " << Conf::GMCastSegmentFanout
+                      << " is not set";
+        }
+        return;
+    }
+
     // reset all relay flags from message to be relayed
     relay_msg.set_flags(relay_msg.flags() &
                         ~(Message::F_RELAY | Message::F_SEGMENT_RELAY));
@@ -1460,7 +1543,8 @@ void gcomm::GMCast::handle_up(const void*        id,
                     return;
                 }
                 if (msg.flags() &
-                    (Message::F_RELAY | Message::F_SEGMENT_RELAY))
+                    (Message::F_RELAY | Message::F_SEGMENT_RELAY |
+                     Message::F_TREE_RELAY))
                 {
                     relay(msg,
                           Datagram(dg, dg.offset() + msg.serial_size()),
@@ -1565,7 +1649,8 @@ int gcomm::GMCast::handle_down(Datagram& dg, const ProtoDownMeta& dm)
         if (segment_id != segment_)
         {
             size_t target_idx((self_index_ + segment_id) % segment.size());
-            msg.set_flags(msg.flags() | Message::F_SEGMENT_RELAY);
+            msg.set_flags((msg.flags() | Message::F_SEGMENT_RELAY) &
+                          ~Message::F_TREE_RELAY);
             // skip peers that are in relay set
             if (relay_set_.empty() == true ||
                 relay_set_.find(segment[target_idx]) == relay_set_.end())
@@ -1575,9 +1660,19 @@ int gcomm::GMCast::handle_down(Datagram& dg, const ProtoDownMeta& dm)
                 gu_trace(pop_header(msg, dg));
             }
         }
+        else if (tree_enabled() == true)
+        {
+            // send only to own children, they forward further down
+            msg.set_flags((msg.flags() & ~Message::F_SEGMENT_RELAY) |
+                          Message::F_TREE_RELAY);
+            gu_trace(push_header(msg, dg));
+            tree_send(uuid(), dg);
+            gu_trace(pop_header(msg, dg));
+        }
         else
         {
-            msg.set_flags(msg.flags() & ~Message::F_SEGMENT_RELAY);
+            msg.set_flags(msg.flags() &
+                          ~(Message::F_SEGMENT_RELAY | Message::F_TREE_RELAY));
             gu_trace(push_header(msg, dg));
             for (Segment::iterator i(segment.begin());
                  i != segment.end(); ++i)
@@ -1676,6 +1771,26 @@ void gcomm::GMCast::handle_stable_view(const View& view)
     }
     else if (view.type() == V_REG)
     {
+        // Segment tree is built from the view membership, which is the
+        // same on all nodes, so that every node derives the same tree
+        // for a given root regardless of its own connectivity.
+        tree_members_.clear();
+        if (segment_fanout_ > 0 && !mcast_ && view.is_member(uuid()))
+        {
+            // NodeList is ordered by UUID
+            for (NodeList::const_iterator i(view.members().begin());
+                 i != view.members().end(); ++i)
+            {
+                if (NodeList::value(i).segment() == segment_)
+                {
+                    tree_members_.push_back(NodeList::key(i));
+                }
+            }
+            log_debug << self_string() << " segment tree members: "
+                      << tree_members_.size()
+                      << " fanout: " << segment_fanout_;
+        }
+
         for (NodeList::const_iterator i(view.members().begin());
              i != view.members().end(); ++i)
         {
@@ -1709,6 +1824,15 @@ void gcomm::GMCast::handle_stable_view(const View& view)
 }
 
 
+void gcomm::GMCast::handle_get_status(gu::Status& status) const
+{
+    if (segment_fanout_ > 0)
+    {
+        status.insert("gmcast_segment_tree_sent", gu::to_string(tree_sent_));
+    }
+}
+
+
 void gcomm::GMCast::handle_evict(const UUID& uuid)
 {
     if (is_evicted(uuid) == true)
@@ -1829,6 +1953,8 @@ bool gcomm::GMCast::set_param(const std::string& key, const std::string& val,
                     erase_proto(pi);
                 }
                 segment_map_.clear();
+                tree_members_.clear();
+                tree_sockets_.clear();
             }
             return true;
         }
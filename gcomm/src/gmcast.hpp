@@ -43,6 +43,7 @@ namespace gcomm
         void handle_up(const void*, const Datagram&, const ProtoUpMeta&);
         int  handle_down(Datagram&, const ProtoDownMeta&);
         void handle_stable_view(const View& view);
+        void handle_get_status(gu::Status& status) const;
         void handle_evict(const UUID& uuid);
         std::string handle_get_address(const UUID& uuid) const;
         bool set_param(const std::string& key, const std::string& val,
@@ -195,6 +196,13 @@ namespace gcomm
         SegmentMap segment_map_;
         // self index in local segment when ordered by UUID
         size_t self_index_;
+        // local segment dissemination tree: members of the local segment
+        // in the last regular view ordered by UUID, and sockets to those
+        // which are directly reachable
+        int                      segment_fanout_;
+        std::vector<UUID>        tree_members_;
+        std::map<UUID, Socket*>  tree_sockets_;
+        size_t                   tree_sent_;
         gu::datetime::Period time_wait_;
         gu::datetime::Period check_period_;
         gu::datetime::Period peer_timeout_;
@@ -272,6 +280,14 @@ namespace gcomm
         void check_liveness();
         void relay(const gmcast::Message& msg, const Datagram& dg,
                    const void* exclude_id);
+        // Check if local segment messages should go via dissemination tree
+        bool tree_enabled() const
+        {
+            return (segment_fanout_ > 0 && tree_members_.size() > 1 &&
+                    relay_set_.empty() == true);
+        }
+        // Send to children of this node in the tree rooted at root
+        void tree_send(const UUID& root, Datagram& dg);
         // Reconnecting
         void reconnect();
 
@@ -33,7 +33,10 @@ public:
         // and to all other segments except source segment
         F_RELAY                   = 1 << 5,
         // relay message to all peers in the same segment
-        F_SEGMENT_RELAY           = 1 << 6
+        F_SEGMENT_RELAY           = 1 << 6,
+        // relay message to own children in the local segment
+        // dissemination tree rooted at the source
+        F_TREE_RELAY              = 1 << 7
     };
 
     enum Type
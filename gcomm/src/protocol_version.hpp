@@ -3,5 +3,8 @@
  */
 #ifndef GCOMM_PROTOCOL_VERSION_HPP
 #define GCOMM_PROTOCOL_VERSION_HPP
-#define GCOMM_PROTOCOL_MAX_VERSION 1
+// Protocol versions:
+// 1 - EVS delayed list and auto eviction
+// 2 - EVS combined retransmission datagrams
+#define GCOMM_PROTOCOL_MAX_VERSION 2
 #endif // GCOMM_PROTOCOL_VERSION_HPP
@@ -652,7 +652,8 @@ static DummyNode* create_dummy_node(size_t idx,
                                     int version,
                                     const string& suspect_timeout = "PT1H",
                                     const string& inactive_timeout = "PT1H",
-                                    const string& retrans_period = "PT10M")
+                                    const string& retrans_period = "PT10M",
+                                    SegmentId segment = 0)
 {
     // reset conf to avoid stale config in case of nofork
     gu_conf = gu::Config();
@@ -675,7 +676,7 @@ static DummyNode* create_dummy_node(size_t idx,
     list<Protolay*> protos;
     UUID uuid(static_cast<int32_t>(idx));
     protos.push_back(new DummyTransport(uuid, false));
-    protos.push_back(new Proto(gu_conf, uuid, 0, conf));
+    protos.push_back(new Proto(gu_conf, uuid, segment, conf));
     return new DummyNode(gu_conf, idx, protos);
 }
 
@@ -2194,6 +2195,283 @@ START_TEST(test_gal_521)
 END_TEST
 
 
+static long long get_status_var(Proto* evs, const std::string& key)
+{
+    gu::Status status;
+    evs->handle_get_status(status);
+    for (gu::Status::const_iterator i(status.begin()); i != status.end(); ++i)
+    {
+        if (i->first == key) return gu::from_string<long long>(i->second);
+    }
+    fail("status variable %s not found", key.c_str());
+    return -1;
+}
+
+
+// Messages lost on the way are retransmitted in a single combined
+// delegate message when protocol version >= 2 is in use.
+START_TEST(test_evs_combined_retrans)
+{
+    log_info << "START (test_evs_combined_retrans)";
+
+    std::vector<DummyNode*> dn;
+    Protolay::sync_param_cb_t sync_param_cb;
+
+    dn.push_back(create_dummy_node(1, 2));
+    dn.push_back(create_dummy_node(2, 2));
+
+    gcomm::evs::Proto *evs1(evs_from_dummy(dn[0]));
+    DummyTransport* t1(transport_from_dummy(dn[0]));
+    t1->set_queueing(true);
+
+    gcomm::evs::Proto *evs2(evs_from_dummy(dn[1]));
+    DummyTransport* t2(transport_from_dummy(dn[1]));
+    t2->set_queueing(true);
+
+    single_join(t1, evs1);
+    double_join(t1, evs1, t2, evs2);
+    fail_unless(evs1->current_view().version() == 2);
+
+    evs1->set_param(gcomm::Conf::EvsUserSendWindow, "4", sync_param_cb);
+    evs1->set_param(gcomm::Conf::EvsSendWindow, "4", sync_param_cb);
+
+    // Send three messages from node 1, the first two get lost
+    send_n(dn[0], 3);
+    Datagram* d;
+    Message msg;
+    for (size_t i(0); i < 2; ++i)
+    {
+        fail_unless(get_msg(t1, &msg) != 0);
+        fail_unless(msg.type() == Message::EVS_T_USER);
+    }
+    fail_unless((d = get_msg(t1, &msg, false)) != 0);
+    fail_unless(msg.type() == Message::EVS_T_USER);
+    fail_unless(t1->empty() == true);
+
+    // Node 2 must request retransmission of the missing messages
+    evs2->handle_up(0, *d, ProtoUpMeta(dn[0]->uuid()));
+    delete d;
+    Message gm;
+    while (get_msg(t2, &msg) != 0)
+    {
+        if (msg.type() == Message::EVS_T_GAP &&
+            msg.range_uuid() == dn[0]->uuid())
+        {
+            gm = msg;
+        }
+    }
+    fail_unless(gm.type() == Message::EVS_T_GAP);
+    fail_unless(gm.range().lu() == 0 && gm.range().hs() >= 1,
+                "unexpected gap range");
+
+    // Node 1 retransmits both of the messages in single delegate message
+    evs1->handle_msg(gm);
+    fail_unless((d = get_msg(t1, &msg, false)) != 0);
+    fail_unless(msg.type() == Message::EVS_T_DELEGATE);
+    fail_unless((msg.flags() & Message::F_AGGREGATE) != 0);
+    while (get_msg(t1, &msg) != 0)
+    {
+        fail_unless(msg.type() != Message::EVS_T_DELEGATE &&
+                    (msg.flags() & Message::F_RETRANS) == 0);
+    }
+    fail_unless(get_status_var(evs1, "evs_retrans_gap_msgs") >= 2);
+    fail_unless(get_status_var(evs1, "evs_retrans_gap_bytes") > 0);
+    fail_unless(get_status_var(evs1, "evs_retrans_delayed_msgs") == 0);
+
+    // No further retransmission requests after handling the
+    // combined message
+    evs2->handle_up(0, *d, ProtoUpMeta(dn[0]->uuid()));
+    delete d;
+    while (get_msg(t2, &msg) != 0)
+    {
+        fail_unless(msg.type() != Message::EVS_T_GAP ||
+                    msg.range_uuid() != dn[0]->uuid());
+    }
+
+    std::for_each(dn.begin(), dn.end(), DeleteObject());
+}
+END_TEST
+
+
+// Passes messages between two nodes until both go quiet
+static void exchange(DummyTransport* t1, Proto* evs1,
+                     DummyTransport* t2, Proto* evs2)
+{
+    Datagram* d;
+    Message msg;
+    bool more(true);
+    while (more == true)
+    {
+        more = false;
+        if ((d = get_msg(t1, &msg, false)) != 0)
+        {
+            evs2->handle_up(0, *d, ProtoUpMeta(t1->uuid()));
+            delete d;
+            more = true;
+        }
+        if ((d = get_msg(t2, &msg, false)) != 0)
+        {
+            evs1->handle_up(0, *d, ProtoUpMeta(t2->uuid()));
+            delete d;
+            more = true;
+        }
+    }
+}
+
+
+// With auto-tuning user send window grows while it limits sending and
+// messages get through, and shrinks when messages must be retransmitted.
+START_TEST(test_evs_user_send_window_auto)
+{
+    log_info << "START (test_evs_user_send_window_auto)";
+
+    std::vector<DummyNode*> dn;
+    Protolay::sync_param_cb_t sync_param_cb;
+
+    dn.push_back(create_dummy_node(1, 0));
+    dn.push_back(create_dummy_node(2, 0));
+
+    gcomm::evs::Proto *evs1(evs_from_dummy(dn[0]));
+    DummyTransport* t1(transport_from_dummy(dn[0]));
+    t1->set_queueing(true);
+
+    gcomm::evs::Proto *evs2(evs_from_dummy(dn[1]));
+    DummyTransport* t2(transport_from_dummy(dn[1]));
+    t2->set_queueing(true);
+
+    single_join(t1, evs1);
+    double_join(t1, evs1, t2, evs2);
+
+    evs1->set_param(gcomm::Conf::EvsSendWindow, "8", sync_param_cb);
+    evs1->set_param(gcomm::Conf::EvsUserSendWindow, "1", sync_param_cb);
+    evs1->set_param(gcomm::Conf::EvsUserSendWindowAuto, "true",
+                    sync_param_cb);
+    fail_unless(get_status_var(evs1, "evs_user_send_window") == 1);
+
+    for (size_t i(0); i < 20; ++i)
+    {
+        send_n(dn[0], 8);
+        exchange(t1, evs1, t2, evs2);
+    }
+
+    long long const win(get_status_var(evs1, "evs_user_send_window"));
+    fail_unless(win > 1, "window did not grow: %lld", win);
+    fail_unless(win <= 8, "window exceeds send window: %lld", win);
+
+    // Lose the first message of each batch, window must shrink after
+    // retransmissions
+    for (size_t i(0); i < 4; ++i)
+    {
+        send_n(dn[0], 8);
+        Message msg;
+        fail_unless(get_msg(t1, &msg) != 0);
+        exchange(t1, evs1, t2, evs2);
+    }
+
+    fail_unless(get_status_var(evs1, "evs_retransmitted") > 0 ||
+                get_status_var(evs1, "evs_retrans_gap_msgs") > 0);
+    fail_unless(get_status_var(evs1, "evs_user_send_window") < win,
+                "window did not shrink: %lld",
+                get_status_var(evs1, "evs_user_send_window"));
+
+    // Disabling auto-tuning restores configured window
+    evs1->set_param(gcomm::Conf::EvsUserSendWindowAuto, "false",
+                    sync_param_cb);
+    fail_unless(get_status_var(evs1, "evs_user_send_window") == 1);
+
+    std::for_each(dn.begin(), dn.end(), DeleteObject());
+}
+END_TEST
+
+
+// Recovery request of a delayed node is answered by a single peer from
+// the requester's segment. Repeated request is answered by all nodes.
+START_TEST(test_evs_recovery_peer)
+{
+    log_info << "START (test_evs_recovery_peer)";
+
+    PropagationMatrix prop;
+    std::vector<DummyNode*> dn;
+
+    // nodes 1 and 2 in segment 0, nodes 3 and 4 in segment 1
+    for (size_t i(1); i <= 4; ++i)
+    {
+        dn.push_back(create_dummy_node(i, 2, "PT1H", "PT1H", "PT10M",
+                                       (i - 1)/2));
+    }
+
+    uint32_t max_view_seq(0);
+    for (size_t i(0); i < dn.size(); ++i)
+    {
+        gu_trace(join_node(&prop, dn[i], i == 0));
+        set_cvi(dn, 0, i, max_view_seq + 1);
+        gu_trace(prop.propagate_until_cvi(false));
+        max_view_seq = get_max_view_seq(dn, 0, i);
+    }
+    fail_unless(evs_from_dummy(dn[0])->current_view().version() == 2);
+
+    // node 4 does not receive messages from node 1
+    prop.set_loss(1, 4, 0.);
+    send_n(dn[0], 2);
+    gu_trace(prop.propagate_until_empty());
+    // let nodes 2 and 3 learn that the other one has the messages
+    send_n(dn[1], 1);
+    send_n(dn[2], 1);
+    gu_trace(prop.propagate_until_empty());
+
+    for (size_t i(0); i < dn.size(); ++i)
+    {
+        transport_from_dummy(dn[i])->set_queueing(true);
+    }
+
+    gcomm::evs::Proto* evs4(evs_from_dummy(dn[3]));
+
+    // node 3 is in the requester's segment and recovers the messages,
+    // node 2 stays quiet
+    for (size_t round(0); round < 2; ++round)
+    {
+        const GapMessage gm(2,
+                            dn[3]->uuid(),
+                            evs4->current_view().id(),
+                            -1,
+                            -1,
+                            1000 + round,
+                            dn[0]->uuid(),
+                            Range(0, 1),
+                            Message::F_RETRANS);
+
+        for (size_t i(1); i <= 2; ++i)
+        {
+            gcomm::evs::Proto* evs(evs_from_dummy(dn[i]));
+            DummyTransport*    t(transport_from_dummy(dn[i]));
+            long long const before(get_status_var(
+                                       evs, "evs_retrans_delayed_msgs"));
+            evs->handle_msg(gm);
+
+            bool recovered(false);
+            Message msg;
+            while (get_msg(t, &msg) != 0)
+            {
+                if (msg.type() == Message::EVS_T_DELEGATE) recovered = true;
+            }
+            long long const after(get_status_var(
+                                      evs, "evs_retrans_delayed_msgs"));
+
+            // second time around the repeated request falls back to all
+            bool const peer(round == 1 || i == 2);
+            fail_unless(recovered == peer, "round %zu node %zu recovered %d",
+                        round, i + 1, recovered);
+            fail_unless((after > before) == peer,
+                        "round %zu node %zu: %lld -> %lld",
+                        round, i + 1, before, after);
+        }
+    }
+
+    std::for_each(dn.begin(), dn.end(), DeleteObject());
+}
+END_TEST
+
+
 Suite* evs2_suite()
 {
     Suite* s = suite_create("gcomm::evs");
@@ -2381,6 +2659,20 @@ Suite* evs2_suite()
         tc = tcase_create("test_gal_521");
         tcase_add_test(tc, test_gal_521);
         suite_add_tcase(s, tc);
+
+        tc = tcase_create("test_evs_recovery_peer");
+        tcase_add_test(tc, test_evs_recovery_peer);
+        tcase_set_timeout(tc, 15);
+        suite_add_tcase(s, tc);
+
+        tc = tcase_create("test_evs_combined_retrans");
+        tcase_add_test(tc, test_evs_combined_retrans);
+        tcase_set_timeout(tc, 15);
+        suite_add_tcase(s, tc);
+
+        tc = tcase_create("test_evs_user_send_window_auto");
+        tcase_add_test(tc, test_evs_user_send_window_auto);
+        suite_add_tcase(s, tc);
     }
 
     return s;
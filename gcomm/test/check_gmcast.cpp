@@ -65,115 +65,137 @@ START_TEST(test_gmcast_multicast)
 END_TEST
 
 
-START_TEST(test_gmcast_w_user_messages)
+class User : public Toplay
 {
-    class User : public Toplay
+    Transport* tp_;
+    size_t recvd_;
+    Protostack pstack_;
+    explicit User(const User&);
+    void operator=(User&);
+
+public:
+
+    User(Protonet& pnet,
+         const std::string& listen_addr,
+         const std::string& remote_addr,
+         const std::string& extra_opts = "") :
+        Toplay(pnet.conf()),
+        tp_(0),
+        recvd_(0),
+        pstack_()
     {
-        Transport* tp_;
-        size_t recvd_;
-        Protostack pstack_;
-        explicit User(const User&);
-        void operator=(User&);
-
-    public:
-
-        User(Protonet& pnet,
-             const std::string& listen_addr,
-             const std::string& remote_addr) :
-            Toplay(pnet.conf()),
-            tp_(0),
-            recvd_(0),
-            pstack_()
+        string uri("gmcast://");
+        uri += remote_addr; // != 0 ? remote_addr : "";
+        uri += "?";
+        uri += "tcp.non_blocking=1";
+        uri += "&";
+        uri += "gmcast.group=testgrp";
+        uri += "&gmcast.time_wait=PT0.5S";
+        if (test_multicast == true)
         {
-            string uri("gmcast://");
-            uri += remote_addr; // != 0 ? remote_addr : "";
-            uri += "?";
-            uri += "tcp.non_blocking=1";
-            uri += "&";
-            uri += "gmcast.group=testgrp";
-            uri += "&gmcast.time_wait=PT0.5S";
-            if (test_multicast == true)
-            {
-                uri += "&" + mcast_param;
-            }
-            uri += "&gmcast.listen_addr=tcp://";
-            uri += listen_addr;
-
-            tp_ = Transport::create(pnet, uri);
+            uri += "&" + mcast_param;
         }
+        uri += "&gmcast.listen_addr=tcp://";
+        uri += listen_addr;
+        uri += extra_opts;
+
+        tp_ = Transport::create(pnet, uri);
+    }
+
+    ~User()
+    {
+        delete tp_;
+    }
 
-        ~User()
+    void start(const std::string& peer = "")
+    {
+        if (peer == "")
         {
-            delete tp_;
+            tp_->connect();
         }
-
-        void start(const std::string& peer = "")
+        else
         {
-            if (peer == "")
-            {
-                tp_->connect();
-            }
-            else
-            {
-                tp_->connect(peer);
-            }
-            pstack_.push_proto(tp_);
-            pstack_.push_proto(this);
+            tp_->connect(peer);
         }
+        pstack_.push_proto(tp_);
+        pstack_.push_proto(this);
+    }
 
 
-        void stop()
-        {
-            pstack_.pop_proto(this);
-            pstack_.pop_proto(tp_);
-            tp_->close();
-        }
+    void stop()
+    {
+        pstack_.pop_proto(this);
+        pstack_.pop_proto(tp_);
+        tp_->close();
+    }
 
-        void handle_timer()
-        {
-            byte_t buf[16];
-            memset(buf, 0xa5, sizeof(buf));
+    void handle_timer()
+    {
+        byte_t buf[16];
+        memset(buf, 0xa5, sizeof(buf));
 
-            Datagram dg(Buffer(buf, buf + sizeof(buf)));
+        Datagram dg(Buffer(buf, buf + sizeof(buf)));
 
-            send_down(dg, ProtoDownMeta());
-        }
+        send_down(dg, ProtoDownMeta());
+    }
 
-        void handle_up(const void* cid, const Datagram& rb,
-                       const ProtoUpMeta& um)
+    void handle_up(const void* cid, const Datagram& rb,
+                   const ProtoUpMeta& um)
+    {
+        if (rb.len() < rb.offset() + 16)
         {
-            if (rb.len() < rb.offset() + 16)
-            {
-                gu_throw_fatal << "offset error";
-            }
-            char buf[16];
-            memset(buf, 0xa5, sizeof(buf));
-            // cppcheck-suppress uninitstring
-            if (memcmp(buf, &rb.payload()[0] + rb.offset(), 16) != 0)
-            {
-                gu_throw_fatal << "content mismatch";
-            }
-            recvd_++;
+            gu_throw_fatal << "offset error";
         }
-
-        size_t recvd() const
+        char buf[16];
+        memset(buf, 0xa5, sizeof(buf));
+        // cppcheck-suppress uninitstring
+        if (memcmp(buf, &rb.payload()[0] + rb.offset(), 16) != 0)
         {
-            return recvd_;
+            gu_throw_fatal << "content mismatch";
         }
+        recvd_++;
+    }
 
-        void set_recvd(size_t val)
-        {
-            recvd_ = val;
-        }
+    size_t recvd() const
+    {
+        return recvd_;
+    }
+
+    void set_recvd(size_t val)
+    {
+        recvd_ = val;
+    }
+
+    Protostack& pstack() { return pstack_; }
 
-        Protostack& pstack() { return pstack_; }
+    const GMCast& gmcast() const { return *static_cast<GMCast*>(tp_); }
 
-        std::string listen_addr() const
+    std::string listen_addr() const
+    {
+        return tp_->listen_addr();
+    }
+};
+
+
+// Number of datagrams sent to dissemination tree children
+static size_t tree_sent(const User& u)
+{
+    gu::Status status;
+    u.gmcast().get_status(status);
+    for (gu::Status::const_iterator i(status.begin()); i != status.end(); ++i)
+    {
+        if (i->first == "gmcast_segment_tree_sent")
         {
-            return tp_->listen_addr();
+            return gu::from_string<size_t>(i->second);
         }
-    };
+    }
+    fail("gmcast_segment_tree_sent not found in status");
+    return 0;
+}
+
 
+START_TEST(test_gmcast_w_user_messages)
+{
     log_info << "START";
     gu::Config conf;
     gu::ssl_register_params(conf);
@@ -274,6 +296,156 @@ START_TEST(test_gmcast_w_user_messages)
 END_TEST
 
 
+START_TEST(test_gmcast_segment_tree)
+{
+    log_info << "START";
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    auto_ptr<Protonet> pnet(Protonet::create(conf));
+
+    // fanout 1 turns the tree into a chain, so that every message
+    // except the first hop must be forwarded by intermediate nodes
+    const std::string opts("&gmcast.segment_fanout=1");
+
+    User u1(*pnet, "127.0.0.1:0", "", opts);
+    pnet->insert(&u1.pstack());
+    u1.start();
+    pnet->event_loop(Sec/10);
+
+    const std::string peer(u1.listen_addr().erase(0, strlen("tcp://")));
+    User u2(*pnet, "127.0.0.1:0", peer, opts);
+    User u3(*pnet, "127.0.0.1:0", peer, opts);
+    User u4(*pnet, "127.0.0.1:0", peer, opts);
+    pnet->insert(&u2.pstack());
+    pnet->insert(&u3.pstack());
+    pnet->insert(&u4.pstack());
+    u2.start();
+    u3.start();
+    u4.start();
+
+    while (u2.recvd() <= 10 || u3.recvd() <= 10 || u4.recvd() <= 10)
+    {
+        u1.handle_timer();
+        pnet->event_loop(Sec/10);
+    }
+
+    // let the full mesh settle
+    pnet->event_loop(Sec);
+
+    // The tree is built from the regular view. Add a member which is not
+    // reachable and comes right after u1 in UUID order, so that u1 must
+    // serve its subtree.
+    gu_uuid_t next(*u1.gmcast().uuid().uuid_ptr());
+    for (int i(sizeof(next.data) - 1); i >= 0 && ++next.data[i] == 0; --i) {}
+    std::ostringstream next_str;
+    next_str << next;
+    std::istringstream next_is(next_str.str());
+    UUID unreachable;
+    unreachable.read_stream(next_is);
+
+    View view(0, ViewId(V_REG, u1.gmcast().uuid(), 1));
+    view.add_member(u1.gmcast().uuid(), 0);
+    view.add_member(u2.gmcast().uuid(), 0);
+    view.add_member(u3.gmcast().uuid(), 0);
+    view.add_member(u4.gmcast().uuid(), 0);
+    view.add_member(unreachable, 0);
+    u1.set_stable_view(view);
+    u2.set_stable_view(view);
+    u3.set_stable_view(view);
+    u4.set_stable_view(view);
+
+    u1.set_recvd(0);
+    u2.set_recvd(0);
+    u3.set_recvd(0);
+    u4.set_recvd(0);
+
+    const size_t origin_sent(tree_sent(u1));
+    const size_t relay_sent(tree_sent(u2) + tree_sent(u3) + tree_sent(u4));
+
+    for (size_t i(0); i < 10; ++i)
+    {
+        u1.handle_timer();
+        pnet->event_loop(Sec/10);
+    }
+    pnet->event_loop(Sec/2);
+
+    // in a chain the origin sends each message to its only reachable
+    // child instead of all three peers, and the two intermediate nodes
+    // forward it
+    const size_t origin_delta(tree_sent(u1) - origin_sent);
+    const size_t relay_delta(tree_sent(u2) + tree_sent(u3) + tree_sent(u4) -
+                             relay_sent);
+    fail_unless(origin_delta == 10, "origin sent %zu", origin_delta);
+    fail_unless(relay_delta == 20, "relays sent %zu", relay_delta);
+
+    // each message is delivered exactly once to every other node
+    fail_unless(u1.recvd() == 0, "u1 recvd %zu", u1.recvd());
+    fail_unless(u2.recvd() == 10, "u2 recvd %zu", u2.recvd());
+    fail_unless(u3.recvd() == 10, "u3 recvd %zu", u3.recvd());
+    fail_unless(u4.recvd() == 10, "u4 recvd %zu", u4.recvd());
+
+    pnet->erase(&u4.pstack());
+    pnet->erase(&u3.pstack());
+    pnet->erase(&u2.pstack());
+    pnet->erase(&u1.pstack());
+
+    u1.stop();
+    u2.stop();
+    u3.stop();
+    u4.stop();
+
+    pnet->event_loop(0);
+}
+END_TEST
+
+
+START_TEST(test_gmcast_io_threads)
+{
+    log_info << "START";
+    gu::Config conf;
+    gu::ssl_register_params(conf);
+    gcomm::Conf::register_params(conf);
+    conf.set(gcomm::Conf::SocketIoThreads, "2");
+    auto_ptr<Protonet> pnet(Protonet::create(conf));
+
+    User u1(*pnet, "127.0.0.1:0", "");
+    pnet->insert(&u1.pstack());
+    u1.start();
+    pnet->event_loop(Sec/10);
+
+    const std::string peer(u1.listen_addr().erase(0, strlen("tcp://")));
+    User u2(*pnet, "127.0.0.1:0", peer);
+    User u3(*pnet, "127.0.0.1:0", peer);
+    pnet->insert(&u2.pstack());
+    pnet->insert(&u3.pstack());
+    u2.start();
+    u3.start();
+
+    while (u1.recvd() <= 50 || u2.recvd() <= 50 || u3.recvd() <= 50)
+    {
+        {
+            // socket I/O threads access send queues concurrently
+            Critical<Protonet> crit(*pnet);
+            u1.handle_timer();
+            u2.handle_timer();
+            u3.handle_timer();
+        }
+        pnet->event_loop(Sec/10);
+    }
+
+    pnet->erase(&u3.pstack());
+    pnet->erase(&u2.pstack());
+    pnet->erase(&u1.pstack());
+
+    u1.stop();
+    u2.stop();
+    u3.stop();
+
+    pnet->event_loop(0);
+}
+END_TEST
+
 // not run by default, hard coded port
 START_TEST(test_gmcast_auto_addr)
 {
@@ -456,6 +628,16 @@ Suite* gmcast_suite()
         tcase_set_timeout(tc, 30);
         suite_add_tcase(s, tc);
 
+        tc = tcase_create("test_gmcast_segment_tree");
+        tcase_add_test(tc, test_gmcast_segment_tree);
+        tcase_set_timeout(tc, 30);
+        suite_add_tcase(s, tc);
+
+        tc = tcase_create("test_gmcast_io_threads");
+        tcase_add_test(tc, test_gmcast_io_threads);
+        tcase_set_timeout(tc, 30);
+        suite_add_tcase(s, tc);
+
         // not run by default, hard coded port
         tc = tcase_create("test_gmcast_auto_addr");
         tcase_add_test(tc, test_gmcast_auto_addr);
@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2018 Codership Oy <info@codership.com>
+ *
+ * In-process group communication benchmark. Runs a cluster of EVS+PC
+ * stacks connected through the check_trace PropagationMatrix and measures
+ * total order delivery throughput, latency and CPU time per message.
+ *
+ * Usage: gcomm_bench [-n nodes] [-s msg sizes] [-w send_window:user_window]
+ *                    [-l loss] [-m messages] [-b burst]
+ *
+ * -n, -s, -w and -l accept comma separated lists, every combination is run.
+ * Latency is reported both in wall clock time and in propagation rounds
+ * (one round delivers at most one message per link).
+ */
+
+#include "check_trace.hpp"
+
+#include "evs_proto.hpp"
+#include "pc_proto.hpp"
+#include "defaults.hpp"
+
+#include "gcomm/conf.hpp"
+
+#include "gu_asio.hpp" // gu::ssl_register_params()
+#include "gu_string_utils.hpp"
+#include "gu_time.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace gcomm;
+
+namespace
+{
+    /* payload header: send time (ns), send round, sender seqno */
+    size_t const HDR_SIZE(8 + 4 + 4);
+
+    class BenchNode : public DummyNode
+    {
+    public:
+
+        BenchNode(gu::Config& conf, size_t const index,
+                  const std::list<Protolay*>& protos,
+                  std::vector<double>& lat, std::vector<uint32_t>& rounds) :
+            DummyNode (conf, index, protos),
+            lat_      (lat),
+            rounds_   (rounds),
+            buf_      (),
+            seq_      (0),
+            delivered_(0),
+            order_    (14695981039346656037ULL)
+        {}
+
+        /* returns 0 on success, EAGAIN if the send window is full */
+        int send(size_t const size, uint32_t const round)
+        {
+            buf_.resize(std::max(size, HDR_SIZE));
+            size_t off(gu::serialize8(int64_t(gu_time_monotonic()),
+                                      &buf_[0], buf_.size(), 0));
+            off = gu::serialize4(round, &buf_[0], buf_.size(), off);
+            off = gu::serialize4(seq_,  &buf_[0], buf_.size(), off);
+
+            Datagram dg(buf_);
+            int const err(send_down(dg, ProtoDownMeta(0)));
+
+            if (0 == err) ++seq_;
+
+            return err;
+        }
+
+        void handle_up(const void* cid, const Datagram& rb,
+                       const ProtoUpMeta& um)
+        {
+            if (rb.len() == 0)
+            {
+                DummyNode::handle_up(cid, rb, um); // view, keep the trace
+                return;
+            }
+
+            int64_t  const now(gu_time_monotonic());
+            const gu::byte_t* const begin(gcomm::begin(rb));
+            size_t   const avail(gcomm::available(rb));
+            int64_t  sent;
+            uint32_t round, seq;
+
+            size_t off(gu::unserialize8(begin, avail, 0, sent));
+            off = gu::unserialize4(begin, avail, off, round);
+            off = gu::unserialize4(begin, avail, off, seq);
+
+            lat_.push_back((now - sent) * 1.0e-3);
+            rounds_.push_back(cur_round - round);
+
+            /* FNV-1a over (source, seq): equal on all nodes iff the
+             * delivery order is the same */
+            const gu::byte_t* const src
+                (reinterpret_cast<const gu::byte_t*>(um.source().uuid_ptr()));
+            for (size_t i(0); i < sizeof(gu_uuid_t); ++i)
+            {
+                order_ = (order_ ^ src[i]) * 1099511628211ULL;
+            }
+            order_ = (order_ ^ seq) * 1099511628211ULL;
+
+            ++delivered_;
+        }
+
+        uint32_t seq()       const { return seq_;       }
+        size_t   delivered() const { return delivered_; }
+        uint64_t order()     const { return order_;     }
+
+        static uint32_t cur_round;
+
+    private:
+
+        BenchNode(const BenchNode&);
+        void operator=(const BenchNode&);
+
+        std::vector<double>&   lat_;
+        std::vector<uint32_t>& rounds_;
+        gu::Buffer             buf_;
+        uint32_t               seq_;
+        size_t                 delivered_;
+        uint64_t               order_;
+    };
+
+    uint32_t BenchNode::cur_round(0);
+
+    struct RunConf
+    {
+        size_t      nodes;
+        size_t      msg_size;
+        std::string send_window;
+        std::string user_send_window;
+        double      loss;
+        size_t      msgs;
+        size_t      burst;
+    };
+
+    BenchNode* create_node(size_t const idx, const RunConf& rc,
+                           std::vector<double>& lat,
+                           std::vector<uint32_t>& rounds)
+    {
+        gu::Config& conf(check_trace_conf());
+
+        /* long suspect/inactive timeouts: the simulation must not evict
+         * nodes when it stalls, retransmission runs at the minimum period */
+        std::string const uri("evs://?"
+            + Conf::EvsViewForgetTimeout   + "=PT1H&"
+            + Conf::EvsInactiveCheckPeriod + "=PT10M&"
+            + Conf::EvsSuspectTimeout      + "=PT1H&"
+            + Conf::EvsInactiveTimeout     + "=PT1H&"
+            + Conf::EvsInstallTimeout      + "=PT1H&"
+            + Conf::EvsKeepalivePeriod     + "=PT0.1S&"
+            + Conf::EvsJoinRetransPeriod   + "=PT0.1S&"
+            + Conf::EvsSendWindow          + "=" + rc.send_window + "&"
+            + Conf::EvsUserSendWindow      + "=" + rc.user_send_window);
+
+        UUID const uuid(static_cast<int32_t>(idx));
+        std::list<Protolay*> protos;
+        protos.push_back(new DummyTransport(uuid, false));
+        protos.push_back(new evs::Proto(conf, uuid, 0, gu::URI(uri)));
+        protos.push_back(new pc::Proto (conf, uuid, 0, gu::URI(uri)));
+
+        return new BenchNode(conf, idx, protos, lat, rounds);
+    }
+
+    double cpu_time()
+    {
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+            (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1.0e-6;
+    }
+
+    template <typename T>
+    T percentile(const std::vector<T>& sorted, double const p)
+    {
+        if (sorted.empty()) return T();
+        return sorted[std::min(sorted.size() - 1,
+                               size_t(sorted.size() * p))];
+    }
+
+    bool run(const RunConf& rc)
+    {
+        std::vector<double>    lat;
+        std::vector<uint32_t>  rounds;
+        std::vector<BenchNode*> nodes;
+        PropagationMatrix      prop;
+        uint32_t               view_seq(0);
+
+        size_t const quota((rc.msgs + rc.nodes - 1) / rc.nodes);
+        size_t const total(quota * rc.nodes);
+
+        lat.reserve(total * rc.nodes);
+        rounds.reserve(total * rc.nodes);
+
+        for (size_t i(0); i < rc.nodes; ++i)
+        {
+            nodes.push_back(create_node(i + 1, rc, lat, rounds));
+            prop.insert_tp(nodes[i]);
+            nodes[i]->connect(i == 0);
+
+            ++view_seq;
+            for (size_t j(0); j <= i; ++j)
+            {
+                nodes[j]->set_cvi(ViewId(V_PRIM, nodes[0]->uuid(), view_seq));
+            }
+            prop.propagate_until_cvi(false);
+        }
+
+        if (rc.loss > 0)
+        {
+            for (size_t i(1); i <= rc.nodes; ++i)
+                for (size_t j(1); j <= rc.nodes; ++j)
+                    if (i != j) prop.set_loss(i, j, 1. - rc.loss);
+        }
+
+        BenchNode::cur_round = 0;
+        bool   ok(true);
+        size_t progress(0);
+        double stall_start(gu_time_monotonic());
+
+        double const cpu0(cpu_time());
+        double const t0(gu_time_monotonic());
+
+        for (;;)
+        {
+            bool done(true);
+            size_t delivered(0);
+
+            for (size_t i(0); i < nodes.size(); ++i)
+            {
+                BenchNode* const n(nodes[i]);
+
+                for (size_t b(0); b < rc.burst && n->seq() < quota; ++b)
+                {
+                    int const err(n->send(rc.msg_size, BenchNode::cur_round));
+                    if (EAGAIN == err) break;
+                    if (0 != err)
+                    {
+                        log_error << "send failed: " << strerror(err);
+                        ok = false;
+                        break;
+                    }
+                }
+
+                delivered += n->delivered();
+                done = done && n->delivered() == total;
+            }
+
+            if (done || !ok) break;
+
+            prop.propagate_n(1);
+            ++BenchNode::cur_round;
+
+            /* retransmission and keepalives are driven by timers */
+            if (0 == (BenchNode::cur_round & 0xf))
+            {
+                for (size_t i(0); i < nodes.size(); ++i)
+                {
+                    nodes[i]->handle_timers();
+                }
+            }
+
+            if (delivered != progress)
+            {
+                progress = delivered;
+                stall_start = gu_time_monotonic();
+            }
+            else if (gu_time_monotonic() - stall_start > 10.0e9)
+            {
+                log_error << "no progress in 10 seconds, delivered "
+                          << delivered << " of " << total * rc.nodes;
+                ok = false;
+                break;
+            }
+        }
+
+        double const elapsed((gu_time_monotonic() - t0) * 1.0e-9);
+        double const cpu(cpu_time() - cpu0);
+
+        for (size_t i(1); ok && i < nodes.size(); ++i)
+        {
+            if (nodes[i]->order() != nodes[0]->order())
+            {
+                log_error << "delivery order differs on node " << i + 1;
+                ok = false;
+            }
+        }
+
+        std::sort(lat.begin(), lat.end());
+        std::sort(rounds.begin(), rounds.end());
+
+        printf("%5zu %7zu %9s %7.3f %10.0f %8.2f %8.1f %9.1f %9.1f %9.1f "
+               "%6u %6u %s\n",
+               rc.nodes, rc.msg_size,
+               (rc.send_window + ":" + rc.user_send_window).c_str(),
+               rc.loss, total / elapsed,
+               total * double(rc.msg_size) / elapsed / (1 << 20),
+               cpu * 1.0e6 / total,
+               percentile(lat, 0.5), percentile(lat, 0.99),
+               percentile(lat, 0.999),
+               percentile(rounds, 0.5), percentile(rounds, 0.99),
+               ok ? "ok" : "FAIL");
+        fflush(stdout);
+
+        std::for_each(nodes.begin(), nodes.end(), gu::DeleteObject());
+
+        return ok;
+    }
+
+    template <typename T>
+    std::vector<T> parse_list(const std::string& s)
+    {
+        std::vector<std::string> const v(gu::strsplit(s, ','));
+        std::vector<T> ret;
+        for (size_t i(0); i < v.size(); ++i)
+        {
+            ret.push_back(gu::from_string<T>(v[i]));
+        }
+        return ret;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string nodes_list("3");
+    std::string size_list("128");
+    std::string window_list(Defaults::EvsSendWindow + ":" +
+                            Defaults::EvsUserSendWindow);
+    std::string loss_list("0");
+    size_t msgs(20000);
+    size_t burst(4);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:w:l:m:b:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': nodes_list  = optarg; break;
+        case 's': size_list   = optarg; break;
+        case 'w': window_list = optarg; break;
+        case 'l': loss_list   = optarg; break;
+        case 'm': msgs  = gu::from_string<size_t>(optarg); break;
+        case 'b': burst = gu::from_string<size_t>(optarg); break;
+        default:
+            fprintf(stderr, "Usage: %s [-n nodes] [-s msg sizes] "
+                    "[-w send_window:user_send_window] [-l loss] "
+                    "[-m messages] [-b burst]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    gu_conf_self_tstamp_on();
+    gu_log_max_level = GU_LOG_ERROR;
+
+    try
+    {
+        std::vector<size_t> const      nv(parse_list<size_t>(nodes_list));
+        std::vector<size_t> const      sv(parse_list<size_t>(size_list));
+        std::vector<std::string> const wv(gu::strsplit(window_list, ','));
+        std::vector<double> const      lv(parse_list<double>(loss_list));
+
+        printf("%5s %7s %9s %7s %10s %8s %8s %9s %9s %9s %6s %6s\n",
+               "nodes", "size", "window", "loss", "msgs/s", "MB/s",
+               "cpu us", "p50 us", "p99 us", "p999 us", "r50", "r99");
+
+        bool ok(true);
+
+        for (size_t n(0); n < nv.size(); ++n)
+        for (size_t s(0); s < sv.size(); ++s)
+        for (size_t w(0); w < wv.size(); ++w)
+        for (size_t l(0); l < lv.size(); ++l)
+        {
+            std::vector<std::string> const win(gu::strsplit(wv[w], ':'));
+            RunConf const rc = { nv[n], sv[s], win.front(), win.back(),
+                                 lv[l], msgs, burst };
+            ok = run(rc) && ok;
+        }
+
+        return ok ? 0 : 1;
+    }
+    catch (gu::Exception& e)
+    {
+        log_error << e.what();
+        return 1;
+    }
+}
@@ -168,6 +168,10 @@ struct gcs_conn
     long         upper_limit;         // upper slave queue limit
     long         lower_limit;         // lower slave queue limit
     long         fc_offset;           // offset for catchup phase
+    ssize_t      queue_size;          // slave queue size in bytes
+    ssize_t      upper_size;          // upper slave queue size limit
+    ssize_t      lower_size;          // lower slave queue size limit
+    ssize_t      fc_size_offset;      // size offset for catchup phase
     gcs_conn_state_t max_fc_state;    // maximum state when FC is enabled
     long         stats_fc_stop_sent;  // FC stats counters
     long         stats_fc_cont_sent;  //
@@ -336,6 +340,7 @@ gcs_create (gu_config_t* const conf, gcache_t* const gcache,
     conn->local_act_id = GCS_SEQNO_FIRST;
     conn->global_seqno = 0;
     conn->fc_offset    = 0;
+    conn->fc_size_offset = 0;
     conn->timeout      = GU_TIME_ETERNITY;
     conn->gcache       = gcache;
     conn->max_fc_state = conn->params.sync_donor ?
@@ -420,6 +425,26 @@ gcs_send_fc_event (gcs_conn_t* conn, bool stop)
     return gcs_core_send_fc (conn->core, &fc, sizeof(fc));
 }
 
+/* Slave queue is over the upper limit either by length or by size.
+ * Size limit is optional and accounts for the apply cost of large actions. */
+static inline bool
+_fc_queue_over (const gcs_conn_t* conn)
+{
+    return gcs_fc_queue_over (conn->queue_len, conn->queue_size,
+                              conn->upper_limit + conn->fc_offset,
+                              conn->upper_size > 0 ?
+                              conn->upper_size + conn->fc_size_offset : 0);
+}
+
+/* Slave queue is below the lower limit both by length and by size. */
+static inline bool
+_fc_queue_under (const gcs_conn_t* conn)
+{
+    return gcs_fc_queue_under (conn->queue_len, conn->queue_size,
+                               conn->lower_limit, conn->lower_size,
+                               conn->upper_size);
+}
+
 /* To be called under slave queue lock. Returns true if FC_STOP must be sent */
 static inline bool
 gcs_fc_stop_begin (gcs_conn_t* conn)
@@ -428,7 +453,7 @@ gcs_fc_stop_begin (gcs_conn_t* conn)
 
     bool ret = (conn->stop_count <= 0                                     &&
                 conn->stop_sent_ <= 0                                     &&
-                conn->queue_len  >  (conn->upper_limit + conn->fc_offset) &&
+                _fc_queue_over(conn)                                      &&
                 conn->state      <= conn->max_fc_state                    &&
                 !(err = gu_mutex_lock (&conn->fc_lock)));
 
@@ -492,8 +517,13 @@ gcs_fc_cont_begin (gcs_conn_t* conn)
     bool queue_decreased = (conn->fc_offset > conn->queue_len &&
                             (conn->fc_offset = conn->queue_len, true));
 
+    if (conn->fc_size_offset > conn->queue_size) {
+        conn->fc_size_offset = conn->queue_size;
+        queue_decreased = true;
+    }
+
     bool ret = (conn->stop_sent_  >  0                                    &&
-                (conn->lower_limit >= conn->queue_len || queue_decreased) &&
+                (_fc_queue_under(conn) || queue_decreased)                &&
                 conn->state        <= conn->max_fc_state                  &&
                 !(err = gu_mutex_lock (&conn->fc_lock)));
 
@@ -550,7 +580,7 @@ static inline bool
 gcs_send_sync_begin (gcs_conn_t* conn)
 {
     if (gu_unlikely(GCS_CONN_JOINED == conn->state)) {
-        if (conn->lower_limit >= conn->queue_len && !conn->sync_sent()) {
+        if (_fc_queue_under(conn) && !conn->sync_sent()) {
             // tripped lower slave queue limit, send SYNC message
             conn->sync_sent(true);
 #if 0
@@ -810,8 +840,10 @@ gcs_become_joined (gcs_conn_t* conn)
     /* See also gcs_handle_act_conf () for a case of cluster bootstrapping */
     if (gcs_shift_state (conn, GCS_CONN_JOINED)) {
         conn->fc_offset    = conn->queue_len;
+        conn->fc_size_offset = conn->queue_size;
         conn->need_to_join = false;
-        gu_debug("Become joined, FC offset %ld", conn->fc_offset);
+        gu_debug("Become joined, FC offset %ld, size offset %zd",
+                 conn->fc_offset, conn->fc_size_offset);
         /* One of the cases when the node can become SYNCED */
         if ((ret = gcs_send_sync (conn))) {
             gu_warn ("Sending SYNC failed: %ld (%s)", ret, strerror (-ret));
@@ -831,8 +863,10 @@ gcs_become_synced (gcs_conn_t* conn)
         conn->sync_sent(false);
     }
     gu_fifo_release(conn->recv_q);
-    gu_debug("Become synced, FC offset %ld", conn->fc_offset);
+    gu_debug("Become synced, FC offset %ld, size offset %zd",
+             conn->fc_offset, conn->fc_size_offset);
     conn->fc_offset = 0;
+    conn->fc_size_offset = 0;
 }
 
 /* to be called under protection of both recv_q and fc_lock */
@@ -852,8 +886,16 @@ _set_fc_limits (gcs_conn_t* conn)
     conn->upper_limit = std::min(conn->upper_limit, gu_fifo_max_length(conn->recv_q));
     conn->lower_limit = std::min(conn->lower_limit, gu_fifo_max_length(conn->recv_q));
 
+    conn->upper_size = conn->params.fc_size_limit * fn + .5;
+    conn->lower_size = conn->upper_size * conn->params.fc_resume_factor + .5;
+
     gu_info ("Flow-control interval: [%ld, %ld]",
              conn->lower_limit, conn->upper_limit);
+
+    if (conn->upper_size > 0) {
+        gu_info ("Flow-control size interval: [%zd, %zd]",
+                 conn->lower_size, conn->upper_size);
+    }
 }
 
 /*! Handles flow control events
@@ -1395,7 +1437,8 @@ static void *gcs_recv_thread (void *arg)
                 recv_act->rcvd     = rcvd;
                 recv_act->local_id = this_act_id;
 
-                conn->queue_len = gu_fifo_length (conn->recv_q) + 1;
+                conn->queue_len  = gu_fifo_length (conn->recv_q) + 1;
+                conn->queue_size = conn->recv_q_size + rcvd.act.buf_len;
                 bool const send_stop(gcs_fc_stop_begin(conn));
 
                 // release queue
@@ -1618,12 +1661,42 @@ long gcs_destroy (gcs_conn_t *conn)
     return 0;
 }
 
+/* Enters send monitor in the requested priority class. Scheduled calls
+ * already hold a place in the normal priority queue. */
+static inline long
+_sm_enter (gcs_conn_t* const conn, gu_cond_t* const cond,
+           bool const scheduled, bool const priority, bool const block)
+{
+    if (priority && !scheduled) return gcs_sm_enter_prio (conn->sm, block);
+
+    return gcs_sm_enter (conn->sm, cond, scheduled, block);
+}
+
+static inline void
+_sm_leave (gcs_conn_t* const conn, bool const scheduled, bool const priority)
+{
+    if (priority && !scheduled)
+        gcs_sm_leave_prio (conn->sm);
+    else
+        gcs_sm_leave (conn->sm);
+}
+
+/* Local admission control for total order actions: don't replicate more
+ * while the slave queue is over the limit, see gcs_fc_admit(). */
+static inline bool
+_admit_act (const gcs_conn_t* conn, ssize_t const act_size)
+{
+    return gcs_fc_admit (conn->queue_len, conn->queue_size, act_size,
+                         conn->upper_limit, conn->upper_size, conn->lower_size);
+}
+
 /* Puts action in the send queue and returns */
 long gcs_sendv (gcs_conn_t*          const conn,
                 const struct gu_buf* const act_bufs,
                 size_t               const act_size,
                 gcs_act_type_t       const act_type,
-                bool                 const scheduled)
+                bool                 const scheduled,
+                bool                 const priority)
 {
     if (gu_unlikely(act_size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
 
@@ -1635,12 +1708,12 @@ long gcs_sendv (gcs_conn_t*          const conn,
     gu_cond_t tmp_cond;
     gu_cond_init (&tmp_cond, NULL);
 
-    if (!(ret = gcs_sm_enter (conn->sm, &tmp_cond, scheduled, true)))
+    if (!(ret = _sm_enter (conn, &tmp_cond, scheduled, priority, true)))
     {
         while ((GCS_CONN_OPEN >= conn->state) &&
                (ret = gcs_core_send (conn->core, act_bufs,
                                      act_size, act_type)) == -ERESTART);
-        gcs_sm_leave (conn->sm);
+        _sm_leave (conn, scheduled, priority);
         gu_cond_destroy (&tmp_cond);
     }
 
@@ -1666,7 +1739,8 @@ long gcs_caused(gcs_conn_t* conn, gcs_seqno_t& seqno)
 long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 const struct gu_buf* const act_in,    //!<in
                 struct gcs_action*   const act,       //!<inout
-                bool                 const scheduled) //!<in
+                bool                 const scheduled, //!<in
+                bool                 const priority)  //!<in
 {
     if (gu_unlikely((size_t)act->size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
 
@@ -1692,7 +1766,8 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
         // 1. serializes gcs_core_send() access between gcs_repl() and
         //    gcs_send()
         // 2. avoids race with gcs_close() and gcs_destroy()
-        if (!(ret = gcs_sm_enter (conn->sm, &repl_act.wait_cond, scheduled, true)))
+        if (!(ret = _sm_enter (conn, &repl_act.wait_cond, scheduled,
+                               priority, true)))
         {
             struct gcs_repl_act** act_ptr;
 
@@ -1705,7 +1780,7 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
             // if (conn->state >= GCS_CONN_CLOSE) or (act_ptr == NULL)
             // ret will be -ENOTCONN
             if ((ret = -EAGAIN,
-                 conn->upper_limit >= conn->queue_len ||
+                 _admit_act (conn, act->size) ||
                  act->type         != GCS_ACT_TORDERED)         &&
                 (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state) &&
                 (act_ptr = (struct gcs_repl_act**)gcs_fifo_lite_get_tail (conn->repl_q)))
@@ -1734,14 +1809,21 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 }
             }
 
-            gcs_sm_leave (conn->sm);
+            _sm_leave (conn, scheduled, priority);
 
             assert(ret);
 
             /* now we can go waiting for action delivery */
             if (ret >= 0) {
                 gu_cond_wait (&repl_act.wait_cond, &repl_act.wait_mutex);
-#ifndef GCS_FOR_GARB
+#ifdef GCS_FOR_GARB
+                /* arbitrator without cache does not store actions */
+                if (NULL == conn->gcache)
+                {
+                    assert (act->buf == 0);
+                }
+                else
+#endif /* GCS_FOR_GARB */
                 /* assert (act->buf != 0); */
                 if (act->buf == 0)
                 {
@@ -1749,9 +1831,6 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
                     ret = -ENOTCONN;
                     goto out;
                 }
-#else
-                assert (act->buf == 0);
-#endif /* GCS_FOR_GARB */
 
                 if (act->seqno_g < 0) {
                     assert (GCS_SEQNO_ILL    == act->seqno_l ||
@@ -1779,9 +1858,7 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
                 }
             }
         }
-#ifndef GCS_FOR_GARB
     out:
-#endif /* GCS_FOR_GARB */
         gu_mutex_unlock  (&repl_act.wait_mutex);
     }
     gu_mutex_destroy (&repl_act.wait_mutex);
@@ -1864,12 +1941,17 @@ long gcs_request_state_transfer (gcs_conn_t  *conn,
 
         if (ret > 0) {
             assert (action.buf != rst);
-#ifndef GCS_FOR_GARB
-            assert (action.buf != NULL);
-            gcs_gcache_free (conn->gcache, action.buf);
-#else
-            assert (action.buf == NULL);
-#endif
+#ifdef GCS_FOR_GARB
+            if (NULL == conn->gcache)
+            {
+                assert (action.buf == NULL);
+            }
+            else
+#endif /* GCS_FOR_GARB */
+            {
+                assert (action.buf != NULL);
+                gcs_gcache_free (conn->gcache, action.buf);
+            }
             assert (ret == (ssize_t)rst_size);
             assert (action.seqno_g >= 0);
             assert (action.seqno_l >  0);
@@ -1923,7 +2005,8 @@ long gcs_recv (gcs_conn_t*        conn,
 
     if ((recv_act = (struct gcs_recv_act*)gu_fifo_get_head (conn->recv_q, &err)))
     {
-        conn->queue_len = gu_fifo_length (conn->recv_q) - 1;
+        conn->queue_len  = gu_fifo_length (conn->recv_q) - 1;
+        conn->queue_size = conn->recv_q_size - recv_act->rcvd.act.buf_len;
         bool send_cont  = gcs_fc_cont_begin   (conn);
         bool send_sync  = gcs_send_sync_begin (conn);
 
@@ -2014,7 +2097,9 @@ long
 gcs_wait (gcs_conn_t* conn)
 {
     if (gu_likely(GCS_CONN_SYNCED == conn->state)) {
-       return (conn->stop_count > 0 || (conn->queue_len > conn->upper_limit));
+       return (conn->stop_count > 0 ||
+               gcs_fc_queue_over (conn->queue_len, conn->queue_size,
+                                  conn->upper_limit, conn->upper_size));
     }
     else {
         switch (conn->state) {
@@ -2043,11 +2128,12 @@ gcs_set_last_applied (gcs_conn_t* conn, gcs_seqno_t seqno)
     gu_cond_t cond;
     gu_cond_init (&cond, NULL);
 
-    long ret = gcs_sm_enter (conn->sm, &cond, false, false);
+    /* control message, should not wait behind queued write sets */
+    long ret = _sm_enter (conn, &cond, false, true, false);
 
     if (!ret) {
         ret = gcs_core_set_last_applied (conn->core, seqno);
-        gcs_sm_leave (conn->sm);
+        _sm_leave (conn, false, true);
     }
 
     gu_cond_destroy (&cond);
@@ -2098,13 +2184,19 @@ gcs_get_stats (gcs_conn_t* conn, struct gcs_stats* stats)
 
     stats->recv_q_size = conn->recv_q_size;
 
+    double wait_avg[GCS_SM_PRIO_MAX];
+
     gcs_sm_stats_get (conn->sm,
                       &stats->send_q_len,
                       &stats->send_q_len_max,
                       &stats->send_q_len_min,
                       &stats->send_q_len_avg,
                       &stats->fc_paused_ns,
-                      &stats->fc_paused_avg);
+                      &stats->fc_paused_avg,
+                      wait_avg);
+
+    stats->send_wait_avg      = wait_avg[GCS_SM_PRIO_NORMAL];
+    stats->send_wait_prio_avg = wait_avg[GCS_SM_PRIO_HIGH];
 
     stats->fc_ssent    = conn->stats_fc_stop_sent;
     stats->fc_csent    = conn->stats_fc_cont_sent;
@@ -2179,6 +2271,39 @@ _set_fc_limit (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_fc_size_limit (gcs_conn_t* conn, const char* value)
+{
+    long long limit;
+    const char* const endptr = gu_str2ll(value, &limit);
+
+    if (limit >= 0LL && *endptr == '\0') {
+
+        if (limit > SSIZE_MAX) limit = SSIZE_MAX;
+
+        gu_fifo_lock(conn->recv_q);
+        {
+            if (!gu_mutex_lock (&conn->fc_lock)) {
+                conn->params.fc_size_limit = limit;
+                _set_fc_limits (conn);
+                gu_config_set_int64 (conn->config, GCS_PARAMS_FC_SIZE_LIMIT,
+                                     conn->params.fc_size_limit);
+                gu_mutex_unlock (&conn->fc_lock);
+            }
+            else {
+                gu_fatal ("Failed to lock mutex.");
+                abort();
+            }
+        }
+        gu_fifo_release (conn->recv_q);
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
 static long
 _set_fc_factor (gcs_conn_t* conn, const char* value)
 {
@@ -2352,6 +2477,9 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     if (!strcmp (key, GCS_PARAMS_FC_LIMIT)) {
         return _set_fc_limit (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_FC_SIZE_LIMIT)) {
+        return _set_fc_size_limit (conn, value);
+    }
     else if (!strcmp (key, GCS_PARAMS_FC_FACTOR)) {
         return _set_fc_factor (conn, value);
     }
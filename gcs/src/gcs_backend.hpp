@@ -93,6 +93,10 @@ long fn (gcs_backend_t* const backend,    \
  *        OR
  *        the length of the message, so if it is bigger
  *        than len, it has to be reread with a bigger buffer
+ *
+ * Instead of copying GCS_MSG_ACTION payload to msg->buf backend may set
+ * msg->view to point to the payload in its own receive buffer. The view
+ * must stay valid until the next call to recv(). msg->view is NULL on entry.
  */
 #define GCS_BACKEND_RECV_FN(fn)                 \
 long fn (gcs_backend_t*  const backend,         \
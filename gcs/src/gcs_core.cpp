@@ -466,8 +466,13 @@ core_msg_recv (gcs_backend_t* backend, gcs_recv_msg_t* recv_msg,
 {
     long ret;
 
+    recv_msg->view = NULL;
+
     ret = backend->recv (backend, recv_msg, timeout);
 
+    /* message payload left in backend buffer, no need to copy it */
+    if (recv_msg->view != NULL) return ret;
+
     while (gu_unlikely(ret > recv_msg->buf_len)) {
         /* recv_buf too small, reallocate */
         /* sometimes - like in case of component message, we may need to
@@ -515,15 +520,18 @@ core_handle_act_msg (gcs_core_t*          core,
     gcs_act_frag_t frg;
     bool  my_msg = (gcs_group_my_idx(group) == msg->sender_idx);
     bool  commonly_supported_version = true;
+    /* fragments are copied to action buffer straight from backend buffer
+     * if backend provided the view */
+    void* const buf(msg->view ? const_cast<void*>(msg->view) : msg->buf);
 
     assert (GCS_MSG_ACTION == msg->type);
 
     if ((CORE_PRIMARY == core->state) || my_msg){//should always handle own msgs
 
-        if (gu_unlikely(gcs_act_proto_ver(msg->buf) !=
+        if (gu_unlikely(gcs_act_proto_ver(buf) !=
                         gcs_core_group_protocol_version(core))) {
             gu_info ("Message with protocol version %d != highest commonly supported: %d. ",
-                     gcs_act_proto_ver(msg->buf),
+                     gcs_act_proto_ver(buf),
                      gcs_core_group_protocol_version(core));
             commonly_supported_version = false;
             if (!my_msg) {
@@ -536,7 +544,7 @@ core_handle_act_msg (gcs_core_t*          core,
             }
         }
 
-        ret = gcs_act_proto_read (&frg, msg->buf, msg->size);
+        ret = gcs_act_proto_read (&frg, buf, msg->size);
 
         if (gu_unlikely(ret)) {
             gu_fatal ("Error parsing action fragment header: %zd (%s).",
@@ -553,7 +561,7 @@ core_handle_act_msg (gcs_core_t*          core,
 #ifndef GCS_FOR_GARB
             assert (NULL != act->act.buf);
 #else
-            assert (NULL == act->act.buf);
+            assert ((NULL != act->act.buf) == (NULL != core->cache));
 #endif
             act->sender_idx = msg->sender_idx;
 
@@ -610,8 +618,13 @@ core_handle_act_msg (gcs_core_t*          core,
                             // act->id != GCS_SEQNO_ILL (most likely act->id == -EAGAIN)
                             core->state == CORE_PRIMARY)) {
 #ifdef GCS_FOR_GARB
-            /* ignoring state requests from other nodes (not allocated) */
-            if (my_msg) {
+            /* without cache state requests from other nodes are not
+             * allocated, ignore them */
+            if (NULL != core->cache) {
+                ret = gcs_group_handle_state_request (group, act);
+                assert (ret <= 0 || ret == act->act.buf_len);
+            }
+            else if (my_msg) {
                 if (act->act.buf_len != act->local[0].size) {
                     gu_fatal ("Protocol violation: state request is fragmented."
                               " Aborting.");
@@ -69,16 +69,10 @@ gcs_defrag_handle_frag (gcs_defrag_t*         df,
 
                     df->size = frg->act_size;
 
-#ifndef GCS_FOR_GARB
-                    if (df->cache !=NULL) {
-                        gcache_free (df->cache, df->head);
+                    if (gcs_defrag_stores(df)) {
+                        gcs_gcache_free (df->cache, df->head);
+                        DF_ALLOC();
                     }
-                    else {
-                        free ((void*)df->head);
-                    }
-
-                    DF_ALLOC();
-#endif /* GCS_FOR_GARB */
                 }
             }
             else if (frg->act_id == df->sent_id && frg->frag_no < df->frag_no) {
@@ -109,13 +103,14 @@ gcs_defrag_handle_frag (gcs_defrag_t*         df,
             df->sent_id = frg->act_id;
             df->reset   = false;
 
-#ifndef GCS_FOR_GARB
-            DF_ALLOC();
-#else
-            /* we don't store actions locally at all */
-            df->head = NULL;
-            df->tail = df->head;
-#endif
+            if (gcs_defrag_stores(df)) {
+                DF_ALLOC();
+            }
+            else {
+                /* we don't store actions locally at all */
+                df->head = NULL;
+                df->tail = df->head;
+            }
         }
         else {
             /* not a first fragment */
@@ -143,15 +138,16 @@ gcs_defrag_handle_frag (gcs_defrag_t*         df,
     df->received += frg->frag_len;
     assert (df->received <= df->size);
 
-#ifndef GCS_FOR_GARB
-    assert (df->tail);
-    memcpy (df->tail, frg->frag, frg->frag_len);
-    df->tail += frg->frag_len;
-#else
-    /* we skip memcpy since have not allocated any buffer */
-    assert (NULL == df->tail);
-    assert (NULL == df->head);
-#endif
+    if (gcs_defrag_stores(df)) {
+        assert (df->tail);
+        memcpy (df->tail, frg->frag, frg->frag_len);
+        df->tail += frg->frag_len;
+    }
+    else {
+        /* we skip memcpy since have not allocated any buffer */
+        assert (NULL == df->tail);
+        assert (NULL == df->head);
+    }
 
 #if 1
     if (df->received == df->size) {
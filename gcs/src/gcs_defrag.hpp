@@ -40,6 +40,18 @@ gcs_defrag_init (gcs_defrag_t* df, gcache_t* cache)
     df->sent_id = GCS_SEQNO_ILL;
 }
 
+/*! Arbitrator does not store action contents unless it was given a cache
+ *  to serve IST from */
+static inline bool
+gcs_defrag_stores (const gcs_defrag_t* df)
+{
+#ifndef GCS_FOR_GARB
+    return true;
+#else
+    return (df->cache != NULL);
+#endif /* GCS_FOR_GARB */
+}
+
 /*!
  * Handle received action fragment
  *
@@ -64,14 +76,12 @@ gcs_defrag_forget (gcs_defrag_t* df)
 static inline void
 gcs_defrag_free (gcs_defrag_t* df)
 {
-#ifndef GCS_FOR_GARB
+    assert (gcs_defrag_stores(df) || NULL == df->head);
+
     if (df->head) {
         gcs_gcache_free (df->cache, df->head);
         // df->head, df->tail will be zeroed in gcs_defrag_init() below
     }
-#else
-    assert(NULL == df->head);
-#endif
 
     gcs_defrag_init (df, df->cache);
 }
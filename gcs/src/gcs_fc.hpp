@@ -56,4 +56,40 @@ gcs_fc_process (gcs_fc_t* fc, ssize_t act_size);
 extern void
 gcs_fc_debug (gcs_fc_t* fc, long debug_level);
 
+/* Slave queue limits used by gcs.c flow control and admission: length
+ * (gcs.fc_limit) and size in bytes (gcs.fc_size_limit). Size limit is
+ * disabled if upper_size <= 0. */
+
+/*! @return true if slave queue is over the upper limit by length or size */
+static inline bool
+gcs_fc_queue_over (long const len, ssize_t const size,
+                   long const upper_len, ssize_t const upper_size)
+{
+    return (len > upper_len || (upper_size > 0 && size > upper_size));
+}
+
+/*! @return true if slave queue is below the lower limit by length and size */
+static inline bool
+gcs_fc_queue_under (long const len, ssize_t const size,
+                    long const lower_len, ssize_t const lower_size,
+                    ssize_t const upper_size)
+{
+    return (lower_len >= len && (upper_size <= 0 || lower_size >= size));
+}
+
+/*! @return true if an action of act_size can be replicated: the slave
+ *  queue is within length limit and won't exceed size limit with it. An
+ *  action that does not fit, e.g. one that alone exceeds the size limit, is
+ *  admitted once the slave queue drains to the lower size limit, so that it
+ *  is paced by local apply rate but not starved by steady remote traffic. */
+static inline bool
+gcs_fc_admit (long const len, ssize_t const size, ssize_t const act_size,
+              long const upper_len, ssize_t const upper_size,
+              ssize_t const lower_size)
+{
+    return (upper_len >= len &&
+            (upper_size <= 0 || size + act_size <= upper_size ||
+             size <= lower_size));
+}
+
 #endif /* _gcs_fc_h_ */
@@ -110,7 +110,7 @@ public:
         mutex_(),
         cond_(),
 #endif /* HAVE_PSI_INTERFACE */
-        queue_(), waiting_(false) { }
+        queue_(), waiting_(false), release_front_(false) { }
 
     void push_back(const RecvBufData& p)
     {
@@ -125,6 +125,13 @@ public:
     {
         Lock lock(mutex_);
 
+        if (release_front_ == true)
+        {
+            // previous front was left in queue to back msg->view
+            queue_.pop_front();
+            release_front_ = false;
+        }
+
         while (queue_.empty())
         {
             Waiting w(waiting_);
@@ -149,6 +156,17 @@ public:
         queue_.pop_front();
     }
 
+    /*!
+     * Keep front element until the next call to front() so that its
+     * payload can be referenced by the receiver without copying.
+     */
+    void pop_front_deferred()
+    {
+        Lock lock(mutex_);
+        assert(queue_.empty() == false);
+        release_front_ = true;
+    }
+
 private:
 
 #ifdef HAVE_PSI_INTERFACE
@@ -160,6 +178,7 @@ private:
 #endif /* HAVE_PSI_INTERFACE */
     RecvBufQueue queue_;
     bool waiting_;
+    bool release_front_;
 };
 
 
@@ -731,7 +750,15 @@ static GCS_BACKEND_RECV_FN(gcomm_recv)
 
             msg->size = pload_len;
 
-            if (gu_likely(pload_len <= msg->buf_len))
+            if (gu_likely(um.user_type() == GCS_MSG_ACTION))
+            {
+                // action fragments are passed as views to datagram
+                // buffer and copied by defrag directly to gcache
+                msg->view = b;
+                msg->type = GCS_MSG_ACTION;
+                recv_buf.pop_front_deferred();
+            }
+            else if (gu_likely(pload_len <= msg->buf_len))
             {
                 memcpy(msg->buf, b, pload_len);
                 msg->type = static_cast<gcs_msg_type_t>(um.user_type());
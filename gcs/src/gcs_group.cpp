@@ -912,6 +912,25 @@ group_node_is_stateful (const gcs_group_t* group, const gcs_node_t* node)
     }
 }
 
+/* Arbitrator which keeps a writeset cache: can serve IST, but not SST.
+ * Older nodes don't know about such donors, so all members must agree
+ * to use them (state exchange v7) or donor selection would diverge. */
+static inline bool
+group_node_is_ist_only (const gcs_group_t* group, const gcs_node_t* node)
+{
+    return (group->quorum.version >= 7 &&
+            !group_node_is_stateful (group, node) &&
+            gcs_node_cached (node) != GCS_SEQNO_ILL);
+}
+
+static inline bool
+group_node_can_ist (const gcs_group_t* group, const gcs_node_t* node,
+                    bool const ist_only)
+{
+    return (group_node_is_stateful (group, node) ||
+            (ist_only && group_node_is_ist_only (group, node)));
+}
+
 static int
 group_find_node_by_state (const gcs_group_t*     const group,
                           int              const joiner_idx,
@@ -1071,7 +1090,8 @@ group_find_ist_donor_by_name (const gcs_group_t* const group,
                               int joiner_idx,
                               const char* name, int  name_len,
                               gcs_seqno_t ist_seqno,
-                              gcs_node_state_t status)
+                              gcs_node_state_t status,
+                              bool const ist_only)
 {
     int idx = 0;
     for (idx = 0; idx < group->num; idx++)
@@ -1083,7 +1103,11 @@ group_find_ist_donor_by_name (const gcs_group_t* const group,
             node->status >= status &&
             cached != GCS_SEQNO_ILL &&
             // ist potentially possible
-            (ist_seqno + 1) >= cached)
+            (ist_seqno + 1) >= cached &&
+            // IST-only donor can't bypass SST part of the request,
+            // before v7 nodes select by name regardless of node type
+            (group->quorum.version < 7 ||
+             group_node_can_ist(group, node, ist_only)))
         {
             return idx;
         }
@@ -1097,7 +1121,8 @@ group_find_ist_donor_by_name_in_string (
     int joiner_idx,
     const char* str, int str_len,
     gcs_seqno_t ist_seqno,
-    gcs_node_state_t status)
+    gcs_node_state_t status,
+    bool const ist_only)
 {
     assert (str != NULL);
 
@@ -1119,7 +1144,7 @@ group_find_ist_donor_by_name_in_string (
         if (len == 0) break;
         int idx = group_find_ist_donor_by_name(
             group, joiner_idx, begin, len,
-            ist_seqno, status);
+            ist_seqno, status, ist_only);
         if (idx >= 0)
         {
             if (ret == -1 ||
@@ -1146,31 +1171,33 @@ static int
 group_find_ist_donor_by_state (const gcs_group_t* const group,
                                int joiner_idx,
                                gcs_seqno_t ist_seqno,
-                               gcs_node_state_t status)
+                               gcs_node_state_t status,
+                               bool const ist_only)
 {
     gcs_node_t* joiner = &group->nodes[joiner_idx];
     gcs_segment_t joiner_segment = joiner->segment;
 
     // find node who is ist potentially possible.
-    // first highest cached seqno local node.
-    // then highest cached seqno remote node.
+    // first highest cached seqno local node, preferring IST-only donors
+    // (arbitrators with cache) to keep IST load off the data nodes,
+    // then highest cached seqno remote node in the same order.
+    int found[2][2] = { { -1, -1 }, { -1, -1 } }; // [remote][stateful]
     int idx = 0;
-    int local_idx = -1;
-    int remote_idx = -1;
     for (idx = 0; idx < group->num; idx++)
     {
         if (joiner_idx == idx) continue;
 
         gcs_node_t* const node = &group->nodes[idx];
         gcs_seqno_t const node_cached = gcs_node_cached(node);
+        bool const stateful = group_node_is_stateful(group, node);
 
         if (node->status >= status &&
-            group_node_is_stateful(group, node) &&
+            group_node_can_ist(group, node, ist_only) &&
             node_cached != GCS_SEQNO_ILL &&
             node_cached <= (ist_seqno + 1))
         {
             int* const idx_ptr =
-                (joiner_segment == node->segment) ? &local_idx : &remote_idx;
+                &found[joiner_segment != node->segment][stateful];
 
             if (*idx_ptr == -1 ||
                 node_cached >= gcs_node_cached(&group->nodes[*idx_ptr]))
@@ -1179,19 +1206,23 @@ group_find_ist_donor_by_state (const gcs_group_t* const group,
             }
         }
     }
-    if (local_idx >= 0)
-    {
-        gu_debug("local found. name[%s], seqno[%lld]",
-                 group->nodes[local_idx].name,
-                 (long long)gcs_node_cached(&group->nodes[local_idx]));
-        return local_idx;
-    }
-    if (remote_idx >= 0)
+
+    for (int remote = 0; remote < 2; remote++)
     {
-        gu_debug("remote found. name[%s], seqno[%lld]",
-                 group->nodes[remote_idx].name,
-                 (long long)gcs_node_cached(&group->nodes[remote_idx]));
-        return remote_idx;
+        for (int stateful = 0; stateful < 2; stateful++)
+        {
+            idx = found[remote][stateful];
+
+            if (idx >= 0)
+            {
+                gu_debug("%s%s found. name[%s], seqno[%lld]",
+                         remote ? "remote" : "local",
+                         stateful ? "" : " IST-only",
+                         group->nodes[idx].name,
+                         (long long)gcs_node_cached(&group->nodes[idx]));
+                return idx;
+            }
+        }
     }
     gu_debug("not found.");
     return -1;
@@ -1239,12 +1270,12 @@ group_find_ist_donor (const gcs_group_t* const group,
     if (str_len) {
         // find ist donor by name.
         idx = group_find_ist_donor_by_name_in_string(
-            group, joiner_idx, str, str_len, ist_seqno, status);
+            group, joiner_idx, str, str_len, ist_seqno, status, ist_only);
         if (idx >= 0) return idx;
     }
     // find ist donor by status.
     idx = group_find_ist_donor_by_state(
-        group, joiner_idx, ist_seqno, status);
+        group, joiner_idx, ist_seqno, status, ist_only);
     if (idx >= 0) return idx;
     return -1;
 }
@@ -1679,12 +1710,19 @@ group_get_node_state (const gcs_group_t* const group, long const node_idx)
     if (node->bootstrap)          flags |= GCS_STATE_FBOOTSTRAP;
 #ifdef GCS_FOR_GARB
     flags |= GCS_STATE_ARBITRATOR;
+#endif /* GCS_FOR_GARB */
 
-    int64_t const cached = GCS_SEQNO_ILL;
+    /* group->cache check is needed for unit tests and arbitrator, which has
+     * a cache only when it serves IST. Arbitrator advertises it only after
+     * all members of the last primary component knew IST-only donors:
+     * older nodes would otherwise pick it by name for SST. */
+#ifdef GCS_FOR_GARB
+    bool const advertise_cache(group->quorum.version >= 7);
 #else
-    int64_t const cached = /* group->cache check is needed for unit tests */
-        group->cache ? gcache_seqno_min(group->cache) : GCS_SEQNO_ILL;
+    bool const advertise_cache(true);
 #endif /* GCS_FOR_GARB */
+    int64_t const cached = (group->cache && advertise_cache) ?
+        gcache_seqno_min(group->cache) : GCS_SEQNO_ILL;
 
     return gcs_state_msg_create (
         &group->state_uuid,
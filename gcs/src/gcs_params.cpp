@@ -13,6 +13,7 @@
 
 const char* const GCS_PARAMS_FC_FACTOR         = "gcs.fc_factor";
 const char* const GCS_PARAMS_FC_LIMIT          = "gcs.fc_limit";
+const char* const GCS_PARAMS_FC_SIZE_LIMIT     = "gcs.fc_size_limit";
 const char* const GCS_PARAMS_FC_MASTER_SLAVE   = "gcs.fc_master_slave";
 const char* const GCS_PARAMS_FC_DEBUG          = "gcs.fc_debug";
 const char* const GCS_PARAMS_SYNC_DONOR        = "gcs.sync_donor";
@@ -26,6 +27,7 @@ const char* const GCS_PARAMS_SM_DUMP           = "gcs.sm_dump";
 
 static const char* const GCS_PARAMS_FC_FACTOR_DEFAULT         = "1";
 static const char* const GCS_PARAMS_FC_LIMIT_DEFAULT          = "100";
+static const char* const GCS_PARAMS_FC_SIZE_LIMIT_DEFAULT     = "0";
 static const char* const GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT   = "no";
 static const char* const GCS_PARAMS_FC_DEBUG_DEFAULT          = "0";
 static const char* const GCS_PARAMS_SYNC_DONOR_DEFAULT        = "no";
@@ -43,6 +45,8 @@ gcs_params_register(gu_config_t* conf)
                           GCS_PARAMS_FC_FACTOR_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_LIMIT,
                           GCS_PARAMS_FC_LIMIT_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_FC_SIZE_LIMIT,
+                          GCS_PARAMS_FC_SIZE_LIMIT_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_MASTER_SLAVE,
                           GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_DEBUG,
@@ -209,6 +213,10 @@ gcs_params_init (struct gcs_params* params, gu_config_t* config)
     params->recv_q_hard_limit = tmp * gcs_fc_hard_limit_fix;
     // allow for some meta overhead
 
+    if ((ret = params_init_int64 (config, GCS_PARAMS_FC_SIZE_LIMIT, 0,
+                                  SSIZE_MAX, &tmp))) return ret;
+    params->fc_size_limit = tmp;
+
     if ((ret = params_init_bool (config, GCS_PARAMS_FC_MASTER_SLAVE,
                                  &params->fc_master_slave))) return ret;
 
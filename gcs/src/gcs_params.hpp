@@ -14,6 +14,7 @@ struct gcs_params
     double  recv_q_soft_limit;
     double  max_throttle;
     ssize_t recv_q_hard_limit;
+    ssize_t fc_size_limit;
     long    fc_base_limit;
     long    max_packet_size;
     long    fc_debug;
@@ -23,6 +24,7 @@ struct gcs_params
 
 extern const char* const GCS_PARAMS_FC_FACTOR;
 extern const char* const GCS_PARAMS_FC_LIMIT;
+extern const char* const GCS_PARAMS_FC_SIZE_LIMIT;
 extern const char* const GCS_PARAMS_FC_MASTER_SLAVE;
 extern const char* const GCS_PARAMS_FC_DEBUG;
 extern const char* const GCS_PARAMS_SYNC_DONOR;
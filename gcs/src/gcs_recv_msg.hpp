@@ -20,15 +20,18 @@ typedef struct gcs_recv_msg
     int            size;
     int            sender_idx;
     gcs_msg_type_t type;
+    const void*    view; // message payload in backend buffer, see
+                         // GCS_BACKEND_RECV_FN
 
-    gcs_recv_msg() { }
+    gcs_recv_msg() : view(NULL) { }
     gcs_recv_msg(void* b, long bl, long sz, long si, gcs_msg_type_t t)
         :
         buf(b),
         buf_len(bl),
         size(sz),
         sender_idx(si),
-        type(t)
+        type(t),
+        view(NULL)
     { }
 }
 gcs_recv_msg_t;
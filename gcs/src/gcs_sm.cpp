@@ -23,6 +23,12 @@ sm_init_stats (gcs_sm_stats_t* stats)
     stats->send_q_len     = 0;
     stats->send_q_len_max = 0;
     stats->send_q_len_min = 0;
+
+    for (int i = 0; i < GCS_SM_PRIO_MAX; ++i)
+    {
+        stats->wait_ns[i]  = 0;
+        stats->wait_cnt[i] = 0;
+    }
 }
 
 gcs_sm_t*
@@ -48,6 +54,10 @@ gcs_sm_create (long len, long n)
         gu_mutex_init (&sm->lock, NULL);
         gu_cond_init  (&sm->cond, NULL);
         sm->cond_wait   = 0;
+        gu_cond_init  (&sm->prio_cond, NULL);
+        sm->prio_wait   = 0;
+        sm->prio_entered= 0;
+        sm->prio_streak = 0;
         sm->wait_q_len  = len;
         sm->wait_q_mask = sm->wait_q_len - 1;
         sm->wait_q_head = 1;
@@ -85,6 +95,9 @@ gcs_sm_close (gcs_sm_t* sm)
 
     if (sm->pause) _gcs_sm_continue_common (sm);
 
+    /* priority waiters are not in the queue, make them all fail */
+    gu_cond_broadcast (&sm->prio_cond);
+
     gu_cond_t cond;
     gu_cond_init (&cond, NULL);
 
@@ -103,6 +116,10 @@ gcs_sm_close (gcs_sm_t* sm)
         GCS_SM_INCREMENT(sm->wait_q_head);
     }
 
+    while (sm->prio_entered > 0) { // priority users are not in the queue
+        gu_cond_wait (&sm->prio_cond, &sm->lock);
+    }
+
     gu_cond_destroy (&cond);
 
     gu_mutex_unlock (&sm->lock);
@@ -136,6 +153,7 @@ void
 gcs_sm_destroy (gcs_sm_t* sm)
 {
     gu_mutex_destroy(&sm->lock);
+    gu_cond_destroy (&sm->prio_cond);
     gu_free (sm);
 }
 
@@ -146,7 +164,8 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
                   int*       q_len_min,
                   double*    q_len_avg,
                   long long* paused_ns,
-                  double*    paused_avg)
+                  double*    paused_avg,
+                  double*    wait_avg)
 {
     gcs_sm_stats_t tmp;
     long long      now;
@@ -187,6 +206,13 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
     else {
         *q_len_avg = -1.0;
     }
+
+    if (wait_avg) {
+        for (int i = 0; i < GCS_SM_PRIO_MAX; ++i) {
+            wait_avg[i] = tmp.wait_cnt[i] > 0 ?
+                1.0e-9 * tmp.wait_ns[i] / tmp.wait_cnt[i] : 0.0;
+        }
+    }
 }
 
 void
@@ -210,6 +236,12 @@ gcs_sm_stats_flush(gcs_sm_t* sm)
     sm->stats.send_q_len_min = 0;
     sm->stats.send_q_samples = 0;
 
+    for (int i = 0; i < GCS_SM_PRIO_MAX; ++i)
+    {
+        sm->stats.wait_ns[i]  = 0;
+        sm->stats.wait_cnt[i] = 0;
+    }
+
     sm->users_max = sm->users;
     sm->users_min = sm->users;
     gu_mutex_unlock (&sm->lock);
@@ -21,6 +21,20 @@
 #define GCS_SM_CC 1
 #endif /* GCS_SM_CONCURRENCY */
 
+/*! Send priority classes. NORMAL users enter in FIFO order and can be
+ *  scheduled and interrupted. HIGH users go ahead of queued NORMAL users,
+ *  but no more than GCS_SM_PRIO_MAX_STREAK times in a row, and still obey
+ *  flow control pause. */
+typedef enum gcs_sm_prio
+{
+    GCS_SM_PRIO_NORMAL = 0,
+    GCS_SM_PRIO_HIGH,
+    GCS_SM_PRIO_MAX
+}
+gcs_sm_prio_t;
+
+#define GCS_SM_PRIO_MAX_STREAK 8
+
 typedef struct gcs_sm_user
 {
     gu_cond_t* cond;
@@ -38,6 +52,8 @@ typedef struct gcs_sm_stats
     long long send_q_len;
     long long send_q_len_max;
     long long send_q_len_min;
+    long long wait_ns [GCS_SM_PRIO_MAX]; // total time waited to enter
+    long long wait_cnt[GCS_SM_PRIO_MAX]; // number of entries
 }
 gcs_sm_stats_t;
 
@@ -47,6 +63,10 @@ typedef struct gcs_sm
     gu_mutex_t    lock;
     gu_cond_t     cond;
     long          cond_wait;
+    gu_cond_t     prio_cond;   // HIGH priority users wait here
+    long          prio_wait;   // number of HIGH priority waiters
+    long          prio_entered;// HIGH users inside, not counted in users
+    long          prio_streak; // HIGH entries while NORMAL users were queued
     unsigned long wait_q_len;
     unsigned long wait_q_mask;
     unsigned long wait_q_head;
@@ -117,7 +137,8 @@ gcs_sm_create (long len, long n);
 
 /*!
  * Closes monitor for entering and makes all users to exit with error.
- * (entered users are not affected). Blocks until everybody exits
+ * (entered users are not affected). Blocks until everybody exits,
+ * including entered HIGH priority users
  */
 extern long
 gcs_sm_close (gcs_sm_t* sm);
@@ -144,6 +165,13 @@ _gcs_sm_wake_up_next (gcs_sm_t* sm)
     assert (woken >= 0);
     assert (woken <= GCS_SM_CC);
 
+    if (sm->prio_wait > 0 && woken < GCS_SM_CC &&
+        (sm->prio_streak < GCS_SM_PRIO_MAX_STREAK || 0 == sm->users)) {
+        gu_cond_signal (&sm->prio_cond);
+        GCS_SM_HIST_LOG("signaled priority waiter");
+        return;
+    }
+
     while (woken < GCS_SM_CC && sm->users > 0) {
         if (gu_likely(sm->wait_q[sm->wait_q_head].wait)) {
             assert (NULL != sm->wait_q[sm->wait_q_head].cond);
@@ -351,6 +379,7 @@ static inline long
 gcs_sm_enter (gcs_sm_t* sm, gu_cond_t* cond, bool scheduled, bool block)
 {
     long ret = 0; /* if scheduled and no queue */
+    long long const start(gu_time_monotonic());
 
     if (gu_likely (scheduled || (ret = gcs_sm_schedule(sm)) >= 0)) {
         const unsigned long tail(sm->wait_q_tail);
@@ -375,6 +404,10 @@ gcs_sm_enter (gcs_sm_t* sm, gu_cond_t* cond, bool scheduled, bool block)
             assert(sm->users   > 0);
             assert(sm->entered < GCS_SM_CC);
             sm->entered++;
+            sm->prio_streak = 0;
+            sm->stats.wait_ns [GCS_SM_PRIO_NORMAL] +=
+                gu_time_monotonic() - start;
+            sm->stats.wait_cnt[GCS_SM_PRIO_NORMAL]++;
 #ifdef GCS_SM_SIMULATE_TIMEOUTS
             if (tail & 1) usleep(1000);
 #endif
@@ -402,6 +435,88 @@ gcs_sm_enter (gcs_sm_t* sm, gu_cond_t* cond, bool scheduled, bool block)
     return ret;
 }
 
+#define GCS_SM_PRIO_HAS_TO_WAIT                                         \
+    (sm->entered >= GCS_SM_CC || sm->pause ||                           \
+     (sm->users > 0 && sm->prio_streak >= GCS_SM_PRIO_MAX_STREAK))
+
+/*!
+ * Enter send monitor critical section ahead of NORMAL priority users.
+ * Such user does not get a queue handle and can't be interrupted.
+ * Must be followed by gcs_sm_leave_prio().
+ *
+ * @param block if false waiting times out eventually
+ *
+ * @retval -EBADFD - monitor closed
+ * @retval -ETIMEDOUT - timed out waiting for its turn
+ * @retval 0 - successfully entered
+ */
+static inline long
+gcs_sm_enter_prio (gcs_sm_t* sm, bool block)
+{
+    long long const start(gu_time_monotonic());
+    long ret;
+
+    if (gu_unlikely(gu_mutex_lock (&sm->lock))) abort();
+
+    while (0 == (ret = sm->ret) && GCS_SM_PRIO_HAS_TO_WAIT) {
+        sm->prio_wait++;
+        if (block) {
+            gu_cond_wait (&sm->prio_cond, &sm->lock);
+        }
+        else {
+            gu::datetime::Date abstime(gu::datetime::Date::calendar() +
+                                       sm->wait_time);
+            struct timespec ts;
+            abstime._timespec(ts);
+            ret = -gu_cond_timedwait (&sm->prio_cond, &sm->lock, &ts);
+        }
+        sm->prio_wait--;
+
+        if (gu_unlikely(-ETIMEDOUT == ret)) break;
+    }
+
+    if (gu_likely(0 == ret)) {
+        assert (sm->entered < GCS_SM_CC);
+        sm->entered++;
+        sm->prio_entered++;
+        if (sm->users > 0) sm->prio_streak++;
+        sm->stats.wait_ns [GCS_SM_PRIO_HIGH] += gu_time_monotonic() - start;
+        sm->stats.wait_cnt[GCS_SM_PRIO_HIGH]++;
+        GCS_SM_HIST_LOG("priority entered, streak %ld", sm->prio_streak);
+    }
+    else {
+        /* could have been signaled right before timing out or closing */
+        if (!sm->pause) _gcs_sm_wake_up_next (sm);
+        GCS_SM_HIST_LOG("priority enter failed: %ld", ret);
+    }
+
+    gu_mutex_unlock (&sm->lock);
+
+    return ret;
+}
+
+/*! Leaves send monitor after gcs_sm_enter_prio() */
+static inline void
+gcs_sm_leave_prio (gcs_sm_t* sm)
+{
+    if (gu_unlikely(gu_mutex_lock (&sm->lock))) abort();
+
+    GCS_SM_ASSERT(sm->prio_entered > 0);
+    sm->prio_entered--;
+    GCS_SM_ASSERT(sm->entered > 0);
+    sm->entered--;
+
+    if (gu_unlikely(sm->ret) && 0 == sm->prio_entered) {
+        /* gcs_sm_close() may be waiting for us */
+        gu_cond_broadcast (&sm->prio_cond);
+    }
+
+    _gcs_sm_wake_up_waiters (sm);
+    GCS_SM_HIST_LOG("priority left");
+
+    gu_mutex_unlock (&sm->lock);
+}
+
 static inline void
 gcs_sm_leave (gcs_sm_t* sm)
 {
@@ -508,6 +623,9 @@ gcs_sm_interrupt (gcs_sm_t* sm, long handle)
  * @param paused_ns  total time paused (nanoseconds)
  * @param paused_avg set to a fraction of time which monitor spent in a paused
  *                   state (-1 if stats overflown)
+ * @param wait_avg   if not NULL, an array of GCS_SM_PRIO_MAX elements set to
+ *                   average time (seconds) users of each priority class
+ *                   waited to enter the monitor
  */
 extern void
 gcs_sm_stats_get (gcs_sm_t*  sm,
@@ -516,7 +634,8 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
                   int*       q_len_min,
                   double*    q_len_avg,
                   long long* paused_ns,
-                  double*    paused_avg);
+                  double*    paused_avg,
+                  double*    wait_avg = NULL);
 
 /*! resets average/max/min stats calculation */
 extern void
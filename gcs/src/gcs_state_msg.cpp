@@ -14,7 +14,9 @@
 #include <galerautils.h>
 #include <gu_serialize.hpp>
 
-#define GCS_STATE_MSG_VER 6
+/* v7 adds no fields: it tells that the node knows arbitrators which advertise
+ * a cached seqno as IST-only donors (see gcs_group.cpp) */
+#define GCS_STATE_MSG_VER 7
 #define GCS_STATE_MSG_NO_PROTO_DOWNGRADE_VER 6
 
 #define GCS_STATE_MSG_ACCESS
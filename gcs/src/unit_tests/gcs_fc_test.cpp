@@ -120,6 +120,77 @@ START_TEST(gcs_fc_test_precise)
 }
 END_TEST
 
+START_TEST(gcs_fc_test_queue_limits)
+{
+    long    const upper_len (16);
+    long    const lower_len (8);
+    ssize_t const upper_size(1000);
+    ssize_t const lower_size(500);
+
+    /* size limit disabled: only length counts */
+    fail_if (gcs_fc_queue_over  (16, 1 << 30, upper_len, 0));
+    fail_if (!gcs_fc_queue_over (17, 0,       upper_len, 0));
+    fail_if (!gcs_fc_queue_under(8,  1 << 30, lower_len, 0, 0));
+    fail_if (!gcs_fc_admit      (16, 1 << 30, 1 << 30, upper_len, 0, 0));
+    fail_if (gcs_fc_admit       (17, 0,       0,       upper_len, 0, 0));
+
+    /* size limit is crossed with few actions in the queue */
+    long    len (0);
+    ssize_t size(0);
+
+    while (!gcs_fc_queue_over(len, size, upper_len, upper_size))
+    {
+        fail_if (len > upper_len, "size limit was not tripped");
+        len  += 1;
+        size += 300;
+    }
+
+    fail_if (len  != 4,    "len = %ld, expected 4", len);
+    fail_if (size != 1200, "size = %zd, expected 1200", size);
+
+    /* no admission while over the size limit */
+    fail_if (gcs_fc_admit(len, size, 1, upper_len, upper_size, lower_size));
+
+    /* release: must go below the lower size limit, not just the upper one */
+    len -= 1; size -= 300; // 900
+    fail_if (gcs_fc_queue_over (len, size, upper_len, upper_size));
+    fail_if (gcs_fc_queue_under(len, size, lower_len, lower_size, upper_size));
+    fail_if (!gcs_fc_admit(len, size, 100, upper_len, upper_size, lower_size));
+    fail_if (gcs_fc_admit (len, size, 101, upper_len, upper_size, lower_size));
+
+    len -= 1; size -= 300; // 600
+    fail_if (gcs_fc_queue_under(len, size, lower_len, lower_size, upper_size));
+
+    len -= 1; size -= 300; // 300
+    fail_if (!gcs_fc_queue_under(len, size, lower_len, lower_size, upper_size));
+
+    /* and below the lower length limit as well */
+    fail_if (gcs_fc_queue_under(lower_len + 1, 0,
+                                lower_len, lower_size, upper_size));
+
+    /* action bigger than the limit is admitted once the queue drains to
+     * the lower size limit, it does not have to be empty */
+    fail_if (gcs_fc_admit  (1, lower_size + 1, upper_size * 2,
+                            upper_len, upper_size, lower_size));
+    fail_if (!gcs_fc_admit (1, lower_size, upper_size * 2,
+                            upper_len, upper_size, lower_size));
+    fail_if (!gcs_fc_admit (0, 0, upper_size * 2,
+                            upper_len, upper_size, lower_size));
+    fail_if (!gcs_fc_queue_over(1, lower_size + upper_size * 2,
+                                upper_len, upper_size));
+
+    /* so is an action which does not fit in the remaining room */
+    fail_if (gcs_fc_admit  (1, lower_size + 1, upper_size - lower_size,
+                            upper_len, upper_size, lower_size));
+    fail_if (!gcs_fc_admit (1, lower_size, upper_size - lower_size + 1,
+                            upper_len, upper_size, lower_size));
+
+    /* but never over the length limit */
+    fail_if (gcs_fc_admit  (upper_len + 1, 0, upper_size * 2,
+                            upper_len, upper_size, lower_size));
+}
+END_TEST
+
 Suite *gcs_fc_suite(void)
 {
     Suite *s  = suite_create("GCS state transfer FC");
@@ -129,6 +200,7 @@ Suite *gcs_fc_suite(void)
     tcase_add_test  (tc, gcs_fc_test_limits);
     tcase_add_test  (tc, gcs_fc_test_basic);
     tcase_add_test  (tc, gcs_fc_test_precise);
+    tcase_add_test  (tc, gcs_fc_test_queue_limits);
 
     return s;
 }
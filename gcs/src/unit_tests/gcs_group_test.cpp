@@ -595,6 +595,38 @@ START_TEST(test_gcs_group_find_donor)
     nodes[0].status = GCS_NODE_STATE_SYNCED;
     nodes[1].status = GCS_NODE_STATE_SYNCED;
     nodes[2].status = GCS_NODE_STATE_SYNCED;
+
+    // ========== arbitrator with cache ==========
+    group.quorum.version = 6; // arbitrator is recognized by state flag
+    gcs_state_msg_destroy((gcs_state_msg_t*)nodes[0].state_msg);
+    nodes[0].state_msg = gcs_state_msg_create(
+        &empty_uuid, &empty_uuid, &empty_uuid,
+        0, 0, seqnos[0], 0,
+        GCS_NODE_STATE_SYNCED,
+        GCS_NODE_STATE_SYNCED,
+        "", "",
+        0, 0, 0, 0, 0, 0,
+        0, GCS_STATE_ARBITRATOR);
+
+    // not all members know IST-only donors: ignored as before
+    donor = gcs_group_find_donor(&group, sv, joiner, SARGS(""),
+                                 group_uuid, ist_seqno, true);
+    fail_if(donor != 1);
+
+    group.quorum.version = 7;
+
+    // preferred for IST-only request
+    donor = gcs_group_find_donor(&group, sv, joiner, SARGS(""),
+                                 group_uuid, ist_seqno, true);
+    fail_if(donor != 0);
+
+    // but can't bypass SST, even if requested by name
+    donor = gcs_group_find_donor(&group, sv, joiner, SARGS(""),
+                                 group_uuid, ist_seqno, false);
+    fail_if(donor != 1);
+    donor = gcs_group_find_donor(&group, sv, joiner, SARGS("home0"),
+                                 group_uuid, ist_seqno, false);
+    fail_if(donor != 1);
 #undef SARGS
 
     // todo: free
@@ -514,6 +514,139 @@ START_TEST (gcs_sm_test_interrupt)
 }
 END_TEST
 
+static volatile int prio_order = 0;
+
+struct prio_arg
+{
+    gcs_sm_t* sm;
+    bool      prio;
+    int       order; // order in which the thread entered the monitor
+};
+
+static void* prio_thread (void* data)
+{
+    struct prio_arg* const arg = (struct prio_arg*)data;
+
+    gu_cond_t cond;
+    gu_cond_init (&cond, NULL);
+
+    long ret;
+    if (arg->prio) ret = gcs_sm_enter_prio (arg->sm, true);
+    else           ret = gcs_sm_enter (arg->sm, &cond, false, true);
+
+    fail_if (ret != 0, "ret = %ld, expected 0", ret);
+    arg->order = ++prio_order;
+    usleep (TEST_USLEEP);
+
+    if (arg->prio) gcs_sm_leave_prio (arg->sm);
+    else           gcs_sm_leave (arg->sm);
+
+    gu_cond_destroy (&cond);
+    return NULL;
+}
+
+START_TEST (gcs_sm_test_priority)
+{
+    prio_order = 0;
+
+    gcs_sm_t* sm = gcs_sm_create(4, 1);
+    fail_if(!sm);
+
+    gu_cond_t cond;
+    gu_cond_init (&cond, NULL);
+
+    long ret = gcs_sm_enter (sm, &cond, false, true);
+    fail_if (ret != 0);
+
+    struct prio_arg normal = { sm, false, 0 };
+    struct prio_arg prio   = { sm, true,  0 };
+    gu_thread_t thr1, thr2;
+
+    gu_thread_create (&thr1, NULL, prio_thread, &normal);
+    WAIT_FOR(2 == sm->users);
+    fail_if (sm->users != 2, "users = %ld, expected 2", sm->users);
+
+    gu_thread_create (&thr2, NULL, prio_thread, &prio);
+    WAIT_FOR(1 == sm->prio_wait);
+    fail_if (sm->prio_wait != 1, "prio_wait = %ld, expected 1",
+             sm->prio_wait);
+
+    gcs_sm_leave (sm);
+
+    gu_thread_join (thr1, NULL);
+    gu_thread_join (thr2, NULL);
+
+    /* priority user came later, but must have entered first */
+    fail_if (prio.order != 1, "priority order = %d, expected 1", prio.order);
+    fail_if (normal.order != 2, "normal order = %d, expected 2",
+             normal.order);
+    fail_if (sm->prio_streak != 0, "prio_streak = %ld, expected 0",
+             sm->prio_streak);
+
+    /* priority users still obey flow control */
+    gcs_sm_pause (sm);
+    ret = gcs_sm_enter_prio (sm, false);
+    fail_if (ret != -ETIMEDOUT, "ret = %ld, expected -ETIMEDOUT", ret);
+    gcs_sm_continue (sm);
+
+    ret = gcs_sm_enter_prio (sm, false);
+    fail_if (ret != 0, "ret = %ld, expected 0", ret);
+    gcs_sm_leave_prio (sm);
+
+    int       q_len, q_len_max, q_len_min;
+    double    q_len_avg, paused_avg;
+    long long paused_ns;
+    double    wait_avg[GCS_SM_PRIO_MAX];
+
+    gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
+                      &paused_ns, &paused_avg, wait_avg);
+    fail_if (wait_avg[GCS_SM_PRIO_NORMAL] <= 0.0, "normal wait = %f",
+             wait_avg[GCS_SM_PRIO_NORMAL]);
+    fail_if (wait_avg[GCS_SM_PRIO_HIGH] <= 0.0, "priority wait = %f",
+             wait_avg[GCS_SM_PRIO_HIGH]);
+
+    gu_cond_destroy (&cond);
+    gcs_sm_close (sm);
+    gcs_sm_destroy (sm);
+}
+END_TEST
+static volatile bool close_done = false;
+
+static void* close_thread (void* data)
+{
+    gcs_sm_close ((gcs_sm_t*)data);
+    close_done = true;
+    return NULL;
+}
+
+/* close must wait for entered priority users, they are not in the queue */
+START_TEST (gcs_sm_test_close_prio)
+{
+    close_done = false;
+
+    gcs_sm_t* sm = gcs_sm_create(4, 1);
+    fail_if(!sm);
+
+    long ret = gcs_sm_enter_prio (sm, true);
+    fail_if (ret != 0, "ret = %ld, expected 0", ret);
+
+    gu_thread_t thr;
+    gu_thread_create (&thr, NULL, close_thread, sm);
+
+    WAIT_FOR(-EBADFD == sm->ret);
+    usleep (TEST_USLEEP);
+    fail_if (close_done, "close returned while priority user is inside");
+
+    gcs_sm_leave_prio (sm);
+    gu_thread_join (thr, NULL);
+    fail_if (!close_done);
+
+    ret = gcs_sm_enter_prio (sm, true);
+    fail_if (ret != -EBADFD, "ret = %ld, expected -EBADFD", ret);
+
+    gcs_sm_destroy (sm);
+}
+END_TEST
 
 Suite *gcs_send_monitor_suite(void)
 {
@@ -526,6 +659,8 @@ Suite *gcs_send_monitor_suite(void)
   tcase_add_test  (tc, gcs_sm_test_close);
   tcase_add_test  (tc, gcs_sm_test_pause);
   tcase_add_test  (tc, gcs_sm_test_interrupt);
+  tcase_add_test  (tc, gcs_sm_test_priority);
+  tcase_add_test  (tc, gcs_sm_test_close_prio);
   return s;
 }
 
@@ -8,7 +8,7 @@
 #define GCS_STATE_MSG_ACCESS
 #include "../gcs_state_msg.hpp"
 
-static int const QUORUM_VERSION = 6;
+static int const QUORUM_VERSION = 7;
 
 START_TEST (gcs_state_msg_test_basic)
 {